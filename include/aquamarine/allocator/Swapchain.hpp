@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Allocator.hpp"
+#include "../backend/Misc.hpp"
 
 namespace Aquamarine {
 
@@ -9,8 +10,9 @@ namespace Aquamarine {
     struct SSwapchainOptions {
         size_t                    length = 0;
         Hyprutils::Math::Vector2D size;
-        uint32_t                  format  = DRM_FORMAT_INVALID; // if you leave this on invalid, the swapchain will choose an appropriate format (and modifier) for you.
-        bool                      scanout = false, cursor = false /* requires scanout = true */, multigpu = false /* if true, will force linear */;
+        uint32_t                  format     = DRM_FORMAT_INVALID; // if you leave this on invalid, the swapchain will choose an appropriate format (and modifier) for you.
+        bool                      scanout    = false, cursor = false /* requires scanout = true */, multigpu = false /* if true, will force linear */;
+        bool                      skipLocked = false; // next() passes over buffers still lockedByBackend, and returns nullptr if all of them are
     };
 
     class CSwapchain {
@@ -25,6 +27,12 @@ namespace Aquamarine {
         const SSwapchainOptions&                             currentOptions();
         Hyprutils::Memory::CSharedPointer<IAllocator>        getAllocator();
 
+        /*
+            formats and modifiers to allocate from instead of the backend's render formats, e.g. from a host's
+            feedback. Empty goes back to the backend's. The buffers get reallocated on the next reconfigure.
+        */
+        void setFormats(const std::vector<SDRMFormat>& formats_);
+
         // rolls the buffers back, marking the last consumed as the next valid.
         // useful if e.g. a commit fails and we don't wanna write to the previous buffer that is
         // in use.
@@ -42,7 +50,9 @@ namespace Aquamarine {
         Hyprutils::Memory::CSharedPointer<IAllocator>           allocator;
         Hyprutils::Memory::CWeakPointer<IBackendImplementation> backendImpl;
         std::vector<Hyprutils::Memory::CSharedPointer<IBuffer>> buffers;
-        int                                                     lastAcquired = 0;
+        int                                                     lastAcquired = 0, previousAcquired = 0;
+        std::vector<SDRMFormat>                                 formats;
+        bool                                                    reallocate = false;
 
         friend class CGBMBuffer;
     };
@@ -6,6 +6,11 @@
 #include <functional>
 #include <mutex>
 #include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <chrono>
+#include <array>
 #include "../allocator/Allocator.hpp"
 #include "Misc.hpp"
 #include "Session.hpp"
@@ -40,6 +45,17 @@ namespace Aquamarine {
         AQ_LOG_CRITICAL,
     };
 
+    enum eBackendLogSubsystem : uint32_t {
+        AQ_SUBSYSTEM_CORE = 0,
+        AQ_SUBSYSTEM_DRM,
+        AQ_SUBSYSTEM_SESSION,
+        AQ_SUBSYSTEM_RENDERER,
+        AQ_SUBSYSTEM_ALLOCATOR,
+        AQ_SUBSYSTEM_WAYLAND,
+
+        AQ_SUBSYSTEM_COUNT,
+    };
+
     struct SBackendImplementationOptions {
         explicit SBackendImplementationOptions();
         eBackendType        backendType;
@@ -49,6 +65,25 @@ namespace Aquamarine {
     struct SBackendOptions {
         explicit SBackendOptions();
         std::function<void(eBackendLogLevel, std::string)> logFunction;
+
+        /* messages below this level are dropped before they're formatted. Defaults to debug, or trace with AQ_TRACE=1 */
+        eBackendLogLevel                                   logLevel;
+
+        /* per-subsystem minimum levels, applied on top of logLevel. Default to trace, i.e. only logLevel applies */
+        std::array<eBackendLogLevel, AQ_SUBSYSTEM_COUNT>   subsystemLogLevels;
+
+        /*
+            Coalesce libinput pointer motion: within one dispatch, consecutive motions of a device are summed into one
+            move (or the last warp is kept) followed by one frame. The raw motions are in SMoveEvent::samples. Off by default.
+        */
+        bool                                               coalesceInput;
+
+        /*
+            Deliver libinput touch motion once per touch frame as ITouch::events.moveBatch, and tablet tool axes once per dispatch
+            (or until another event of the tablet) as ITablet::events.axisBatch. The per-event move / axis signals don't fire for
+            batched events. Off by default.
+        */
+        bool                                               batchInput;
     };
 
     struct SPollFD {
@@ -56,6 +91,25 @@ namespace Aquamarine {
         std::function<void(void)> onSignal; /* call this when signaled */
     };
 
+    class CBackend;
+
+    /* A one-shot timer on the backend's timerfd. Either get an armed one from CBackend::addTimer, or create one and arm it with CBackend::rescheduleTimer */
+    class CBackendTimer {
+      public:
+        CBackendTimer(std::function<void(void)> what_);
+
+        /* whether the timer is waiting to fire */
+        bool armed();
+
+      private:
+        std::chrono::steady_clock::time_point when;
+        std::function<void(void)>             what;
+        uint64_t                              generation = 0;
+        bool                                  isArmed    = false;
+
+        friend class CBackend;
+    };
+
     class IBackendImplementation {
       public:
         virtual ~IBackendImplementation() {
@@ -91,10 +145,43 @@ namespace Aquamarine {
         bool start();
 
         void log(eBackendLogLevel level, const std::string& msg);
+        void log(eBackendLogLevel level, eBackendLogSubsystem subsystem, const std::string& msg);
+
+        /* whether a message would reach the log function. Check this before formatting anything on a hot path. */
+        bool shouldLog(eBackendLogLevel level, eBackendLogSubsystem subsystem = AQ_SUBSYSTEM_CORE) const {
+            return level >= logThresholds[subsystem];
+        }
 
         /* Gets all the FDs you have to poll. When any single one fires, call its onPoll */
         std::vector<Hyprutils::Memory::CSharedPointer<SPollFD>> getPollFDs();
 
+        /*
+            Enters the built-in epoll event loop. Dispatches the backend's fds and any fds added with addPollFD
+            until exitLoop() is called. Optional, you can still poll getPollFDs() in your own loop instead.
+            Returns false if the loop couldn't be set up or epoll failed.
+        */
+        bool enterLoop();
+
+        /* Makes enterLoop() return once the current batch of events has been dispatched. Thread-safe. Called before enterLoop(), it returns right after the first batch. */
+        void exitLoop();
+
+        /*
+            Run task on the loop thread at the next dispatch. Thread-safe and lock-free, this is the only thread-safe entry point
+            besides exitLoop() and updatePollFDs(). Tasks run in the order they were posted.
+
+            Ownership: nothing else in aquamarine is thread-safe. Outputs, their COutputState and IBuffers are owned by the loop thread.
+            Capture what the task needs by SP, and don't touch an object handed to a task from your thread until the task ran.
+            E.g. a render thread finishes a buffer, then posts a task that does output->state->setBuffer(buf) and output->commit().
+        */
+        void postToLoop(std::function<void(void)> task);
+
+        /* Adds / removes a consumer fd to / from the built-in event loop */
+        void addPollFD(Hyprutils::Memory::CSharedPointer<SPollFD> pfd);
+        void removePollFD(Hyprutils::Memory::CSharedPointer<SPollFD> pfd);
+
+        /* Marks the built-in loop's registrations as stale. Before waiting again, the loop re-reads the poll fds and (un)registers only the ones that changed. */
+        void updatePollFDs();
+
         /* Checks if the backend has a session - iow if it's a DRM backend */
         bool hasSession();
 
@@ -107,12 +194,25 @@ namespace Aquamarine {
         /* get a vector of the backend implementations available */
         const std::vector<Hyprutils::Memory::CSharedPointer<IBackendImplementation>>& getImplementations();
 
-        /* push an idle event to the queue */
+        /* push an idle event to the queue. Pushing one that's already queued is a no-op. */
         void addIdleEvent(Hyprutils::Memory::CSharedPointer<std::function<void(void)>> fn);
 
         /* remove an idle event from the queue */
         void removeIdleEvent(Hyprutils::Memory::CSharedPointer<std::function<void(void)>> pfn);
 
+        /*
+            Arm a one-shot timer firing after timeout. The returned handle can be cancelled, or rescheduled also after it fired.
+            Timers are owned by the backend until they fire, so dropping the handle doesn't cancel it.
+            All timers share one timerfd. Not thread-safe, use from the thread dispatching the backend.
+        */
+        Hyprutils::Memory::CSharedPointer<CBackendTimer> addTimer(std::chrono::steady_clock::duration timeout, std::function<void(void)> cb);
+
+        /* disarm a timer. No-op if it's not armed */
+        void cancelTimer(Hyprutils::Memory::CSharedPointer<CBackendTimer> timer);
+
+        /* (re)arm a timer to fire after timeout, replacing its previous deadline */
+        void rescheduleTimer(Hyprutils::Memory::CSharedPointer<CBackendTimer> timer, std::chrono::steady_clock::duration timeout);
+
         // utils
         int reopenDRMNode(int drmFD, bool allowRenderNode = true);
 
@@ -134,29 +234,65 @@ namespace Aquamarine {
       private:
         CBackend();
 
-        bool                                                                   terminate = false;
+        std::atomic<bool>                                                      terminate = false;
 
         std::vector<SBackendImplementationOptions>                             implementationOptions;
         std::vector<Hyprutils::Memory::CSharedPointer<IBackendImplementation>> implementations;
         SBackendOptions                                                        options;
+        std::array<uint32_t, AQ_SUBSYSTEM_COUNT>                               logThresholds; // effective minimum level per subsystem, past CRITICAL without a log function
         Hyprutils::Memory::CWeakPointer<CBackend>                              self;
         std::vector<Hyprutils::Memory::CSharedPointer<SPollFD>>                sessionFDs;
 
         struct {
-            int                                                                       fd = -1;
-            std::vector<Hyprutils::Memory::CSharedPointer<std::function<void(void)>>> pending;
+            int                                                                       fd = -1; // eventfd, signaled when pending goes non-empty
+            std::vector<Hyprutils::Memory::CSharedPointer<std::function<void(void)>>> pending, dispatching;
+            std::unordered_set<std::function<void(void)>*>                           queued; // what in pending is live, for O(1) dedup and removal
+            Hyprutils::Memory::CSharedPointer<SPollFD>                                pollFD;
         } idle;
 
+        struct STimerEntry {
+            std::chrono::steady_clock::time_point            when;
+            uint64_t                                         generation = 0;
+            Hyprutils::Memory::CSharedPointer<CBackendTimer> timer;
+        };
+
+        // min-heap on when. Cancelled / rescheduled timers leave stale entries behind, which are skipped by generation.
+        struct {
+            int                                        fd = -1;
+            std::vector<STimerEntry>                   heap, expired;
+            std::chrono::steady_clock::time_point      armedFor = std::chrono::steady_clock::time_point::max();
+            Hyprutils::Memory::CSharedPointer<SPollFD> pollFD;
+        } timers;
+
         void dispatchIdle();
-        void updateIdleTimer();
+        void dispatchTasks();
+        void wakeLoop();
+        void dispatchTimers();
+        void updateTimerFD();
+        void registerPollFDs();
+
+        struct STaskNode {
+            std::function<void(void)> task;
+            STaskNode*                next = nullptr;
+        };
 
         //
         struct {
             std::condition_variable loopSignal;
             std::mutex              loopMutex;
-            std::atomic<bool>       shouldProcess = false;
+            std::atomic<bool>       shouldProcess = false; // a wakeup is pending on taskFD
             std::mutex              loopRequestMutex;
-            std::mutex              eventLock;
+            std::atomic<bool>       pollFDsDirty = false;
+            std::atomic<int>        wakeErrno    = 0; // a failed wakeLoop() from any thread, logged on the loop thread
+
+            int                                                                 epollFD = -1;
+            int                                                                 taskFD  = -1; // eventfd, wakes the loop from other threads
+            std::atomic<STaskNode*>                                             tasks   = nullptr; // lock-free LIFO stack, reversed on dispatch
+            Hyprutils::Memory::CSharedPointer<SPollFD>                          taskPollFD;
+            std::unordered_map<int, Hyprutils::Memory::CSharedPointer<SPollFD>> registered; // fd -> what's in epoll
+            std::vector<Hyprutils::Memory::CSharedPointer<SPollFD>>             userFDs;
         } m_sEventLoopInternals;
+
+        friend class CSession;
     };
 };
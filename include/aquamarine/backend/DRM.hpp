@@ -7,6 +7,9 @@
 #include <hyprutils/memory/WeakPtr.hpp>
 #include <wayland-client.h>
 #include <xf86drmMode.h>
+#include <thread>
+#include <deque>
+#include <memory>
 
 namespace Aquamarine {
     class CDRMBackend;
@@ -214,6 +217,10 @@ namespace Aquamarine {
 
         bool                                                         commitState(bool onlyTest = false);
 
+        /* a threaded commit was rejected: put back the previous current(), make its enable / mode / format pending again */
+        void                                                         restoreState(const COutputState::SInternalState& previous, bool previousNoBuffer,
+                                                                                  const COutputState::SInternalState& failed);
+
         Hyprutils::Memory::CWeakPointer<CDRMBackend>                 backend;
         Hyprutils::Memory::CSharedPointer<SDRMConnector>             connector;
         Hyprutils::Memory::CSharedPointer<std::function<void(void)>> frameIdle;
@@ -227,6 +234,7 @@ namespace Aquamarine {
 
         friend struct SDRMConnector;
         friend class CDRMLease;
+        friend class CDRMAtomicImpl;
     };
 
     struct SDRMPageFlip {
@@ -284,6 +292,8 @@ namespace Aquamarine {
         Hyprutils::Memory::CSharedPointer<CDRMFB>      pendingCursorFB;
 
         bool                                           isPageFlipPending = false;
+        bool                                           isCommitInFlight  = false; // on the commit thread
+        bool                                           isModesetPending  = false; // nonblocking modeset awaiting its pf event
         SDRMPageFlip                                   pendingPageFlip;
         bool                                           frameEventScheduled = false;
 
@@ -318,6 +328,36 @@ namespace Aquamarine {
         UDRMConnectorProps props;
     };
 
+    /*
+        Runs blocking KMS commits off the loop thread, one per gpu, in submission order.
+        Jobs run on the worker and must only touch plain data, hyprutils pointers aren't thread-safe.
+        onDone is called with the job's result on the loop thread, via CBackend::postToLoop.
+    */
+    class CDRMCommitThread {
+      public:
+        CDRMCommitThread(CBackend* backend_);
+        ~CDRMCommitThread();
+
+        void submit(std::function<int(void)> job, std::function<void(int)> onDone);
+
+      private:
+        void dispatchCompletions();
+
+        // shared with the worker, hence std::shared_ptr
+        struct SQueue {
+            std::mutex                           lock;
+            std::condition_variable              signal;
+            std::deque<std::function<int(void)>> jobs;
+            std::vector<int>                     results;
+            bool                                 exit = false;
+        };
+
+        CBackend*                            backend = nullptr;
+        std::shared_ptr<SQueue>              queue;
+        std::deque<std::function<void(int)>> pending; // loop thread only
+        std::thread                          thread;
+    };
+
     class IDRMImplementation {
       public:
         virtual bool commit(Hyprutils::Memory::CSharedPointer<SDRMConnector> connector, SDRMConnectorCommitData& data) = 0;
@@ -347,6 +387,8 @@ namespace Aquamarine {
         Hyprutils::Memory::CWeakPointer<CDRMBackend>                    self;
 
         void                                                            log(eBackendLogLevel, const std::string&);
+        void                                                            log(eBackendLogLevel, eBackendLogSubsystem, const std::string&);
+        bool                                                            shouldLog(eBackendLogLevel, eBackendLogSubsystem);
         bool                                                            sessionActive();
         int                                                             getNonMasterFD();
 
@@ -389,6 +431,9 @@ namespace Aquamarine {
 
         bool                                                          atomic = false;
 
+        Hyprutils::Memory::CSharedPointer<CBackendTimer>              hotplugTimer;
+        Hyprutils::Memory::CSharedPointer<CDRMCommitThread>           commitThread;
+
         struct {
             Hyprutils::Math::Vector2D cursorSize;
             bool                      supportsAsyncCommit     = false;
@@ -26,8 +26,9 @@ namespace Aquamarine {
 
         Hyprutils::Memory::CWeakPointer<CHeadlessBackend>        backend;
 
-        Hyprutils::Memory::CSharedPointer<std::function<void()>> framecb;
-        bool                                                     frameScheduled = false;
+        Hyprutils::Memory::CSharedPointer<CBackendTimer> frameTimer;
+        bool                                             frameScheduled = false;
+        std::chrono::steady_clock::time_point            lastFrame;
 
         friend class CHeadlessBackend;
     };
@@ -58,21 +59,6 @@ namespace Aquamarine {
 
         size_t                                                          outputIDCounter = 0;
 
-        class CTimer {
-          public:
-            std::chrono::steady_clock::time_point when;
-            std::function<void(void)>             what;
-            bool                                  expired();
-        };
-
-        struct {
-            int                 timerfd = -1;
-            std::vector<CTimer> timers;
-        } timers;
-
-        void dispatchTimers();
-        void updateTimerFD();
-
         friend class CBackend;
         friend class CHeadlessOutput;
     };
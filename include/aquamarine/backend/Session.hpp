@@ -5,6 +5,10 @@
 #include <hyprutils/memory/SharedPtr.hpp>
 #include "../input/Input.hpp"
 #include <vector>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 struct udev;
 struct udev_monitor;
@@ -20,6 +24,7 @@ namespace Aquamarine {
     class CSession;
     class CLibinputDevice;
     struct SPollFD;
+    enum eBackendLogLevel : uint32_t;
 
     class CSessionDevice {
       public:
@@ -192,7 +197,165 @@ namespace Aquamarine {
         Hyprutils::Memory::CSharedPointer<CLibinputTabletPad>               tabletPad;
         std::vector<Hyprutils::Memory::CSharedPointer<CLibinputTabletTool>> tabletTools;
 
-        Hyprutils::Memory::CSharedPointer<CLibinputTabletTool>              toolFrom(libinput_tablet_tool* tool);
+        Hyprutils::Memory::CSharedPointer<CLibinputTabletTool>              toolFrom(libinput_tablet_tool* tool, bool create = true); // create calls into libinput
+
+        // pointer motion held back for coalescing, see SBackendOptions::coalesceInput
+        struct {
+            bool                                 hasMove = false, hasWarp = false;
+            IPointer::SMoveEvent                 move;
+            IPointer::SWarpEvent                 warp;
+            std::vector<IPointer::SMotionSample> samples;
+        } pendingMotion;
+
+        void                                                                flushMotion();
+
+        // touch motion / tablet axes held back for batching, see SBackendOptions::batchInput
+        struct {
+            std::vector<uint64_t> timeUs;
+            std::vector<int32_t>  touchID;
+            std::vector<double>   x, y;
+        } pendingTouch;
+
+        struct {
+            Hyprutils::Memory::CSharedPointer<CLibinputTabletTool> tool;
+            std::vector<uint64_t>                                  timeUs;
+            std::vector<uint32_t>                                  updatedAxes;
+            std::vector<double>                                    x, y, dx, dy, tiltX, tiltY;
+            std::vector<double>                                    pressure, distance, rotation, slider, wheelDelta;
+        } pendingTablet;
+
+        void                                                                flushTouchBatch();
+        void                                                                flushTabletBatch();
+
+        SInputLatencyHistogram                                              latency; // kernel timestamp -> dispatch, loop thread only
+
+        // what this device costs the loop. A dispatch is one wakeup of the session's libinput fd. Loop thread only.
+        struct SStats {
+            // libinput_event_type is sparse (group * 100 + n), eventsByType is indexed by slotFor() instead
+            static constexpr size_t                             TYPE_GROUPS = 10, TYPES_PER_GROUP = 16;
+
+            std::array<uint64_t, TYPE_GROUPS * TYPES_PER_GROUP> eventsByType = {};
+            uint64_t                                            events = 0, dispatches = 0; // dispatches counts only those with events of this device
+            uint64_t                                            lastDispatchEvents = 0, maxDispatchEvents = 0;
+            uint64_t                                            handleNs = 0, lastDispatchHandleNs = 0, maxDispatchHandleNs = 0; // time spent handling its events
+
+            void                                                reset();
+            uint64_t                                            eventsOfType(uint32_t type) const;
+            static size_t                                       slotFor(uint32_t type); // anything out of range shares the slot of LIBINPUT_EVENT_NONE
+        } stats;
+
+        // stats and latency as text, one line per device and one per event type it had. Loop thread only.
+        std::string                                                         dumpStats() const;
+
+      private:
+        uint64_t dispatchEvents = 0, dispatchHandleNs = 0; // of the dispatch in progress
+
+        friend class CSession;
+    };
+
+    /*
+        A libinput event read out by whoever dispatched it, so that handling it doesn't call back into libinput.
+        device and tablet.tool only identify what the event belongs to, they're referenced (and have to be released)
+        for device added / removed and tool proximity, where the loop sets them up or tears them down.
+    */
+    struct SLibinputRecord {
+        uint32_t         type   = 0; // libinput_event_type
+        libinput_device* device = nullptr;
+        uint64_t         timeUs = 0;
+
+        struct SKey {
+            uint32_t key;
+            bool     pressed;
+        };
+
+        struct SPointer {
+            double   x, y, dx, dy, dxUnaccel, dyUnaccel;
+            uint32_t button, seatButtonCount;
+            bool     pressed;
+        };
+
+        struct SScroll {
+            bool   has[2]; // vertical, horizontal
+            double value[2], v120[2];
+            bool   natural;
+        };
+
+        struct SGesture {
+            uint32_t fingers;
+            double   dx, dy, scale, angle;
+            bool     cancelled;
+        };
+
+        struct STouch {
+            int32_t slot;
+            double  x, y;
+        };
+
+        struct SSwitch {
+            uint32_t which; // libinput_switch
+            bool     on;
+        };
+
+        struct SPad {
+            uint32_t button, number;
+            bool     pressed, unknownSource;
+            double   pos;
+            uint16_t mode, group;
+        };
+
+        struct STool {
+            libinput_tablet_tool* tool;
+            bool                  in, down, pressed;
+            uint32_t              updatedAxes, button;
+            double                x, y, dx, dy, pressure, distance, tiltX, tiltY, rotation, slider, wheelDelta;
+        };
+
+        union {
+            SKey     key;
+            SPointer pointer;
+            SScroll  scroll;
+            SGesture gesture;
+            STouch   touch;
+            SSwitch  toggle;
+            SPad     pad;
+            STool    tablet;
+        };
+    };
+
+    /*
+        Runs libinput_dispatch off the loop (AQ_INPUT_THREAD). Events reach the loop in libinput's order,
+        device added / removed included, as records through a single-producer single-consumer ring and an eventfd.
+        libinput and libseat log lines from the thread are queued the same way, the consumer's logger only runs on the loop.
+    */
+    class CInputThread {
+      public:
+        CInputThread(CSession* session_);
+        ~CInputThread();
+
+        void start();
+        bool pop(SLibinputRecord& record);                        // loop thread only, false when empty
+        void popped();                                            // loop thread only, after a drain: lets a stalled thread continue
+        void queueLog(eBackendLogLevel level, std::string&& line); // any thread
+        void flushLogs();                                         // loop thread only
+
+        int  readyFD = -1; // readable when there are records to pop or lines to log
+
+      private:
+        void                                                  run();
+        bool                                                  drain(); // with libinputLock held
+
+        static constexpr size_t                               RING_SIZE = 1024;
+        std::array<SLibinputRecord, RING_SIZE>                ring      = {};
+        std::atomic<size_t>                                   head      = 0; // written by the thread
+        std::atomic<size_t>                                   tail      = 0; // written by the loop
+        std::atomic<bool>                                     stalled   = false;
+        std::atomic<bool>                                     exit      = false;
+        int                                                   wakeFD    = -1;
+        CSession*                                             session   = nullptr;
+        std::thread                                           thread;
+
+        std::mutex                                            logLock;
+        std::vector<std::pair<eBackendLogLevel, std::string>> logLines;
     };
 
     class CSession {
@@ -209,16 +372,30 @@ namespace Aquamarine {
         std::vector<Hyprutils::Memory::CSharedPointer<CSessionDevice>>  sessionDevices;
         std::vector<Hyprutils::Memory::CSharedPointer<CLibinputDevice>> libinputDevices;
 
+        // libinput's devices when they're opened by the input thread, which keeps away from shared pointers
+        struct SInputFD {
+            int fd = -1, deviceID = -1;
+        };
+        std::vector<SInputFD>                                           inputFDs;
+
         udev*                                                           udevHandle     = nullptr;
         udev_monitor*                                                   udevMonitor    = nullptr;
         libseat*                                                        libseatHandle  = nullptr;
         libinput*                                                       libinputHandle = nullptr;
+        Hyprutils::Memory::CSharedPointer<CInputThread>                 inputThread; // AQ_INPUT_THREAD, may be null
 
         std::vector<Hyprutils::Memory::CSharedPointer<SPollFD>>         pollFDs();
         void                                                            dispatchPendingEventsAsync();
         bool                                                            switchVT(uint32_t vt);
         void                                                            onReady();
 
+        // dumpStats() of every libinput device, e.g. for a debug command. Loop thread only.
+        std::string                                                     dumpInputStats();
+
+        // libinput and libseat aren't thread-safe: with the input thread running, hold this while calling into them.
+        // Consumers included, e.g. for libinput_device_config_* on a device's getLibinputHandle(). Events never need it.
+        std::unique_lock<std::recursive_mutex> lockLibinput();
+
         struct SAddDrmCardEvent {
             std::string path;
         };
@@ -232,13 +409,21 @@ namespace Aquamarine {
       private:
         Hyprutils::Memory::CWeakPointer<CBackend>               backend;
         std::vector<Hyprutils::Memory::CSharedPointer<SPollFD>> polls;
+        std::recursive_mutex                                    libinputLock;
 
         void                                                    dispatchUdevEvents();
         void                                                    dispatchLibinputEvents();
         void                                                    dispatchLibseatEvents();
-        void                                                    handleLibinputEvent(libinput_event* e);
+        void                                                    processLibinputEvent(const SLibinputRecord& record, bool coalesce);
+        void                                                    handleLibinputEvent(const SLibinputRecord& record);
+        bool                                                    coalesceLibinputEvent(const SLibinputRecord& record);
+        Hyprutils::Memory::CSharedPointer<CLibinputDevice>      libinputDeviceFrom(libinput_device* device);
+        void                                                    flushCoalescedMotion();
+        void                                                    flushTabletBatches();
+        void                                                    finishInputDispatch(); // folds the dispatch into the devices' stats
 
         friend class CSessionDevice;
         friend class CLibinputDevice;
+        friend class CInputThread;
     };
 };
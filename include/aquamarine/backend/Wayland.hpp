@@ -9,7 +9,14 @@
 #include <wayland.hpp>
 #include <xdg-shell.hpp>
 #include <linux-dmabuf-v1.hpp>
+#include <relative-pointer-unstable-v1.hpp>
+#include <presentation-time.hpp>
+#include <viewporter.hpp>
+#include <fractional-scale-v1.hpp>
+#include <linux-drm-syncobj-v1.hpp>
 #include <tuple>
+#include <ctime>
+#include <sys/types.h>
 
 namespace Aquamarine {
     class CBackend;
@@ -23,9 +30,9 @@ namespace Aquamarine {
       public:
         CWaylandBuffer(Hyprutils::Memory::CSharedPointer<IBuffer> buffer_, Hyprutils::Memory::CWeakPointer<CWaylandBackend> backend_);
         ~CWaylandBuffer();
-        bool good();
+        bool     good();
 
-        bool pendingRelease = false;
+        uint64_t releasePoint = 0; // on the output's release timeline with explicit sync, 0 when wl_buffer.release frees the buffer
 
       private:
         struct {
@@ -38,6 +45,35 @@ namespace Aquamarine {
         friend class CWaylandOutput;
     };
 
+    struct SWaylandDmabufTranche {
+        dev_t                   device  = 0;     // the device the buffers are used on
+        bool                    scanout = false; // buffers in these formats may get scanned out directly
+        std::vector<SDRMFormat> formats;
+    };
+
+    /* a zwp_linux_dmabuf_feedback_v1, parsed. Updated as a whole on every done, tranches are in the host's order of preference. */
+    class CWaylandDmabufFeedback {
+      public:
+        CWaylandDmabufFeedback(Hyprutils::Memory::CSharedPointer<CCZwpLinuxDmabufFeedbackV1> feedback_, Hyprutils::Memory::CWeakPointer<CWaylandBackend> backend_);
+        ~CWaylandDmabufFeedback();
+
+        /* every format with the modifiers of the most preferred tranche that has it. Skips scanout tranches for other devices than ours. */
+        std::vector<SDRMFormat>            preferredFormats() const;
+
+        dev_t                              mainDevice = 0;
+        std::vector<SWaylandDmabufTranche> tranches;
+        std::function<void()>              onDone;
+
+      private:
+        Hyprutils::Memory::CSharedPointer<CCZwpLinuxDmabufFeedbackV1> feedback;
+        Hyprutils::Memory::CWeakPointer<CWaylandBackend>              backend;
+
+        std::vector<std::pair<uint32_t, uint64_t>>                    table; // format, modifier
+        dev_t                                                         pendingMainDevice = 0;
+        SWaylandDmabufTranche                                         pendingTranche;
+        std::vector<SWaylandDmabufTranche>                            pendingTranches;
+    };
+
     class CWaylandOutput : public IOutput {
       public:
         virtual ~CWaylandOutput();
@@ -51,6 +87,9 @@ namespace Aquamarine {
         virtual bool                                                      destroy();
         virtual std::vector<SDRMFormat>                                   getRenderFormats();
 
+        /* the host's per-surface dmabuf feedback, empty until it's been received */
+        const std::vector<SWaylandDmabufTranche>&                         dmabufTranches();
+
         Hyprutils::Memory::CWeakPointer<CWaylandOutput>                   self;
 
       private:
@@ -63,29 +102,88 @@ namespace Aquamarine {
         void                                              sendFrameAndSetCallback();
         void                                              onFrameDone();
         void                                              onEnter(Hyprutils::Memory::CSharedPointer<CCWlPointer> pointer, uint32_t serial);
+        void                                              damageBuffer(const Hyprutils::Math::Vector2D& size);
+        void                                              requestPresentFeedback();
+        void                                              updateViewport(const Hyprutils::Math::Vector2D& bufferSize_);
+        void                                              emitPreferredSize();
+        Hyprutils::Memory::CSharedPointer<CCWlBuffer>     shmCursorBuffer(Hyprutils::Memory::CSharedPointer<IBuffer> buffer);
+        bool                                              growCursorPool(size_t slotSize); // a new set of slots at least this large
+        bool                                              addCursorSlot();                 // one more slot of the current size
+        bool                                              resizeCursorPool(size_t size);
+        void                                              onSurfaceFeedback();
+        bool                                              initExplicitSync();
+        bool                                              setSyncPoints(Hyprutils::Memory::CSharedPointer<CWaylandBuffer> wlBuffer);
+        void                                              pollReleasePoints();
 
         // frame loop
-        bool frameScheduledWhileWaiting = false;
-        bool readyForFrameCallback      = false; // true after attaching a buffer
-        bool frameScheduled             = false;
+        bool                      frameScheduledWhileWaiting = false;
+        bool                      readyForFrameCallback      = false; // true after attaching a buffer
+        bool                      frameScheduled             = false;
+
+        Hyprutils::Math::Vector2D surfaceSize; // as of the last commit, surface-local pointer positions are normalized by it
+        Hyprutils::Math::Vector2D bufferSize;  // as of the last commit, relative pointer moves are scaled by bufferSize / surfaceSize
+
+        // the window can differ from the buffer in size when the host has wp_viewporter, the host scales
+        Hyprutils::Math::Vector2D viewportDestination = {-1, -1};
+        Hyprutils::Math::Vector2D windowSize;                // from xdg_toplevel.configure, 0 when the host leaves it to us
+        double                    preferredScale      = 1.0; // from wp_fractional_scale_v1
+
+        // from the per-surface dmabuf feedback, handed to the swapchain on the next commit when they changed
+        std::vector<SDRMFormat>   surfaceFormats;
+        bool                      surfaceFormatsChanged = false;
 
         struct {
             std::vector<std::pair<Hyprutils::Memory::CWeakPointer<IBuffer>, Hyprutils::Memory::CSharedPointer<CWaylandBuffer>>> buffers;
         } backendState;
 
+        // timeline syncobjs on the backend's drm fd, both advance by one point per commit
+        struct {
+            uint32_t acquire = 0, release = 0;
+            uint64_t point   = 0;
+        } syncobjState;
+
         struct {
             Hyprutils::Memory::CSharedPointer<IBuffer>     cursorBuffer;
             Hyprutils::Memory::CSharedPointer<CCWlSurface> cursorSurface;
             Hyprutils::Memory::CSharedPointer<CCWlBuffer>  cursorWlBuffer;
             uint32_t                                       serial = 0;
             Hyprutils::Math::Vector2D                      hotspot;
+
+            // shm cursors go into slots of one pool. Growing appends a new set of larger slots, and a slot is
+            // appended when the host holds all of them, so buffers the host may still read from stay intact.
+            struct SShmSlot {
+                Hyprutils::Memory::CSharedPointer<CCWlBuffer> buffer;
+                size_t                                        offset = 0;
+                Hyprutils::Math::Vector2D                     size;
+                int                                           stride = 0;
+                uint32_t                                      format = 0;
+                bool                                          busy   = false; // attached, not released by the host yet
+            };
+
+            std::vector<SShmSlot>                          shmSlots;
+            Hyprutils::Memory::CSharedPointer<CCWlShmPool> shmPool;
+            int                                            shmFD   = -1;
+            uint8_t*                                       shmData = nullptr;
+            size_t                                         shmSize = 0, shmSlotSize = 0, nextShmSlot = 0;
+            bool                                           shmUpdatePending = false; // every slot was busy, cursorBuffer goes up on the next release
         } cursorState;
 
         struct {
-            Hyprutils::Memory::CSharedPointer<CCWlSurface>   surface;
-            Hyprutils::Memory::CSharedPointer<CCXdgSurface>  xdgSurface;
-            Hyprutils::Memory::CSharedPointer<CCXdgToplevel> xdgToplevel;
-            Hyprutils::Memory::CSharedPointer<CCWlCallback>  frameCallback;
+            Hyprutils::Memory::CSharedPointer<CCWlSurface>            surface;
+            Hyprutils::Memory::CSharedPointer<CCXdgSurface>           xdgSurface;
+            Hyprutils::Memory::CSharedPointer<CCXdgToplevel>          xdgToplevel;
+            Hyprutils::Memory::CSharedPointer<CCWlCallback>           frameCallback;
+            Hyprutils::Memory::CSharedPointer<CCWpViewport>           viewport;
+            Hyprutils::Memory::CSharedPointer<CCWpFractionalScaleV1>  fractionalScale;
+            Hyprutils::Memory::CSharedPointer<CWaylandDmabufFeedback> dmabufFeedback;
+
+            // with explicit sync
+            Hyprutils::Memory::CSharedPointer<CCWpLinuxDrmSyncobjSurfaceV1>  syncobjSurface;
+            Hyprutils::Memory::CSharedPointer<CCWpLinuxDrmSyncobjTimelineV1> acquireTimeline, releaseTimeline;
+
+            // one per commit with wp_presentation, dropped on the next commit once the host answered
+            std::vector<Hyprutils::Memory::CSharedPointer<CCWpPresentationFeedback>> presentFeedbacks;
+            std::vector<CCWpPresentationFeedback*>                                   finishedPresentFeedbacks;
         } waylandState;
 
         friend class CWaylandBackend;
@@ -111,13 +209,20 @@ namespace Aquamarine {
         CWaylandPointer(Hyprutils::Memory::CSharedPointer<CCWlPointer> pointer_, Hyprutils::Memory::CWeakPointer<CWaylandBackend> backend_);
         virtual ~CWaylandPointer();
 
-        virtual const std::string&                       getName();
+        virtual const std::string& getName();
 
-        Hyprutils::Memory::CSharedPointer<CCWlPointer>   pointer;
-        Hyprutils::Memory::CWeakPointer<CWaylandBackend> backend;
+        // once this is bound, motion comes as relative moves only. Warps are then sent on enter alone
+        void                                                      bindRelative();
+
+        Hyprutils::Memory::CSharedPointer<CCWlPointer>            pointer;
+        Hyprutils::Memory::CSharedPointer<CCZwpRelativePointerV1> relativePointer;
+        Hyprutils::Memory::CWeakPointer<CWaylandBackend>          backend;
 
       private:
-        const std::string name = "wl_pointer";
+        void              warpTo(uint32_t timeMs, wl_fixed_t x, wl_fixed_t y);
+
+        uint32_t          lastTimeMs = 0;
+        const std::string name       = "wl_pointer";
     };
 
     class CWaylandBackend : public IBackendImplementation {
@@ -166,21 +271,28 @@ namespace Aquamarine {
             wl_display* display = nullptr;
 
             // hw-s types
-            Hyprutils::Memory::CSharedPointer<CCWlRegistry>               registry;
-            Hyprutils::Memory::CSharedPointer<CCWlSeat>                   seat;
-            Hyprutils::Memory::CSharedPointer<CCWlShm>                    shm;
-            Hyprutils::Memory::CSharedPointer<CCXdgWmBase>                xdg;
-            Hyprutils::Memory::CSharedPointer<CCWlCompositor>             compositor;
-            Hyprutils::Memory::CSharedPointer<CCZwpLinuxDmabufV1>         dmabuf;
-            Hyprutils::Memory::CSharedPointer<CCZwpLinuxDmabufFeedbackV1> dmabufFeedback;
+            Hyprutils::Memory::CSharedPointer<CCWlRegistry>                  registry;
+            Hyprutils::Memory::CSharedPointer<CCWlSeat>                      seat;
+            Hyprutils::Memory::CSharedPointer<CCWlShm>                       shm;
+            Hyprutils::Memory::CSharedPointer<CCXdgWmBase>                   xdg;
+            Hyprutils::Memory::CSharedPointer<CCWlCompositor>                compositor;
+            Hyprutils::Memory::CSharedPointer<CCZwpLinuxDmabufV1>            dmabuf;
+            Hyprutils::Memory::CSharedPointer<CWaylandDmabufFeedback>        dmabufFeedback; // the default one
+            Hyprutils::Memory::CSharedPointer<CCZwpRelativePointerManagerV1> relativePointerManager;
+            Hyprutils::Memory::CSharedPointer<CCWpPresentation>              presentation;
+            Hyprutils::Memory::CSharedPointer<CCWpViewporter>                viewporter;
+            Hyprutils::Memory::CSharedPointer<CCWpFractionalScaleManagerV1>  fractionalScaleManager;
+            Hyprutils::Memory::CSharedPointer<CCWpLinuxDrmSyncobjManagerV1>  syncobjManager;
 
             // control
-            bool dmabufFailed = false;
+            bool     dmabufFailed      = false;
+            uint32_t presentationClock = CLOCK_MONOTONIC; // the host's clock for wp_presentation timestamps
         } waylandState;
 
         struct {
-            int         fd       = -1;
-            std::string nodeName = "";
+            int         fd                = -1;
+            std::string nodeName          = "";
+            bool        supportsTimelines = false;
         } drmState;
 
         friend class CBackend;
@@ -188,5 +300,6 @@ namespace Aquamarine {
         friend class CWaylandPointer;
         friend class CWaylandOutput;
         friend class CWaylandBuffer;
+        friend class CWaylandDmabufFeedback;
     };
 };
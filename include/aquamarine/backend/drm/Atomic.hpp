@@ -12,6 +12,7 @@ namespace Aquamarine {
 
       private:
         bool                                         prepareConnector(Hyprutils::Memory::CSharedPointer<SDRMConnector> connector, SDRMConnectorCommitData& data);
+        bool                                         commitOnThread(Hyprutils::Memory::CSharedPointer<SDRMConnector> connector, SDRMConnectorCommitData& data, uint32_t flags);
 
         Hyprutils::Memory::CWeakPointer<CDRMBackend> backend;
 
@@ -30,6 +31,7 @@ namespace Aquamarine {
 
         void rollback(SDRMConnectorCommitData& data);
         void apply(SDRMConnectorCommitData& data);
+        void onCommitFailed(int ret, uint32_t flagssss);
 
         bool failed = false;
 
@@ -41,5 +43,7 @@ namespace Aquamarine {
         Hyprutils::Memory::CWeakPointer<CDRMBackend>     backend;
         drmModeAtomicReq*                                req = nullptr;
         Hyprutils::Memory::CSharedPointer<SDRMConnector> conn;
+
+        friend class CDRMAtomicImpl;
     };
 };
@@ -2,12 +2,33 @@
 
 #include <hyprutils/signal/Signal.hpp>
 #include <hyprutils/math/Vector2D.hpp>
+#include <span>
+#include <array>
+#include "../misc/Signal.hpp"
 
 struct libinput_device;
 
 namespace Aquamarine {
     class ITabletTool;
 
+    /*
+        Input events carry timeMs and the full precision timeUs, both CLOCK_MONOTONIC for libinput devices.
+
+        Latency from the kernel's event timestamp to aquamarine dispatching the event, in power of two buckets:
+        bucket 0 is < 1µs, bucket n is [2^(n-1), 2^n) µs, the last bucket also takes anything slower.
+    */
+    struct SInputLatencyHistogram {
+        static constexpr size_t       BUCKETS = 24;
+
+        std::array<uint64_t, BUCKETS> buckets = {};
+        uint64_t                      samples = 0, totalUs = 0, maxUs = 0;
+
+        void                          add(uint64_t latencyUs);
+        void                          reset();
+        uint64_t                      averageUs() const;
+        uint64_t                      percentileUs(double p) const; // upper bound of the bucket the percentile falls in, p in [0, 1]
+    };
+
     class IKeyboard {
       public:
         virtual ~IKeyboard() {
@@ -19,6 +40,7 @@ namespace Aquamarine {
 
         struct SKeyEvent {
             uint32_t timeMs  = 0;
+            uint64_t timeUs  = 0;
             uint32_t key     = 0;
             bool     pressed = false;
         };
@@ -29,7 +51,7 @@ namespace Aquamarine {
 
         struct {
             Hyprutils::Signal::CSignal destroy;
-            Hyprutils::Signal::CSignal key;
+            CTypedSignal<SKeyEvent>    key;
             Hyprutils::Signal::CSignal modifiers;
         } events;
     };
@@ -60,24 +82,34 @@ namespace Aquamarine {
             AQ_POINTER_AXIS_RELATIVE_INVERTED,
         };
 
-        struct SMoveEvent {
-            uint32_t                  timeMs = 0;
+        struct SMotionSample {
+            uint64_t                  timeUs = 0;
             Hyprutils::Math::Vector2D delta, unaccel;
         };
 
+        struct SMoveEvent {
+            uint32_t                       timeMs = 0;
+            uint64_t                       timeUs = 0;
+            Hyprutils::Math::Vector2D      delta, unaccel;
+            std::span<const SMotionSample> samples; // with input coalescing, the raw motions summed into this one. Only valid during the emit.
+        };
+
         struct SWarpEvent {
             uint32_t                  timeMs = 0;
+            uint64_t                  timeUs = 0;
             Hyprutils::Math::Vector2D absolute;
         };
 
         struct SButtonEvent {
             uint32_t timeMs  = 0;
+            uint64_t timeUs  = 0;
             uint32_t button  = 0;
             bool     pressed = false;
         };
 
         struct SAxisEvent {
             uint32_t                      timeMs    = 0;
+            uint64_t                      timeUs    = 0;
             ePointerAxis                  axis      = AQ_POINTER_AXIS_VERTICAL;
             ePointerAxisSource            source    = AQ_POINTER_AXIS_SOURCE_WHEEL;
             ePointerAxisRelativeDirection direction = AQ_POINTER_AXIS_RELATIVE_IDENTICAL;
@@ -86,27 +118,32 @@ namespace Aquamarine {
 
         struct SSwipeBeginEvent {
             uint32_t timeMs  = 0;
+            uint64_t timeUs  = 0;
             uint32_t fingers = 0;
         };
 
         struct SSwipeUpdateEvent {
             uint32_t                  timeMs  = 0;
+            uint64_t                  timeUs  = 0;
             uint32_t                  fingers = 0;
             Hyprutils::Math::Vector2D delta;
         };
 
         struct SSwipeEndEvent {
             uint32_t timeMs    = 0;
+            uint64_t timeUs    = 0;
             bool     cancelled = false;
         };
 
         struct SPinchBeginEvent {
             uint32_t timeMs  = 0;
+            uint64_t timeUs  = 0;
             uint32_t fingers = 0;
         };
 
         struct SPinchUpdateEvent {
             uint32_t                  timeMs  = 0;
+            uint64_t                  timeUs  = 0;
             uint32_t                  fingers = 0;
             Hyprutils::Math::Vector2D delta;
             double                    scale = 1.0, rotation = 0.0;
@@ -114,26 +151,29 @@ namespace Aquamarine {
 
         struct SPinchEndEvent {
             uint32_t timeMs    = 0;
+            uint64_t timeUs    = 0;
             bool     cancelled = false;
         };
 
         struct SHoldBeginEvent {
             uint32_t timeMs  = 0;
+            uint64_t timeUs  = 0;
             uint32_t fingers = 0;
         };
 
         struct SHoldEndEvent {
             uint32_t timeMs    = 0;
+            uint64_t timeUs    = 0;
             bool     cancelled = false;
         };
 
         struct {
             Hyprutils::Signal::CSignal destroy;
-            Hyprutils::Signal::CSignal move;
-            Hyprutils::Signal::CSignal warp;
-            Hyprutils::Signal::CSignal button;
-            Hyprutils::Signal::CSignal axis;
-            Hyprutils::Signal::CSignal frame;
+            CTypedSignal<SMoveEvent>   move;
+            CTypedSignal<SWarpEvent>   warp;
+            CTypedSignal<SButtonEvent> button;
+            CTypedSignal<SAxisEvent>   axis;
+            CTypedSignal<>             frame;
 
             Hyprutils::Signal::CSignal swipeBegin;
             Hyprutils::Signal::CSignal swipeUpdate;
@@ -161,33 +201,45 @@ namespace Aquamarine {
 
         struct SDownEvent {
             uint32_t                  timeMs  = 0;
+            uint64_t                  timeUs  = 0;
             int32_t                   touchID = 0;
             Hyprutils::Math::Vector2D pos;
         };
 
         struct SUpEvent {
             uint32_t timeMs  = 0;
+            uint64_t timeUs  = 0;
             int32_t  touchID = 0;
         };
 
         struct SMotionEvent {
             uint32_t                  timeMs  = 0;
+            uint64_t                  timeUs  = 0;
             int32_t                   touchID = 0;
             Hyprutils::Math::Vector2D pos;
         };
 
         struct SCancelEvent {
             uint32_t timeMs  = 0;
+            uint64_t timeUs  = 0;
             int32_t  touchID = 0;
         };
 
+        /* the motions of one touch frame, one array entry per motion. Only valid during the emit. */
+        struct SMotionBatch {
+            std::span<const uint64_t> timeUs;
+            std::span<const int32_t>  touchID;
+            std::span<const double>   x, y;
+        };
+
         struct {
             Hyprutils::Signal::CSignal destroy;
-            Hyprutils::Signal::CSignal move;
-            Hyprutils::Signal::CSignal down;
-            Hyprutils::Signal::CSignal up;
+            CTypedSignal<SMotionEvent> move;
+            CTypedSignal<SMotionBatch> moveBatch; // with SBackendOptions::batchInput, instead of move
+            CTypedSignal<SDownEvent>   down;
+            CTypedSignal<SUpEvent>     up;
             Hyprutils::Signal::CSignal cancel;
-            Hyprutils::Signal::CSignal frame;
+            CTypedSignal<>             frame;
         } events;
     };
 
@@ -208,6 +260,7 @@ namespace Aquamarine {
 
         struct SFireEvent {
             uint32_t    timeMs = 0;
+            uint64_t    timeUs = 0;
             eSwitchType type   = AQ_SWITCH_TYPE_UNKNOWN;
             bool        enable = false;
         };
@@ -246,7 +299,9 @@ namespace Aquamarine {
         struct SAxisEvent {
             Hyprutils::Memory::CSharedPointer<ITabletTool> tool;
 
-            uint32_t                                       timeMs = 0, updatedAxes = 0;
+            uint32_t                                       timeMs      = 0;
+            uint64_t                                       timeUs      = 0;
+            uint32_t                                       updatedAxes = 0;
             Hyprutils::Math::Vector2D                      absolute;
             Hyprutils::Math::Vector2D                      delta;
             Hyprutils::Math::Vector2D                      tilt;
@@ -257,6 +312,7 @@ namespace Aquamarine {
             Hyprutils::Memory::CSharedPointer<ITabletTool> tool;
 
             uint32_t                                       timeMs = 0;
+            uint64_t                                       timeUs = 0;
             Hyprutils::Math::Vector2D                      absolute;
             bool                                           in = false;
         };
@@ -265,6 +321,7 @@ namespace Aquamarine {
             Hyprutils::Memory::CSharedPointer<ITabletTool> tool;
 
             uint32_t                                       timeMs = 0;
+            uint64_t                                       timeUs = 0;
             Hyprutils::Math::Vector2D                      absolute;
             bool                                           down = false;
         };
@@ -272,12 +329,28 @@ namespace Aquamarine {
         struct SButtonEvent {
             Hyprutils::Memory::CSharedPointer<ITabletTool> tool;
 
-            uint32_t                                       timeMs = 0, button = 0;
-            bool                                           down = false;
+            uint32_t                                       timeMs = 0;
+            uint64_t                                       timeUs = 0;
+            uint32_t                                       button = 0;
+            bool                                           down   = false;
+        };
+
+        /*
+            consecutive axis events of one tool, one array entry per event. Unlike in SAxisEvent, every axis holds its
+            current value, updatedAxes says which ones changed. Only valid during the emit.
+        */
+        struct SAxisBatch {
+            Hyprutils::Memory::CSharedPointer<ITabletTool> tool;
+
+            std::span<const uint64_t>                      timeUs;
+            std::span<const uint32_t>                      updatedAxes;
+            std::span<const double>                        x, y, dx, dy, tiltX, tiltY;
+            std::span<const double>                        pressure, distance, rotation, slider, wheelDelta;
         };
 
         struct {
-            Hyprutils::Signal::CSignal axis;
+            CTypedSignal<SAxisEvent>   axis;
+            CTypedSignal<SAxisBatch>   axisBatch; // with SBackendOptions::batchInput, instead of axis
             Hyprutils::Signal::CSignal proximity;
             Hyprutils::Signal::CSignal tip;
             Hyprutils::Signal::CSignal button;
@@ -347,9 +420,11 @@ namespace Aquamarine {
         //
 
         struct SButtonEvent {
-            uint32_t timeMs = 0, button = 0;
-            bool     down = false;
-            uint16_t mode = 0, group = 0;
+            uint32_t timeMs = 0;
+            uint64_t timeUs = 0;
+            uint32_t button = 0;
+            bool     down   = false;
+            uint16_t mode   = 0, group = 0;
         };
 
         enum eTabletPadRingSource : uint16_t {
@@ -364,6 +439,7 @@ namespace Aquamarine {
 
         struct SRingEvent {
             uint32_t             timeMs = 0;
+            uint64_t             timeUs = 0;
             eTabletPadRingSource source = AQ_TABLET_PAD_RING_SOURCE_UNKNOWN;
             uint16_t             ring   = 0;
             double               pos    = 0.0;
@@ -372,6 +448,7 @@ namespace Aquamarine {
 
         struct SStripEvent {
             uint32_t              timeMs = 0;
+            uint64_t              timeUs = 0;
             eTabletPadStripSource source = AQ_TABLET_PAD_STRIP_SOURCE_UNKNOWN;
             uint16_t              strip  = 0;
             double                pos    = 0.0;
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <hyprutils/memory/WeakPtr.hpp>
+#include <hyprutils/signal/Signal.hpp>
+#include "Input.hpp"
+
+/*
+    Recording and replaying of aquamarine input events, for benchmarking and regression testing the input path
+    without physical devices.
+
+    A recording is "AQIR", a u32 version, then one record per event:
+        u8 type, u16 payload size, u32 device, u64 time (µs, CLOCK_MONOTONIC when it was recorded), payload
+    in host byte order. Devices and tablet tools are records too, so a recording is self-contained.
+*/
+
+namespace Aquamarine {
+    class CBackend;
+    class CBackendTimer;
+
+    enum eInputRecordType : uint8_t {
+        AQ_INPUT_RECORD_DEVICE = 0,
+        AQ_INPUT_RECORD_DEVICE_REMOVE,
+        AQ_INPUT_RECORD_TABLET_TOOL,
+
+        AQ_INPUT_RECORD_KEY,
+        AQ_INPUT_RECORD_MODIFIERS,
+
+        AQ_INPUT_RECORD_POINTER_MOVE,
+        AQ_INPUT_RECORD_POINTER_WARP,
+        AQ_INPUT_RECORD_POINTER_BUTTON,
+        AQ_INPUT_RECORD_POINTER_AXIS,
+        AQ_INPUT_RECORD_POINTER_FRAME,
+        AQ_INPUT_RECORD_SWIPE_BEGIN,
+        AQ_INPUT_RECORD_SWIPE_UPDATE,
+        AQ_INPUT_RECORD_SWIPE_END,
+        AQ_INPUT_RECORD_PINCH_BEGIN,
+        AQ_INPUT_RECORD_PINCH_UPDATE,
+        AQ_INPUT_RECORD_PINCH_END,
+        AQ_INPUT_RECORD_HOLD_BEGIN,
+        AQ_INPUT_RECORD_HOLD_END,
+
+        AQ_INPUT_RECORD_TOUCH_DOWN,
+        AQ_INPUT_RECORD_TOUCH_UP,
+        AQ_INPUT_RECORD_TOUCH_MOTION,
+        AQ_INPUT_RECORD_TOUCH_CANCEL,
+        AQ_INPUT_RECORD_TOUCH_FRAME,
+
+        AQ_INPUT_RECORD_TABLET_AXIS,
+        AQ_INPUT_RECORD_TABLET_PROXIMITY,
+        AQ_INPUT_RECORD_TABLET_TIP,
+        AQ_INPUT_RECORD_TABLET_BUTTON,
+    };
+
+    enum eInputRecordDevice : uint8_t {
+        AQ_INPUT_RECORD_DEVICE_KEYBOARD = 0,
+        AQ_INPUT_RECORD_DEVICE_POINTER,
+        AQ_INPUT_RECORD_DEVICE_TOUCH,
+        AQ_INPUT_RECORD_DEVICE_TABLET,
+    };
+
+    class CInputRecorder {
+      public:
+        static Hyprutils::Memory::CSharedPointer<CInputRecorder> create(const std::string& path);
+        ~CInputRecorder();
+
+        /* record every device the backend announces from now on */
+        void attach(Hyprutils::Memory::CSharedPointer<CBackend> backend);
+
+        void attach(Hyprutils::Memory::CSharedPointer<IKeyboard> keyboard);
+        void attach(Hyprutils::Memory::CSharedPointer<IPointer> pointer);
+        void attach(Hyprutils::Memory::CSharedPointer<ITouch> touch);
+        void attach(Hyprutils::Memory::CSharedPointer<ITablet> tablet);
+
+        /* write out whatever is buffered. Also done on destruction. */
+        void   flush();
+
+        size_t recorded = 0; // events written so far, not counting devices and tools
+
+      private:
+        CInputRecorder() = default;
+
+        struct SDevice {
+            CInputRecorder*                                                                    recorder = nullptr;
+            uint32_t                                                                           id       = 0;
+
+            std::vector<Hyprutils::Signal::CHyprSignalListener>                                listeners;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<IKeyboard::SKeyEvent>::CListener>   key;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<IPointer::SMoveEvent>::CListener>   move;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<IPointer::SWarpEvent>::CListener>   warp;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<IPointer::SButtonEvent>::CListener> button;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<IPointer::SAxisEvent>::CListener>   axis;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<>::CListener>                       frame;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITouch::SDownEvent>::CListener>     touchDown;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITouch::SUpEvent>::CListener>       touchUp;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITouch::SMotionEvent>::CListener>   touchMotion;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITouch::SMotionBatch>::CListener>   touchMotionBatch;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITablet::SAxisEvent>::CListener>    tabletAxis;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITablet::SAxisBatch>::CListener>    tabletAxisBatch;
+        };
+
+        Hyprutils::Memory::CSharedPointer<SDevice>                addDevice(eInputRecordDevice kind, const std::string& name);
+        uint32_t                                                  toolID(uint32_t device, Hyprutils::Memory::CSharedPointer<ITabletTool> tool);
+        void                                                      write(eInputRecordType type, uint32_t device, const std::vector<uint8_t>& payload);
+
+        FILE*                                                     file         = nullptr;
+        uint32_t                                                  nextDeviceID = 0;
+        std::vector<Hyprutils::Memory::CSharedPointer<SDevice>>   devices;
+        std::vector<Hyprutils::Memory::CWeakPointer<ITabletTool>> tools; // index is the recorded tool id
+        std::vector<Hyprutils::Signal::CHyprSignalListener>       backendListeners;
+        std::vector<uint8_t>                                      scratch;
+        Hyprutils::Memory::CWeakPointer<CInputRecorder>           self;
+    };
+
+    /*
+        Replays a recording into virtual devices. Each recorded device is announced through the backend's
+        newKeyboard / newPointer / newTouch / newTablet (and newTabletTool) events, then gets its recorded
+        events emitted on the same signals as a real device would, from the backend's loop.
+        Timestamps in the events are shifted to when the replay started.
+    */
+    class CInputReplay {
+      public:
+        static Hyprutils::Memory::CSharedPointer<CInputReplay> create(Hyprutils::Memory::CSharedPointer<CBackend> backend, const std::string& path);
+        ~CInputReplay();
+
+        /* speed 1.0 replays at the recorded pace, 2.0 twice as fast etc. 0 replays as fast as the loop goes. */
+        void   start(double speed = 1.0);
+        void   stop();
+        bool   finished();
+
+        size_t replayed = 0; // events emitted so far
+
+        struct {
+            Hyprutils::Signal::CSignal finished;
+        } events;
+
+      private:
+        CInputReplay() = default;
+
+        struct SRecord {
+            eInputRecordType type   = AQ_INPUT_RECORD_DEVICE;
+            uint32_t         device = 0;
+            uint64_t         timeUs = 0;
+            size_t           offset = 0; // payload, into data
+            uint16_t         size   = 0;
+        };
+
+        struct SDevice {
+            eInputRecordDevice                           kind = AQ_INPUT_RECORD_DEVICE_KEYBOARD;
+            Hyprutils::Memory::CSharedPointer<IKeyboard> keyboard;
+            Hyprutils::Memory::CSharedPointer<IPointer>  pointer;
+            Hyprutils::Memory::CSharedPointer<ITouch>    touch;
+            Hyprutils::Memory::CSharedPointer<ITablet>   tablet;
+        };
+
+        void                                                        dispatch();
+        void                                                        replay(const SRecord& record);
+        SDevice*                                                    deviceFor(const SRecord& record);
+
+        Hyprutils::Memory::CWeakPointer<CBackend>                   backend;
+        std::vector<uint8_t>                                        data;
+        std::vector<SRecord>                                        records;
+        size_t                                                      next            = 0;
+        double                                                      speed           = 1.0;
+        uint64_t                                                    recordedStartUs = 0, replayStartUs = 0;
+        bool                                                        running         = false;
+        std::vector<SDevice>                                        devices;
+        std::vector<Hyprutils::Memory::CSharedPointer<ITabletTool>> tools;
+        Hyprutils::Memory::CSharedPointer<CBackendTimer>            timer;
+        Hyprutils::Memory::CWeakPointer<CInputReplay>               self;
+    };
+};
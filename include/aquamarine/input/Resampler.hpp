@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <hyprutils/memory/WeakPtr.hpp>
+#include <hyprutils/signal/Signal.hpp>
+#include <hyprutils/math/Vector2D.hpp>
+#include "Input.hpp"
+
+/*
+    Resampling of pointer, touch and tablet motion to an arbitrary point in time, usually the predicted
+    presentation time of the next frame, so motion can be rendered where it is when the frame hits the screen
+    instead of where the last event left it.
+
+    Every attached device keeps its last few motion samples. Asking for a time within them interpolates,
+    asking for a time past the last one extrapolates from the last two, at most maxPredictionUs ahead.
+    Times are the events' timeUs, i.e. CLOCK_MONOTONIC for libinput devices. Everything runs on the
+    thread that runs the backend loop.
+*/
+
+namespace Aquamarine {
+    class CBackend;
+
+    class CInputResampler {
+      public:
+        static Hyprutils::Memory::CSharedPointer<CInputResampler> create();
+
+        /* track every device the backend announces from now on */
+        void attach(Hyprutils::Memory::CSharedPointer<CBackend> backend);
+
+        void attach(Hyprutils::Memory::CSharedPointer<IPointer> pointer);
+        void attach(Hyprutils::Memory::CSharedPointer<ITouch> touch);
+        void attach(Hyprutils::Memory::CSharedPointer<ITablet> tablet);
+
+        /*
+            motion of a relative pointer between its last move and timeUs, in the units of SMoveEvent::delta. Add it to
+            the cursor position the moves got you to. Negative when timeUs is before the last move. Warps reset the history.
+        */
+        std::optional<Hyprutils::Math::Vector2D> pointerOffset(Hyprutils::Memory::CSharedPointer<IPointer> pointer, uint64_t timeUs);
+
+        /* position (0 - 1) of a touch point that's down / of the tablet's tool in proximity, at timeUs */
+        std::optional<Hyprutils::Math::Vector2D> touchPosition(Hyprutils::Memory::CSharedPointer<ITouch> touch, int32_t touchID, uint64_t timeUs);
+        std::optional<Hyprutils::Math::Vector2D> tabletPosition(Hyprutils::Memory::CSharedPointer<ITablet> tablet, uint64_t timeUs);
+
+        uint64_t                                 maxPredictionUs = 8000;  // extrapolate at most this far past the last sample
+        uint64_t                                 maxIdleUs       = 20000; // no extrapolation once the device's been still for this long
+
+      private:
+        CInputResampler() = default;
+
+        struct SSample {
+            uint64_t                  timeUs = 0;
+            Hyprutils::Math::Vector2D pos;
+        };
+
+        struct SHistory {
+            static constexpr size_t                  SIZE = 8;
+
+            std::array<SSample, SIZE>                samples;
+            size_t                                   count = 0, head = 0; // head is where the next sample goes
+
+            void                                     push(uint64_t timeUs, const Hyprutils::Math::Vector2D& pos);
+            void                                     clear();
+            const SSample&                           at(size_t i) const; // 0 is the oldest
+            const SSample&                           last() const;
+            std::optional<Hyprutils::Math::Vector2D> resample(uint64_t timeUs, uint64_t maxPredictionUs, uint64_t maxIdleUs) const;
+        };
+
+        struct SDevice {
+            void*                                                                            device = nullptr; // only for lookup, never dereferenced
+
+            SHistory                                                                         history; // pointer: summed moves, tablet: tool position
+            Hyprutils::Math::Vector2D                                                        position;
+            std::unordered_map<int32_t, SHistory>                                            touches;
+
+            std::vector<Hyprutils::Signal::CHyprSignalListener>                              listeners;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<IPointer::SMoveEvent>::CListener> move;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<IPointer::SWarpEvent>::CListener> warp;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITouch::SDownEvent>::CListener>   touchDown;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITouch::SUpEvent>::CListener>     touchUp;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITouch::SMotionEvent>::CListener> touchMotion;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITouch::SMotionBatch>::CListener> touchMotionBatch;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITablet::SAxisEvent>::CListener>  tabletAxis;
+            Hyprutils::Memory::CSharedPointer<CTypedSignal<ITablet::SAxisBatch>::CListener>  tabletAxisBatch;
+        };
+
+        Hyprutils::Memory::CSharedPointer<SDevice>              addDevice(void* device);
+        SDevice*                                                deviceFor(void* device);
+        void                                                    removeDevice(void* device);
+
+        std::vector<Hyprutils::Memory::CSharedPointer<SDevice>> devices;
+        std::vector<Hyprutils::Signal::CHyprSignalListener>     backendListeners;
+    };
+};
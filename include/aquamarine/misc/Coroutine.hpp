@@ -0,0 +1,189 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <ctime>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <hyprutils/memory/WeakPtr.hpp>
+#include <hyprutils/signal/Signal.hpp>
+#include "Signal.hpp"
+#include "../output/Output.hpp"
+
+/*
+    Optional C++20 coroutine layer over the output events.
+
+    Awaitables resume their coroutine from the backend's loop (via postToLoop), never from inside
+    the signal emission that completed them, so a coroutine may freely commit, destroy listeners etc.
+    No threads are involved; everything runs on the thread that runs the backend loop.
+
+    Awaitables start listening when they are created, not when awaited, so an event can't be missed
+    in between. E.g. to not miss the present event of a tearing commit:
+
+        CTask renderLoop(SP<CCoroutineScheduler> sched, SP<IOutput> output) {
+            while (co_await sched->nextFrame(output)) {
+                output->state->setBuffer(render());
+                auto presentation = sched->presented(output);
+                if (!co_await sched->commit(output))
+                    continue;
+                if (auto info = co_await presentation)
+                    ...
+            }
+        }
+
+    Awaitables aren't copyable or movable, keep them in the coroutine frame.
+    A coroutine suspended when the backend goes away is never resumed, and its frame leaks.
+*/
+
+namespace Aquamarine {
+    class CBackend;
+
+    /* fire-and-forget coroutine: runs eagerly until its first suspension, frees itself when done. */
+    class CTask {
+      public:
+        struct promise_type {
+            CTask get_return_object() {
+                return {};
+            }
+            std::suspend_never initial_suspend() noexcept {
+                return {};
+            }
+            std::suspend_never final_suspend() noexcept {
+                return {};
+            }
+            void return_void() {
+                ;
+            }
+            void unhandled_exception() {
+                std::terminate();
+            }
+        };
+    };
+
+    class CCoroutineScheduler;
+
+    class IOutputAwaitable {
+      public:
+        IOutputAwaitable(const IOutputAwaitable&)            = delete;
+        IOutputAwaitable& operator=(const IOutputAwaitable&) = delete;
+
+        bool              await_ready() const noexcept {
+            return done;
+        }
+        void await_suspend(std::coroutine_handle<> h);
+
+      protected:
+        IOutputAwaitable(Hyprutils::Memory::CWeakPointer<CBackend> backend_, Hyprutils::Memory::CSharedPointer<IOutput> output);
+
+        void                                      complete(); // marks done and resumes the awaiting coroutine, if any
+
+        bool                                      done = false;
+        bool                                      lost = false; // output got destroyed
+        std::coroutine_handle<>                   handle;
+        Hyprutils::Memory::CWeakPointer<CBackend> backend;
+        Hyprutils::Signal::CHyprSignalListener    destroyListener;
+    };
+
+    /* resumes with true on the output's next frame event, false if the output got destroyed. */
+    class CFrameAwaitable : public IOutputAwaitable {
+      public:
+        bool await_resume() const noexcept {
+            return !lost;
+        }
+
+      private:
+        CFrameAwaitable(Hyprutils::Memory::CWeakPointer<CBackend> backend_, Hyprutils::Memory::CSharedPointer<IOutput> output);
+
+        Hyprutils::Memory::CSharedPointer<CTypedSignal<>::CListener> frameListener;
+
+        friend class CCoroutineScheduler;
+    };
+
+    struct SPresentInfo {
+        bool         presented = true;
+        timespec     when      = {}; // zero if the backend didn't say
+        unsigned int seq       = 0;
+        int          refresh   = 0;
+        uint32_t     flags     = 0; // IOutput::eOutputPresentFlags
+    };
+
+    /* resumes with the next present event of the output, nullopt if the output got destroyed. */
+    class CPresentAwaitable : public IOutputAwaitable {
+      public:
+        std::optional<SPresentInfo> await_resume() const noexcept {
+            if (lost)
+                return std::nullopt;
+            return info;
+        }
+
+      private:
+        CPresentAwaitable(Hyprutils::Memory::CWeakPointer<CBackend> backend_, Hyprutils::Memory::CSharedPointer<IOutput> output);
+
+        SPresentInfo                                                                      info;
+        Hyprutils::Memory::CSharedPointer<CTypedSignal<IOutput::SPresentEvent>::CListener> presentListener;
+
+        friend class CCoroutineScheduler;
+    };
+
+    /*
+        commits the output's pending state once awaited and resumes with what commit() returned, never suspends.
+        Nothing is committed if this isn't awaited. With AQ_DRM_COMMIT_THREAD a true is provisional:
+        the kernel may still reject the commit, which is reported through the output's events.commitFailed.
+    */
+    class CCommitAwaitable {
+      public:
+        CCommitAwaitable(const CCommitAwaitable&)            = delete;
+        CCommitAwaitable& operator=(const CCommitAwaitable&) = delete;
+
+        bool              await_ready();
+        void              await_suspend(std::coroutine_handle<> h) const noexcept {
+            ;
+        }
+        bool await_resume() const noexcept {
+            return result;
+        }
+
+      private:
+        CCommitAwaitable(Hyprutils::Memory::CSharedPointer<IOutput> output_);
+
+        Hyprutils::Memory::CWeakPointer<IOutput> output;
+        bool                                     result = false;
+
+        friend class CCoroutineScheduler;
+    };
+
+    /* suspends and resumes on the next loop iteration. Awaiting this from another thread moves the coroutine onto the loop. */
+    class CYieldAwaitable {
+      public:
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> h);
+        void await_resume() const noexcept {
+            ;
+        }
+
+      private:
+        CYieldAwaitable(Hyprutils::Memory::CWeakPointer<CBackend> backend_);
+
+        Hyprutils::Memory::CWeakPointer<CBackend> backend;
+
+        friend class CCoroutineScheduler;
+    };
+
+    class CCoroutineScheduler {
+      public:
+        CCoroutineScheduler(Hyprutils::Memory::CSharedPointer<CBackend> backend_);
+
+        /* resume h on the backend loop. Thread-safe. */
+        void              schedule(std::coroutine_handle<> h);
+
+        CFrameAwaitable   nextFrame(Hyprutils::Memory::CSharedPointer<IOutput> output);
+        CPresentAwaitable presented(Hyprutils::Memory::CSharedPointer<IOutput> output);
+        CCommitAwaitable  commit(Hyprutils::Memory::CSharedPointer<IOutput> output);
+        CYieldAwaitable   yield();
+
+      private:
+        Hyprutils::Memory::CWeakPointer<CBackend> backend;
+    };
+};
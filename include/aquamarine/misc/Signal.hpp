@@ -0,0 +1,96 @@
+#pragma once
+
+#include <any>
+#include <functional>
+#include <vector>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <hyprutils/memory/WeakPtr.hpp>
+#include <hyprutils/signal/Signal.hpp>
+
+namespace Aquamarine {
+    /*
+        A signal for high-rate events (pointer motion, frames, presentation...)
+
+        Typed listeners get the event by reference through a plain function pointer + context pair,
+        no std::any boxing and no allocations when emitting.
+
+        It's a drop-in for Hyprutils::Signal::CSignal: std::any listeners still work, but the event
+        only gets boxed for them if any are registered.
+    */
+    template <typename... Args>
+    class CTypedSignal {
+      public:
+        typedef void (*listenerFn)(void* data, const Args&... args);
+
+        class CListener {
+          public:
+            CListener(listenerFn fn_, void* data_) : fn(fn_), data(data_) {
+                ;
+            }
+
+          private:
+            listenerFn fn   = nullptr;
+            void*      data = nullptr;
+
+            friend class CTypedSignal;
+        };
+
+        /* dropping the returned listener unregisters it, also from inside an emit. */
+        Hyprutils::Memory::CSharedPointer<CListener> registerTypedListener(listenerFn fn, void* data) {
+            auto listener = Hyprutils::Memory::makeShared<CListener>(fn, data);
+            typedListeners.emplace_back(listener);
+            return listener;
+        }
+
+        Hyprutils::Signal::CHyprSignalListener registerListener(std::function<void(std::any)> handler) {
+            auto listener = legacy.registerListener(handler);
+            // expired ones are only pruned here and in the deferred cleanup, emit() doesn't scan for them
+            std::erase_if(legacyListeners, [](const auto& l) { return l.expired(); });
+            legacyListeners.emplace_back(listener);
+            return listener;
+        }
+
+        void registerStaticListener(std::function<void(void*, std::any)> handler, void* owner) {
+            legacy.registerStaticListener(handler, owner);
+            hasStaticListeners = true;
+        }
+
+        void emit(const Args&... args) {
+            emitting++;
+
+            // listeners may come and go from inside a listener, so index and check each one
+            for (size_t i = 0; i < typedListeners.size(); ++i) {
+                auto listener = typedListeners[i].lock();
+                if (!listener) {
+                    needsCleanup = true;
+                    continue;
+                }
+
+                listener->fn(listener->data, args...);
+            }
+
+            if (hasStaticListeners || !legacyListeners.empty()) {
+                if constexpr (sizeof...(Args) == 0)
+                    legacy.emit();
+                else
+                    legacy.emit(std::any{args...});
+            }
+
+            emitting--;
+
+            if (!emitting && needsCleanup) {
+                std::erase_if(typedListeners, [](const auto& l) { return l.expired(); });
+                std::erase_if(legacyListeners, [](const auto& l) { return l.expired(); });
+                needsCleanup = false;
+            }
+        }
+
+      private:
+        std::vector<Hyprutils::Memory::CWeakPointer<CListener>>                         typedListeners;
+        std::vector<Hyprutils::Memory::CWeakPointer<Hyprutils::Signal::CSignalListener>> legacyListeners;
+        Hyprutils::Signal::CSignal                                                      legacy;
+        bool                                                                            hasStaticListeners = false;
+        bool                                                                            needsCleanup       = false;
+        size_t                                                                          emitting           = 0;
+    };
+};
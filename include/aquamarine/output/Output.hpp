@@ -10,6 +10,7 @@
 #include "../allocator/Swapchain.hpp"
 #include "../buffer/Buffer.hpp"
 #include "../backend/Misc.hpp"
+#include "../misc/Signal.hpp"
 
 namespace Aquamarine {
 
@@ -69,8 +70,12 @@ namespace Aquamarine {
             int64_t                                        explicitInFence = -1, explicitOutFence = -1;
         };
 
+        /* the pending state, what the next commit applies. The setters below modify it */
         const SInternalState& state();
 
+        /* the state as of the last successful commit. committed holds what that commit changed, damage isn't carried over */
+        const SInternalState& current();
+
         void                  addDamage(const Hyprutils::Math::CRegion& region);
         void                  clearDamage();
         void                  setEnabled(bool enabled);
@@ -86,9 +91,9 @@ namespace Aquamarine {
         void                  resetExplicitFences();
 
       private:
-        SInternalState internalState;
+        SInternalState internalState, currentState;
 
-        void           onCommit(); // clears a few props like damage and committed.
+        void           onCommit(); // moves pending into current, clears a few props like damage and committed.
 
         friend class IOutput;
         friend class CWaylandOutput;
@@ -117,6 +122,10 @@ namespace Aquamarine {
             AQ_SCHEDULE_ANIMATION_DAMAGE,
         };
 
+        /*
+            Applies the pending state. Returns false and applies nothing while the previous commit is still being applied, e.g. on DRM
+            with a page flip, a threaded commit or a nonblocking modeset pending. Commit again after events.frame / events.modeset.
+        */
         virtual bool                                                      commit()           = 0;
         virtual bool                                                      test()             = 0;
         virtual Hyprutils::Memory::CSharedPointer<IBackendImplementation> getBackend()       = 0;
@@ -136,8 +145,9 @@ namespace Aquamarine {
         bool                                                              nonDesktop = false;
         eSubpixelMode                                                     subpixel   = AQ_SUBPIXEL_NONE;
         bool                                                              vrrCapable = false, vrrActive = false;
-        bool                                                              needsFrame       = false;
-        bool                                                              supportsExplicit = false;
+        bool                                                              needsFrame              = false;
+        bool                                                              supportsExplicit        = false;
+        bool                                                              supportsExplicitInFence = false; // in fences are waited on, but no out fence is produced
 
         //
         std::vector<Hyprutils::Memory::CSharedPointer<SOutputMode>> modes;
@@ -166,12 +176,14 @@ namespace Aquamarine {
         };
 
         struct {
-            Hyprutils::Signal::CSignal destroy;
-            Hyprutils::Signal::CSignal frame;
-            Hyprutils::Signal::CSignal needsFrame;
-            Hyprutils::Signal::CSignal present;
-            Hyprutils::Signal::CSignal commit;
-            Hyprutils::Signal::CSignal state;
+            Hyprutils::Signal::CSignal  destroy;
+            CTypedSignal<>              frame;
+            Hyprutils::Signal::CSignal  needsFrame;
+            CTypedSignal<SPresentEvent> present;
+            Hyprutils::Signal::CSignal  commit;
+            Hyprutils::Signal::CSignal  commitFailed; // a commit() that returned true was rejected later (DRM commit thread), state() holds it again
+            Hyprutils::Signal::CSignal  state;
+            Hyprutils::Signal::CSignal  modeset; // the last modeset is now active on the hardware
         } events;
     };
 }
@@ -64,11 +64,13 @@ Aquamarine::CGBMBuffer::CGBMBuffer(const SAllocatorBufferParams& params, Hypruti
     const bool CURSOR   = params.cursor && params.scanout;
     const bool MULTIGPU = params.multigpu && params.scanout;
 
-    TRACE(allocator->backend->log(AQ_LOG_TRACE,
-                                  std::format("GBM: Allocating a buffer: size {}, format {}, cursor: {}, multigpu: {}, scanout: {}", attrs.size, fourccToName(attrs.format), CURSOR,
-                                              MULTIGPU, params.scanout)));
+    TRACE(AQLOG(allocator->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_ALLOCATOR,
+                std::format("GBM: Allocating a buffer: size {}, format {}, cursor: {}, multigpu: {}, scanout: {}", attrs.size, fourccToName(attrs.format), CURSOR,
+                            MULTIGPU, params.scanout)));
 
-    const auto            FORMATS    = CURSOR ? swapchain->backendImpl->getCursorFormats() : swapchain->backendImpl->getRenderFormats();
+    const auto            FORMATS    = CURSOR                         ? swapchain->backendImpl->getCursorFormats() :
+                          !swapchain->formats.empty() ? swapchain->formats :
+                                                        swapchain->backendImpl->getRenderFormats();
     const auto            RENDERABLE = swapchain->backendImpl->getRenderableFormats();
 
     std::vector<uint64_t> explicitModifiers;
@@ -76,11 +78,11 @@ Aquamarine::CGBMBuffer::CGBMBuffer(const SAllocatorBufferParams& params, Hypruti
     if (attrs.format == DRM_FORMAT_INVALID) {
         attrs.format = guessFormatFrom(FORMATS, CURSOR).drmFormat;
         if (attrs.format != DRM_FORMAT_INVALID)
-            allocator->backend->log(AQ_LOG_DEBUG, std::format("GBM: Automatically selected format {} for new GBM buffer", fourccToName(attrs.format)));
+            AQLOG(allocator->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_ALLOCATOR, std::format("GBM: Automatically selected format {} for new GBM buffer", fourccToName(attrs.format)));
     }
 
     if (attrs.format == DRM_FORMAT_INVALID) {
-        allocator->backend->log(AQ_LOG_ERROR, "GBM: Failed to allocate a GBM buffer: no format found");
+        AQLOG(allocator->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "GBM: Failed to allocate a GBM buffer: no format found");
         return;
     }
 
@@ -99,12 +101,13 @@ Aquamarine::CGBMBuffer::CGBMBuffer(const SAllocatorBufferParams& params, Hypruti
                 auto rformat = std::find_if(RENDERABLE.begin(), RENDERABLE.end(), [f](const auto& e) { return e.drmFormat == f.drmFormat; });
 
                 if (rformat == RENDERABLE.end()) {
-                    TRACE(allocator->backend->log(AQ_LOG_TRACE, std::format("GBM: Dropping format {} as it's not renderable", fourccToName(f.drmFormat))));
+                    TRACE(AQLOG(allocator->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_ALLOCATOR,
+                                std::format("GBM: Dropping format {} as it's not renderable", fourccToName(f.drmFormat))));
                     break;
                 }
 
                 if (std::find(rformat->modifiers.begin(), rformat->modifiers.end(), m) == rformat->modifiers.end()) {
-                    TRACE(allocator->backend->log(AQ_LOG_TRACE, std::format("GBM: Dropping modifier 0x{:x} as it's not renderable", m)));
+                    TRACE(AQLOG(allocator->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_ALLOCATOR, std::format("GBM: Dropping modifier 0x{:x} as it's not renderable", m)));
                     continue;
                 }
             }
@@ -115,7 +118,7 @@ Aquamarine::CGBMBuffer::CGBMBuffer(const SAllocatorBufferParams& params, Hypruti
 
     // FIXME: Nvidia cannot render to linear buffers. What do?
     if (MULTIGPU) {
-        allocator->backend->log(AQ_LOG_DEBUG, "GBM: Buffer is marked as multigpu, forcing linear");
+        AQLOG(allocator->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_ALLOCATOR, "GBM: Buffer is marked as multigpu, forcing linear");
         explicitModifiers = {DRM_FORMAT_MOD_LINEAR};
     }
 
@@ -129,33 +132,33 @@ Aquamarine::CGBMBuffer::CGBMBuffer(const SAllocatorBufferParams& params, Hypruti
         flags |= GBM_BO_USE_SCANOUT;
 
     if (explicitModifiers.empty()) {
-        allocator->backend->log(AQ_LOG_WARNING, "GBM: Using modifier-less allocation");
+        AQLOG(allocator->backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_ALLOCATOR, "GBM: Using modifier-less allocation");
         bo = gbm_bo_create(allocator->gbmDevice, attrs.size.x, attrs.size.y, attrs.format, flags);
     } else {
-        TRACE(allocator->backend->log(AQ_LOG_TRACE, std::format("GBM: Using modifier-based allocation, modifiers: {}", explicitModifiers.size())));
+        TRACE(AQLOG(allocator->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_ALLOCATOR, std::format("GBM: Using modifier-based allocation, modifiers: {}", explicitModifiers.size())));
         for (auto& mod : explicitModifiers) {
-            TRACE(allocator->backend->log(AQ_LOG_TRACE, std::format("GBM: | mod 0x{:x}", mod)));
+            TRACE(AQLOG(allocator->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_ALLOCATOR, std::format("GBM: | mod 0x{:x}", mod)));
         }
         bo = gbm_bo_create_with_modifiers2(allocator->gbmDevice, attrs.size.x, attrs.size.y, attrs.format, explicitModifiers.data(), explicitModifiers.size(), flags);
 
         if (!bo && CURSOR) {
             // allow non-renderable cursor buffer for nvidia
-            allocator->backend->log(AQ_LOG_ERROR, "GBM: Allocating with modifiers and flags failed, falling back to modifiers without flags");
+            AQLOG(allocator->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "GBM: Allocating with modifiers and flags failed, falling back to modifiers without flags");
             bo = gbm_bo_create_with_modifiers(allocator->gbmDevice, attrs.size.x, attrs.size.y, attrs.format, explicitModifiers.data(), explicitModifiers.size());
         }
 
         if (!bo) {
             if (explicitModifiers.size() == 1 && explicitModifiers[0] == DRM_FORMAT_MOD_LINEAR) {
                 flags |= GBM_BO_USE_LINEAR;
-                allocator->backend->log(AQ_LOG_ERROR, "GBM: Allocating with modifiers failed, falling back to modifier-less allocation");
+                AQLOG(allocator->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "GBM: Allocating with modifiers failed, falling back to modifier-less allocation");
             } else
-                allocator->backend->log(AQ_LOG_ERROR, "GBM: Allocating with modifiers failed, falling back to implicit");
+                AQLOG(allocator->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "GBM: Allocating with modifiers failed, falling back to implicit");
             bo = gbm_bo_create(allocator->gbmDevice, attrs.size.x, attrs.size.y, attrs.format, flags);
         }
     }
 
     if (!bo) {
-        allocator->backend->log(AQ_LOG_ERROR, "GBM: Failed to allocate a GBM buffer: bo null");
+        AQLOG(allocator->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "GBM: Failed to allocate a GBM buffer: bo null");
         return;
     }
 
@@ -168,7 +171,7 @@ Aquamarine::CGBMBuffer::CGBMBuffer(const SAllocatorBufferParams& params, Hypruti
         attrs.fds.at(i)     = gbm_bo_get_fd_for_plane(bo, i);
 
         if (attrs.fds.at(i) < 0) {
-            allocator->backend->log(AQ_LOG_ERROR, std::format("GBM: Failed to query fd for plane {}", i));
+            AQLOG(allocator->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, std::format("GBM: Failed to query fd for plane {}", i));
             for (size_t j = 0; j < i; ++j) {
                 close(attrs.fds.at(j));
             }
@@ -181,9 +184,9 @@ Aquamarine::CGBMBuffer::CGBMBuffer(const SAllocatorBufferParams& params, Hypruti
 
     auto modName = drmGetFormatModifierName(attrs.modifier);
 
-    allocator->backend->log(AQ_LOG_DEBUG,
-                            std::format("GBM: Allocated a new buffer with size {} and format {} with modifier {} aka {}", attrs.size, fourccToName(attrs.format), attrs.modifier,
-                                        modName ? modName : "Unknown"));
+    AQLOG(allocator->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_ALLOCATOR,
+          std::format("GBM: Allocated a new buffer with size {} and format {} with modifier {} aka {}", attrs.size, fourccToName(attrs.format), attrs.modifier,
+                      modName ? modName : "Unknown"));
 
     free(modName);
 }
@@ -226,7 +229,7 @@ SDMABUFAttrs Aquamarine::CGBMBuffer::dmabuf() {
 std::tuple<uint8_t*, uint32_t, size_t> Aquamarine::CGBMBuffer::beginDataPtr(uint32_t flags) {
     uint32_t dst_stride = 0;
     if (boBuffer)
-        allocator->backend->log(AQ_LOG_ERROR, "beginDataPtr is called a second time without calling endDataPtr first. Returning old mapping");
+        AQLOG(allocator->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "beginDataPtr is called a second time without calling endDataPtr first. Returning old mapping");
     else
         boBuffer = gbm_bo_map(bo, 0, 0, attrs.size.x, attrs.size.y, flags, &dst_stride, &gboMapping);
     // FIXME: assumes a 32-bit pixel format
@@ -249,18 +252,18 @@ CGBMAllocator::~CGBMAllocator() {
 SP<CGBMAllocator> Aquamarine::CGBMAllocator::create(int drmfd_, Hyprutils::Memory::CWeakPointer<CBackend> backend_) {
     uint64_t capabilities = 0;
     if (drmGetCap(drmfd_, DRM_CAP_PRIME, &capabilities) || !(capabilities & DRM_PRIME_CAP_EXPORT)) {
-        backend_->log(AQ_LOG_ERROR, "Cannot create a GBM Allocator: PRIME export is not supported by the gpu.");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "Cannot create a GBM Allocator: PRIME export is not supported by the gpu.");
         return nullptr;
     }
 
     auto allocator = SP<CGBMAllocator>(new CGBMAllocator(drmfd_, backend_));
 
     if (!allocator->gbmDevice) {
-        backend_->log(AQ_LOG_ERROR, "Cannot create a GBM Allocator: gbm failed to create a device.");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "Cannot create a GBM Allocator: gbm failed to create a device.");
         return nullptr;
     }
 
-    backend_->log(AQ_LOG_DEBUG, std::format("Created a GBM allocator with drm fd {}", drmfd_));
+    AQLOG(backend_, AQ_LOG_DEBUG, AQ_SUBSYSTEM_ALLOCATOR, std::format("Created a GBM allocator with drm fd {}", drmfd_));
 
     allocator->self = allocator;
 
@@ -270,7 +273,7 @@ SP<CGBMAllocator> Aquamarine::CGBMAllocator::create(int drmfd_, Hyprutils::Memor
 Aquamarine::CGBMAllocator::CGBMAllocator(int fd_, Hyprutils::Memory::CWeakPointer<CBackend> backend_) : fd(fd_), backend(backend_) {
     gbmDevice = gbm_create_device(fd_);
     if (!gbmDevice) {
-        backend->log(AQ_LOG_ERROR, std::format("Couldn't open a GBM device at fd {}", fd_));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, std::format("Couldn't open a GBM device at fd {}", fd_));
         return;
     }
 
@@ -282,14 +285,14 @@ Aquamarine::CGBMAllocator::CGBMAllocator(int fd_, Hyprutils::Memory::CWeakPointe
 
 SP<IBuffer> Aquamarine::CGBMAllocator::acquire(const SAllocatorBufferParams& params, Hyprutils::Memory::CSharedPointer<CSwapchain> swapchain_) {
     if (params.size.x < 1 || params.size.y < 1) {
-        backend->log(AQ_LOG_ERROR, std::format("Couldn't allocate a gbm buffer with invalid size {}", params.size));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, std::format("Couldn't allocate a gbm buffer with invalid size {}", params.size));
         return nullptr;
     }
 
     auto newBuffer = SP<CGBMBuffer>(new CGBMBuffer(params, self, swapchain_));
 
     if (!newBuffer->good()) {
-        backend->log(AQ_LOG_ERROR, std::format("Couldn't allocate a gbm buffer with size {} and format {}", params.size, fourccToName(params.format)));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, std::format("Couldn't allocate a gbm buffer with size {} and format {}", params.size, fourccToName(params.format)));
         return nullptr;
     }
 
@@ -1,6 +1,7 @@
 #include <aquamarine/allocator/Swapchain.hpp>
 #include <aquamarine/backend/Backend.hpp>
 #include "FormatUtils.hpp"
+#include "Shared.hpp"
 
 using namespace Aquamarine;
 using namespace Hyprutils::Memory;
@@ -24,23 +25,28 @@ bool Aquamarine::CSwapchain::reconfigure(const SSwapchainOptions& options_) {
 
     if (options_.size == Vector2D{} || options_.length == 0) {
         // clear the swapchain
-        allocator->getBackend()->log(AQ_LOG_DEBUG, "Swapchain: Clearing");
+        AQLOG(allocator->getBackend(), AQ_LOG_DEBUG, AQ_SUBSYSTEM_ALLOCATOR, "Swapchain: Clearing");
         buffers.clear();
         options = options_;
         return true;
     }
 
-    if ((options_.format == options.format || options_.format == DRM_FORMAT_INVALID) && options_.size == options.size && options_.length == options.length)
+    const bool SAME = !reallocate && (options_.format == options.format || options_.format == DRM_FORMAT_INVALID) && options_.size == options.size;
+
+    if (SAME && options_.length == options.length) {
+        options.skipLocked = options_.skipLocked;
         return true; // no need to reconfigure
+    }
 
-    if ((options_.format == options.format || options_.format == DRM_FORMAT_INVALID) && options_.size == options.size) {
+    if (SAME) {
         bool ok = resize(options_.length);
         if (!ok)
             return false;
 
         options = options_;
 
-        allocator->getBackend()->log(AQ_LOG_DEBUG, std::format("Swapchain: Resized a {} {} swapchain to length {}", options.size, fourccToName(options.format), options.length));
+        AQLOG(allocator->getBackend(), AQ_LOG_DEBUG, AQ_SUBSYSTEM_ALLOCATOR,
+              std::format("Swapchain: Resized a {} {} swapchain to length {}", options.size, fourccToName(options.format), options.length));
         return true;
     }
 
@@ -48,20 +54,44 @@ bool Aquamarine::CSwapchain::reconfigure(const SSwapchainOptions& options_) {
     if (!ok)
         return false;
 
-    options = options_;
+    reallocate = false;
+    options    = options_;
     if (options.format == DRM_FORMAT_INVALID)
         options.format = buffers.at(0)->dmabuf().format;
 
-    allocator->getBackend()->log(AQ_LOG_DEBUG,
-                                 std::format("Swapchain: Reconfigured a swapchain to {} {} of length {}", options.size, fourccToName(options.format), options.length));
+    AQLOG(allocator->getBackend(), AQ_LOG_DEBUG, AQ_SUBSYSTEM_ALLOCATOR,
+          std::format("Swapchain: Reconfigured a swapchain to {} {} of length {}", options.size, fourccToName(options.format), options.length));
     return true;
 }
 
+void Aquamarine::CSwapchain::setFormats(const std::vector<SDRMFormat>& formats_) {
+    formats    = formats_;
+    reallocate = true;
+}
+
 SP<IBuffer> Aquamarine::CSwapchain::next(int* age) {
     if (!allocator || options.length <= 0)
         return nullptr;
 
-    lastAcquired = (lastAcquired + 1) % options.length;
+    int idx = (lastAcquired + 1) % options.length;
+
+    if (options.skipLocked) {
+        // skip buffers the backend still holds, e.g. ones a nested host hasn't released yet. Never hand out a held one.
+        idx = -1;
+        for (int i = 0; i < (int)options.length; ++i) {
+            const int CANDIDATE = (lastAcquired + 1 + i) % options.length;
+            if (!buffers.at(CANDIDATE)->lockedByBackend) {
+                idx = CANDIDATE;
+                break;
+            }
+        }
+
+        if (idx < 0)
+            return nullptr;
+    }
+
+    previousAcquired = lastAcquired;
+    lastAcquired     = idx;
 
     if (age)
         *age = 1;
@@ -76,7 +106,7 @@ bool Aquamarine::CSwapchain::fullReconfigure(const SSwapchainOptions& options_)
             SAllocatorBufferParams{.size = options_.size, .format = options_.format, .scanout = options_.scanout, .cursor = options_.cursor, .multigpu = options_.multigpu},
             self.lock());
         if (!buf) {
-            allocator->getBackend()->log(AQ_LOG_ERROR, "Swapchain: Failed acquiring a buffer");
+            AQLOG(allocator->getBackend(), AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "Swapchain: Failed acquiring a buffer");
             return false;
         }
         buffers.emplace_back(buf);
@@ -98,7 +128,7 @@ bool Aquamarine::CSwapchain::resize(size_t newSize) {
             auto buf =
                 allocator->acquire(SAllocatorBufferParams{.size = options.size, .format = options.format, .scanout = options.scanout, .cursor = options.cursor}, self.lock());
             if (!buf) {
-                allocator->getBackend()->log(AQ_LOG_ERROR, "Swapchain: Failed acquiring a buffer");
+                AQLOG(allocator->getBackend(), AQ_LOG_ERROR, AQ_SUBSYSTEM_ALLOCATOR, "Swapchain: Failed acquiring a buffer");
                 return false;
             }
             buffers.emplace_back(buf);
@@ -117,9 +147,8 @@ const SSwapchainOptions& Aquamarine::CSwapchain::currentOptions() {
 }
 
 void Aquamarine::CSwapchain::rollback() {
-    lastAcquired--;
-    if (lastAcquired < 0)
-        lastAcquired = options.length - 1;
+    // with skipLocked, next() may have moved by more than one
+    lastAcquired = previousAcquired;
 }
 
 SP<IAllocator> Aquamarine::CSwapchain::getAllocator() {
@@ -6,32 +6,21 @@
 #include <sys/poll.h>
 #include <thread>
 #include <chrono>
+#include <array>
+#include <sys/eventfd.h>
 #include <sys/timerfd.h>
+#include <sys/epoll.h>
 #include <time.h>
 #include <string.h>
 #include <xf86drm.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include "Shared.hpp"
 
 using namespace Hyprutils::Memory;
 using namespace Aquamarine;
 #define SP CSharedPointer
 
-#define TIMESPEC_NSEC_PER_SEC 1000000000L
-
-static void timespecAddNs(timespec* pTimespec, int64_t delta) {
-    int delta_ns_low = delta % TIMESPEC_NSEC_PER_SEC;
-    int delta_s_high = delta / TIMESPEC_NSEC_PER_SEC;
-
-    pTimespec->tv_sec += delta_s_high;
-
-    pTimespec->tv_nsec += (long)delta_ns_low;
-    if (pTimespec->tv_nsec >= TIMESPEC_NSEC_PER_SEC) {
-        pTimespec->tv_nsec -= TIMESPEC_NSEC_PER_SEC;
-        ++pTimespec->tv_sec;
-    }
-}
-
 static const char* backendTypeToName(eBackendType type) {
     switch (type) {
         case AQ_BACKEND_DRM: return "drm";
@@ -43,7 +32,7 @@ static const char* backendTypeToName(eBackendType type) {
 }
 
 Aquamarine::CBackend::CBackend() {
-    ;
+    logThresholds.fill(AQ_LOG_CRITICAL + 1);
 }
 
 Aquamarine::SBackendImplementationOptions::SBackendImplementationOptions() {
@@ -53,6 +42,10 @@ Aquamarine::SBackendImplementationOptions::SBackendImplementationOptions() {
 
 Aquamarine::SBackendOptions::SBackendOptions() {
     logFunction = nullptr;
+    logLevel    = isTrace() ? AQ_LOG_TRACE : AQ_LOG_DEBUG;
+    subsystemLogLevels.fill(AQ_LOG_TRACE);
+    coalesceInput = false;
+    batchInput    = false;
 }
 
 Hyprutils::Memory::CSharedPointer<CBackend> Aquamarine::CBackend::create(const std::vector<SBackendImplementationOptions>& backends, const SBackendOptions& options) {
@@ -62,10 +55,14 @@ Hyprutils::Memory::CSharedPointer<CBackend> Aquamarine::CBackend::create(const s
     backend->implementationOptions = backends;
     backend->self                  = backend;
 
+    for (size_t i = 0; i < AQ_SUBSYSTEM_COUNT; ++i) {
+        backend->logThresholds[i] = options.logFunction ? std::max(options.logLevel, options.subsystemLogLevels[i]) : AQ_LOG_CRITICAL + 1;
+    }
+
     if (backends.size() <= 0)
         return nullptr;
 
-    backend->log(AQ_LOG_DEBUG, "Creating an Aquamarine backend!");
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_CORE, "Creating an Aquamarine backend!");
 
     for (auto& b : backends) {
         if (b.backendType == AQ_BACKEND_WAYLAND) {
@@ -75,7 +72,7 @@ Hyprutils::Memory::CSharedPointer<CBackend> Aquamarine::CBackend::create(const s
         } else if (b.backendType == AQ_BACKEND_DRM) {
             auto ref = CDRMBackend::attempt(backend);
             if (ref.empty()) {
-                backend->log(AQ_LOG_ERROR, "DRM Backend failed");
+                AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, "DRM Backend failed");
                 continue;
             }
 
@@ -87,27 +84,52 @@ Hyprutils::Memory::CSharedPointer<CBackend> Aquamarine::CBackend::create(const s
             backend->implementations.emplace_back(ref);
             ref->self = ref;
         } else {
-            backend->log(AQ_LOG_ERROR, std::format("Unknown backend id: {}", (int)b.backendType));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("Unknown backend id: {}", (int)b.backendType));
             continue;
         }
     }
 
-    // create a timerfd for idle events
-    backend->idle.fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    // create an eventfd for idle events
+    backend->idle.fd     = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    backend->idle.pollFD = makeShared<SPollFD>(backend->idle.fd, [b = backend.get()]() { b->dispatchIdle(); });
+
+    // an eventfd for cross-thread tasks
+    backend->m_sEventLoopInternals.taskFD     = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    backend->m_sEventLoopInternals.taskPollFD = makeShared<SPollFD>(backend->m_sEventLoopInternals.taskFD, [b = backend.get()]() { b->dispatchTasks(); });
+
+    // and a timerfd for all timers
+    backend->timers.fd     = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    backend->timers.pollFD = makeShared<SPollFD>(backend->timers.fd, [b = backend.get()]() { b->dispatchTimers(); });
 
     return backend;
 }
 
 Aquamarine::CBackend::~CBackend() {
-    ;
+    if (m_sEventLoopInternals.epollFD >= 0)
+        close(m_sEventLoopInternals.epollFD);
+    if (timers.fd >= 0)
+        close(timers.fd);
+    if (idle.fd >= 0)
+        close(idle.fd);
+    if (m_sEventLoopInternals.taskFD >= 0)
+        close(m_sEventLoopInternals.taskFD);
+
+    auto node = m_sEventLoopInternals.tasks.exchange(nullptr);
+    while (node) {
+        auto next = node->next;
+        delete node;
+        node = next;
+    }
 }
 
 bool Aquamarine::CBackend::start() {
-    log(AQ_LOG_DEBUG, "Starting the Aquamarine backend!");
+    AQLOG(this, AQ_LOG_DEBUG, AQ_SUBSYSTEM_CORE, "Starting the Aquamarine backend!");
 
     bool fallback = false;
     int  started  = 0;
 
+    std::vector<SP<IBackendImplementation>> failed;
+
     auto optionsForType = [this](eBackendType type) -> SBackendImplementationOptions {
         for (auto& o : implementationOptions) {
             if (o.backendType == type)
@@ -120,10 +142,13 @@ bool Aquamarine::CBackend::start() {
         const bool ok = implementations.at(i)->start();
 
         if (!ok) {
-            log(AQ_LOG_ERROR, std::format("Requested backend ({}) could not start, enabling fallbacks", backendTypeToName(implementations.at(i)->type())));
+            AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE,
+                  std::format("Requested backend ({}) could not start, enabling fallbacks", backendTypeToName(implementations.at(i)->type())));
             fallback = true;
+            failed.emplace_back(implementations.at(i));
             if (optionsForType(implementations.at(i)->type()).backendRequestMode == AQ_BACKEND_REQUEST_MANDATORY) {
-                log(AQ_LOG_CRITICAL, std::format("Requested backend ({}) could not start and it's mandatory, cannot continue!", backendTypeToName(implementations.at(i)->type())));
+                AQLOG(this, AQ_LOG_CRITICAL, AQ_SUBSYSTEM_CORE,
+                      std::format("Requested backend ({}) could not start and it's mandatory, cannot continue!", backendTypeToName(implementations.at(i)->type())));
                 implementations.clear();
                 return false;
             }
@@ -132,16 +157,17 @@ bool Aquamarine::CBackend::start() {
     }
 
     if (implementations.empty() || started <= 0) {
-        log(AQ_LOG_CRITICAL, "No backend could be opened. Make sure there was a correct backend passed to CBackend, and that your environment supports at least one of them.");
+        AQLOG(this, AQ_LOG_CRITICAL, AQ_SUBSYSTEM_CORE,
+              "No backend could be opened. Make sure there was a correct backend passed to CBackend, and that your environment supports at least one of them.");
         return false;
     }
 
     // erase failed impls
-    std::erase_if(implementations, [this](const auto& i) {
-        bool failed = i->pollFDs().empty();
-        if (failed)
-            log(AQ_LOG_ERROR, std::format("Implementation {} failed, erasing.", backendTypeToName(i->type())));
-        return failed;
+    std::erase_if(implementations, [this, &failed](const auto& i) {
+        bool erase = std::find(failed.begin(), failed.end(), i) != failed.end();
+        if (erase)
+            AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("Implementation {} failed, erasing.", backendTypeToName(i->type())));
+        return erase;
     });
 
     // TODO: obviously change this when (if) we add different allocators.
@@ -150,7 +176,7 @@ bool Aquamarine::CBackend::start() {
             auto fd = reopenDRMNode(b->drmFD());
             if (fd < 0) {
                 // this is critical, we cannot create an allocator properly
-                log(AQ_LOG_CRITICAL, "Failed to create an allocator (reopenDRMNode failed)");
+                AQLOG(this, AQ_LOG_CRITICAL, AQ_SUBSYSTEM_CORE, "Failed to create an allocator (reopenDRMNode failed)");
                 return false;
             }
             primaryAllocator = CGBMAllocator::create(fd, self);
@@ -172,7 +198,11 @@ bool Aquamarine::CBackend::start() {
 }
 
 void Aquamarine::CBackend::log(eBackendLogLevel level, const std::string& msg) {
-    if (!options.logFunction)
+    log(level, AQ_SUBSYSTEM_CORE, msg);
+}
+
+void Aquamarine::CBackend::log(eBackendLogLevel level, eBackendLogSubsystem subsystem, const std::string& msg) {
+    if (!shouldLog(level, subsystem))
         return;
 
     options.logFunction(level, msg);
@@ -183,22 +213,207 @@ std::vector<Hyprutils::Memory::CSharedPointer<SPollFD>> Aquamarine::CBackend::ge
     for (auto& i : implementations) {
         auto pollfds = i->pollFDs();
         for (auto& p : pollfds) {
-            log(AQ_LOG_DEBUG, std::format("backend: poll fd {} for implementation {}", p->fd, backendTypeToName(i->type())));
+            TRACE(AQLOG(this, AQ_LOG_TRACE, AQ_SUBSYSTEM_CORE, std::format("backend: poll fd {} for implementation {}", p->fd, backendTypeToName(i->type()))));
             result.emplace_back(p);
         }
     }
 
     for (auto& sfd : sessionFDs) {
-        log(AQ_LOG_DEBUG, std::format("backend: poll fd {} for session", sfd->fd));
+        TRACE(AQLOG(this, AQ_LOG_TRACE, AQ_SUBSYSTEM_CORE, std::format("backend: poll fd {} for session", sfd->fd)));
         result.emplace_back(sfd);
     }
 
-    log(AQ_LOG_DEBUG, std::format("backend: poll fd {} for idle", idle.fd));
-    result.emplace_back(makeShared<SPollFD>(idle.fd, [this]() { dispatchIdle(); }));
+    TRACE(AQLOG(this, AQ_LOG_TRACE, AQ_SUBSYSTEM_CORE, std::format("backend: poll fd {} for idle", idle.fd)));
+    result.emplace_back(idle.pollFD);
+
+    TRACE(AQLOG(this, AQ_LOG_TRACE, AQ_SUBSYSTEM_CORE, std::format("backend: poll fd {} for timers", timers.fd)));
+    result.emplace_back(timers.pollFD);
+
+    TRACE(AQLOG(this, AQ_LOG_TRACE, AQ_SUBSYSTEM_CORE, std::format("backend: poll fd {} for tasks", m_sEventLoopInternals.taskFD)));
+    result.emplace_back(m_sEventLoopInternals.taskPollFD);
 
     return result;
 }
 
+void Aquamarine::CBackend::addPollFD(SP<SPollFD> pfd) {
+    {
+        std::lock_guard<std::mutex> lg(m_sEventLoopInternals.loopRequestMutex);
+        m_sEventLoopInternals.userFDs.emplace_back(pfd);
+    }
+
+    updatePollFDs();
+}
+
+void Aquamarine::CBackend::removePollFD(SP<SPollFD> pfd) {
+    {
+        std::lock_guard<std::mutex> lg(m_sEventLoopInternals.loopRequestMutex);
+        std::erase(m_sEventLoopInternals.userFDs, pfd);
+    }
+
+    updatePollFDs();
+}
+
+void Aquamarine::CBackend::updatePollFDs() {
+    // applied by the loop before it waits again, so this is safe to call from anywhere
+    m_sEventLoopInternals.pollFDsDirty = true;
+    wakeLoop();
+}
+
+void Aquamarine::CBackend::registerPollFDs() {
+    auto wanted = getPollFDs();
+
+    {
+        std::lock_guard<std::mutex> lg(m_sEventLoopInternals.loopRequestMutex);
+        wanted.insert(wanted.end(), m_sEventLoopInternals.userFDs.begin(), m_sEventLoopInternals.userFDs.end());
+    }
+
+    std::unordered_map<int, SP<SPollFD>> next;
+    for (auto& w : wanted) {
+        if (w && w->fd >= 0)
+            next[w->fd] = w;
+    }
+
+    auto& registered = m_sEventLoopInternals.registered;
+
+    for (auto it = registered.begin(); it != registered.end();) {
+        if (next.contains(it->first)) {
+            ++it;
+            continue;
+        }
+
+        // may fail if the fd was already closed, which removes it from epoll anyways
+        epoll_ctl(m_sEventLoopInternals.epollFD, EPOLL_CTL_DEL, it->first, nullptr);
+        TRACE(AQLOG(this, AQ_LOG_TRACE, AQ_SUBSYSTEM_CORE, std::format("backend: loop: unregistered fd {}", it->first)));
+        it = registered.erase(it);
+    }
+
+    for (auto& [fd, pfd] : next) {
+        if (registered.contains(fd)) {
+            // same fd, refresh the callback only
+            registered[fd] = pfd;
+            continue;
+        }
+
+        epoll_event ev = {.events = EPOLLIN, .data = {.fd = fd}};
+        if (epoll_ctl(m_sEventLoopInternals.epollFD, EPOLL_CTL_ADD, fd, &ev) < 0 && (errno != EEXIST || epoll_ctl(m_sEventLoopInternals.epollFD, EPOLL_CTL_MOD, fd, &ev) < 0)) {
+            AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("backend: loop: failed to register fd {}: {}", fd, strerror(errno)));
+            continue;
+        }
+
+        TRACE(AQLOG(this, AQ_LOG_TRACE, AQ_SUBSYSTEM_CORE, std::format("backend: loop: registered fd {}", fd)));
+        registered[fd] = pfd;
+    }
+}
+
+bool Aquamarine::CBackend::enterLoop() {
+    if (m_sEventLoopInternals.epollFD < 0) {
+        m_sEventLoopInternals.epollFD = epoll_create1(EPOLL_CLOEXEC);
+        if (m_sEventLoopInternals.epollFD < 0) {
+            AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("backend: loop: epoll_create1 failed: {}", strerror(errno)));
+            return false;
+        }
+    }
+
+    AQLOG(this, AQ_LOG_DEBUG, AQ_SUBSYSTEM_CORE, "backend: entering the event loop");
+
+    m_sEventLoopInternals.pollFDsDirty = true;
+
+    std::array<epoll_event, 64> events;
+
+    // always dispatch one batch, an exitLoop() from before entering returns after it
+    do {
+        if (m_sEventLoopInternals.pollFDsDirty.exchange(false))
+            registerPollFDs();
+
+        int n = epoll_wait(m_sEventLoopInternals.epollFD, events.data(), events.size(), -1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+
+            AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("backend: loop: epoll_wait failed: {}", strerror(errno)));
+            terminate = false;
+            return false;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            auto it = m_sEventLoopInternals.registered.find(events[i].data.fd);
+            if (it == m_sEventLoopInternals.registered.end())
+                continue; // removed by an earlier callback in this batch
+
+            // keep a ref, the callback might unregister itself
+            auto pfd = it->second;
+            if (pfd->onSignal)
+                pfd->onSignal();
+        }
+    } while (!terminate);
+
+    AQLOG(this, AQ_LOG_DEBUG, AQ_SUBSYSTEM_CORE, "backend: exiting the event loop");
+
+    // reset on the way out, an exitLoop() from before entering still has to apply
+    terminate = false;
+
+    return true;
+}
+
+void Aquamarine::CBackend::exitLoop() {
+    terminate = true;
+    wakeLoop();
+}
+
+void Aquamarine::CBackend::wakeLoop() {
+    // one write per dispatch is enough, the rest is coalesced
+    if (m_sEventLoopInternals.shouldProcess.exchange(true))
+        return;
+
+    uint64_t one = 1;
+    if (write(m_sEventLoopInternals.taskFD, &one, sizeof(one)) != sizeof(one)) {
+        // this may be any thread, the consumer's log function only ever runs on the loop's. Let the next post try again.
+        m_sEventLoopInternals.wakeErrno     = errno;
+        m_sEventLoopInternals.shouldProcess = false;
+    }
+}
+
+void Aquamarine::CBackend::postToLoop(std::function<void(void)> task) {
+    auto node  = new STaskNode{.task = std::move(task)};
+    node->next = m_sEventLoopInternals.tasks.load(std::memory_order_relaxed);
+    while (!m_sEventLoopInternals.tasks.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        ;
+    }
+
+    wakeLoop();
+}
+
+void Aquamarine::CBackend::dispatchTasks() {
+    uint64_t count = 0;
+    if (read(m_sEventLoopInternals.taskFD, &count, sizeof(count)) < 0 && errno != EAGAIN)
+        AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("backend: failed to read the task eventfd: {}", strerror(errno)));
+
+    if (const int ERR = m_sEventLoopInternals.wakeErrno.exchange(0); ERR)
+        AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("backend: failed to signal the task eventfd: {}", strerror(ERR)));
+
+    // clear before taking the tasks, so anything posted from now on signals again
+    m_sEventLoopInternals.shouldProcess = false;
+
+    auto       node    = m_sEventLoopInternals.tasks.exchange(nullptr, std::memory_order_acquire);
+    STaskNode* ordered = nullptr;
+
+    // reverse into posting order
+    while (node) {
+        auto next  = node->next;
+        node->next = ordered;
+        ordered    = node;
+        node       = next;
+    }
+
+    while (ordered) {
+        auto next = ordered->next;
+        if (ordered->task)
+            ordered->task();
+        delete ordered;
+        ordered = next;
+    }
+}
+
 int Aquamarine::CBackend::drmFD() {
     for (auto& i : implementations) {
         int fd = i->drmFD();
@@ -234,38 +449,146 @@ const std::vector<SP<IBackendImplementation>>& Aquamarine::CBackend::getImplemen
 }
 
 void Aquamarine::CBackend::addIdleEvent(SP<std::function<void(void)>> fn) {
-    auto r = idle.pending.emplace_back(fn);
-
-    updateIdleTimer();
-}
-
-void Aquamarine::CBackend::updateIdleTimer() {
-    uint64_t ADD_NS = idle.pending.empty() ? TIMESPEC_NSEC_PER_SEC * 240ULL /* 240s, 4 mins */ : 0;
+    if (!fn || !idle.queued.emplace(fn.get()).second)
+        return;
 
-    timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    timespecAddNs(&now, ADD_NS);
+    idle.pending.emplace_back(fn);
 
-    itimerspec ts = {.it_value = now};
+    // only wake up on empty -> non-empty, the eventfd stays readable until we dispatch
+    if (idle.pending.size() > 1)
+        return;
 
-    if (timerfd_settime(idle.fd, TFD_TIMER_ABSTIME, &ts, nullptr))
-        log(AQ_LOG_ERROR, std::format("backend: failed to arm timerfd: {}", strerror(errno)));
+    uint64_t one = 1;
+    if (write(idle.fd, &one, sizeof(one)) != sizeof(one))
+        AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("backend: failed to signal the idle eventfd: {}", strerror(errno)));
 }
 
 void Aquamarine::CBackend::removeIdleEvent(SP<std::function<void(void)>> pfn) {
-    std::erase(idle.pending, pfn);
+    // the entry in pending is skipped on dispatch
+    idle.queued.erase(pfn.get());
 }
 
 void Aquamarine::CBackend::dispatchIdle() {
-    auto cpy = idle.pending;
-    idle.pending.clear();
+    uint64_t count = 0;
+    if (read(idle.fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+        AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("backend: failed to read the idle eventfd: {}", strerror(errno)));
+
+    // anything queued by the callbacks lands in pending again and re-signals the fd
+    std::swap(idle.pending, idle.dispatching);
 
-    for (auto& i : cpy) {
-        if (i && *i)
+    for (auto& i : idle.dispatching) {
+        if (!idle.queued.erase(i.get()))
+            continue; // removed, or a duplicate from a remove + re-add
+
+        if (*i)
             (*i)();
     }
 
-    updateIdleTimer();
+    idle.dispatching.clear();
+}
+
+Aquamarine::CBackendTimer::CBackendTimer(std::function<void(void)> what_) : what(what_) {
+    ;
+}
+
+bool Aquamarine::CBackendTimer::armed() {
+    return isArmed;
+}
+
+SP<CBackendTimer> Aquamarine::CBackend::addTimer(std::chrono::steady_clock::duration timeout, std::function<void(void)> cb) {
+    auto timer = makeShared<CBackendTimer>(cb);
+    rescheduleTimer(timer, timeout);
+    return timer;
+}
+
+void Aquamarine::CBackend::cancelTimer(SP<CBackendTimer> timer) {
+    if (!timer || !timer->isArmed)
+        return;
+
+    // the heap entry goes stale, it's dropped once it reaches the top
+    timer->isArmed = false;
+    timer->generation++;
+
+    updateTimerFD();
+}
+
+void Aquamarine::CBackend::rescheduleTimer(SP<CBackendTimer> timer, std::chrono::steady_clock::duration timeout) {
+    if (!timer)
+        return;
+
+    timer->when    = std::chrono::steady_clock::now() + timeout;
+    timer->isArmed = true;
+    timer->generation++;
+
+    timers.heap.emplace_back(STimerEntry{timer->when, timer->generation, timer});
+    std::push_heap(timers.heap.begin(), timers.heap.end(), [](const auto& a, const auto& b) { return a.when > b.when; });
+
+    updateTimerFD();
+}
+
+void Aquamarine::CBackend::updateTimerFD() {
+    const auto CMP = [](const auto& a, const auto& b) { return a.when > b.when; };
+
+    // drop stale entries so we don't wake up for nothing
+    while (!timers.heap.empty() && timers.heap.front().generation != timers.heap.front().timer->generation) {
+        std::pop_heap(timers.heap.begin(), timers.heap.end(), CMP);
+        timers.heap.pop_back();
+    }
+
+    const auto NEXT = timers.heap.empty() ? std::chrono::steady_clock::time_point::max() : timers.heap.front().when;
+
+    if (NEXT == timers.armedFor)
+        return;
+
+    timers.armedFor = NEXT;
+
+    // steady_clock is CLOCK_MONOTONIC, a zero it_value disarms
+    itimerspec ts = {};
+    if (NEXT != std::chrono::steady_clock::time_point::max()) {
+        const auto NS       = std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(NEXT.time_since_epoch()).count(), 1);
+        ts.it_value.tv_sec  = NS / 1000000000LL;
+        ts.it_value.tv_nsec = NS % 1000000000LL;
+    }
+
+    if (timerfd_settime(timers.fd, TFD_TIMER_ABSTIME, &ts, nullptr))
+        AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("backend: failed to arm timerfd: {}", strerror(errno)));
+}
+
+void Aquamarine::CBackend::dispatchTimers() {
+    const auto CMP = [](const auto& a, const auto& b) { return a.when > b.when; };
+
+    uint64_t count = 0;
+    if (read(timers.fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+        AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("backend: failed to read the timerfd: {}", strerror(errno)));
+
+    // the fd fired, so it's not armed anymore
+    timers.armedFor = std::chrono::steady_clock::time_point::max();
+
+    const auto NOW = std::chrono::steady_clock::now();
+
+    while (!timers.heap.empty() && timers.heap.front().when <= NOW) {
+        std::pop_heap(timers.heap.begin(), timers.heap.end(), CMP);
+        auto e = std::move(timers.heap.back());
+        timers.heap.pop_back();
+
+        if (e.generation != e.timer->generation)
+            continue;
+
+        e.timer->isArmed = false;
+        timers.expired.emplace_back(std::move(e));
+    }
+
+    for (auto& e : timers.expired) {
+        // a previous callback might've cancelled or rescheduled this one
+        if (e.generation != e.timer->generation || !e.timer->what)
+            continue;
+
+        e.timer->what();
+    }
+
+    timers.expired.clear();
+
+    updateTimerFD();
 }
 
 // Yoinked from wlroots, render/allocator/allocator.c
@@ -279,10 +602,10 @@ int Aquamarine::CBackend::reopenDRMNode(int drmFD, bool allowRenderNode) {
         if (leaseFD >= 0) {
             return leaseFD;
         } else if (leaseFD != -EINVAL && leaseFD != -EOPNOTSUPP) {
-            log(AQ_LOG_ERROR, "reopenDRMNode: drmModeCreateLease failed");
+            AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, "reopenDRMNode: drmModeCreateLease failed");
             return -1;
         }
-        log(AQ_LOG_DEBUG, "reopenDRMNode: drmModeCreateLease failed, falling back to open");
+        AQLOG(this, AQ_LOG_DEBUG, AQ_SUBSYSTEM_CORE, "reopenDRMNode: drmModeCreateLease failed, falling back to open");
     }
 
     char* name = nullptr;
@@ -294,16 +617,16 @@ int Aquamarine::CBackend::reopenDRMNode(int drmFD, bool allowRenderNode) {
         name = drmGetDeviceNameFromFd2(drmFD);
 
         if (!name) {
-            log(AQ_LOG_ERROR, "reopenDRMNode: drmGetDeviceNameFromFd2 failed");
+            AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, "reopenDRMNode: drmGetDeviceNameFromFd2 failed");
             return -1;
         }
     }
 
-    log(AQ_LOG_DEBUG, std::format("reopenDRMNode: opening node {}", name));
+    AQLOG(this, AQ_LOG_DEBUG, AQ_SUBSYSTEM_CORE, std::format("reopenDRMNode: opening node {}", name));
 
     int newFD = open(name, O_RDWR | O_CLOEXEC);
     if (newFD < 0) {
-        log(AQ_LOG_ERROR, std::format("reopenDRMNode: failed to open node {}", name));
+        AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("reopenDRMNode: failed to open node {}", name));
         free(name);
         return -1;
     }
@@ -314,13 +637,13 @@ int Aquamarine::CBackend::reopenDRMNode(int drmFD, bool allowRenderNode) {
     if (drmIsMaster(drmFD) && drmGetNodeTypeFromFd(newFD) == DRM_NODE_PRIMARY) {
         drm_magic_t magic;
         if (int ret = drmGetMagic(newFD, &magic); ret < 0) {
-            log(AQ_LOG_ERROR, std::format("reopenDRMNode: drmGetMagic failed: {}", strerror(-ret)));
+            AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("reopenDRMNode: drmGetMagic failed: {}", strerror(-ret)));
             close(newFD);
             return -1;
         }
 
         if (int ret = drmAuthMagic(drmFD, magic); ret < 0) {
-            log(AQ_LOG_ERROR, std::format("reopenDRMNode: drmAuthMagic failed: {}", strerror(-ret)));
+            AQLOG(this, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("reopenDRMNode: drmAuthMagic failed: {}", strerror(-ret)));
             close(newFD);
             return -1;
         }
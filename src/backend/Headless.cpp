@@ -1,7 +1,6 @@
 #include <aquamarine/backend/Headless.hpp>
 #include <fcntl.h>
 #include <time.h>
-#include <sys/timerfd.h>
 #include <string.h>
 #include "Shared.hpp"
 
@@ -10,32 +9,18 @@ using namespace Hyprutils::Memory;
 using namespace Hyprutils::Math;
 #define SP CSharedPointer
 
-#define TIMESPEC_NSEC_PER_SEC 1000000000L
-
-static void timespecAddNs(timespec* pTimespec, int64_t delta) {
-    int delta_ns_low = delta % TIMESPEC_NSEC_PER_SEC;
-    int delta_s_high = delta / TIMESPEC_NSEC_PER_SEC;
-
-    pTimespec->tv_sec += delta_s_high;
-
-    pTimespec->tv_nsec += (long)delta_ns_low;
-    if (pTimespec->tv_nsec >= TIMESPEC_NSEC_PER_SEC) {
-        pTimespec->tv_nsec -= TIMESPEC_NSEC_PER_SEC;
-        ++pTimespec->tv_sec;
-    }
-}
-
 Aquamarine::CHeadlessOutput::CHeadlessOutput(const std::string& name_, Hyprutils::Memory::CWeakPointer<CHeadlessBackend> backend_) : backend(backend_) {
     name = name_;
 
-    framecb = makeShared<std::function<void()>>([this]() {
+    frameTimer = makeShared<CBackendTimer>([this]() {
         frameScheduled = false;
+        lastFrame      = std::chrono::steady_clock::now();
         events.frame.emit();
     });
 }
 
 Aquamarine::CHeadlessOutput::~CHeadlessOutput() {
-    backend->backend->removeIdleEvent(framecb);
+    backend->backend->cancelTimer(frameTimer);
     events.destroy.emit();
 }
 
@@ -60,16 +45,25 @@ Hyprutils::Memory::CSharedPointer<IBackendImplementation> Aquamarine::CHeadlessO
 }
 
 void Aquamarine::CHeadlessOutput::scheduleFrame(const scheduleFrameReason reason) {
-    TRACE(backend->backend->log(AQ_LOG_TRACE,
-                                std::format("CHeadlessOutput::scheduleFrame: reason {}, needsFrame {}, frameScheduled {}", (uint32_t)reason, needsFrame, frameScheduled)));
-    // FIXME: limit fps to the committed framerate.
+    TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_CORE,
+                std::format("CHeadlessOutput::scheduleFrame: reason {}, needsFrame {}, frameScheduled {}", (uint32_t)reason, needsFrame, frameScheduled)));
     needsFrame = true;
 
     if (frameScheduled)
         return;
 
     frameScheduled = true;
-    backend->backend->addIdleEvent(framecb);
+
+    // pace frames to the committed refresh rate, if we have one
+    const auto& CURRENT = state->current();
+    const auto  MODE    = CURRENT.customMode ? CURRENT.customMode : CURRENT.mode.lock();
+    auto        timeout = std::chrono::steady_clock::duration::zero();
+    if (MODE && MODE->refreshRate > 0) {
+        const auto NEXT = lastFrame + std::chrono::nanoseconds(1000000000000LL / MODE->refreshRate);
+        timeout         = std::max(NEXT - std::chrono::steady_clock::now(), timeout);
+    }
+
+    backend->backend->rescheduleTimer(frameTimer, timeout);
 }
 
 bool Aquamarine::CHeadlessOutput::destroy() {
@@ -83,7 +77,7 @@ Aquamarine::CHeadlessBackend::~CHeadlessBackend() {
 }
 
 Aquamarine::CHeadlessBackend::CHeadlessBackend(SP<CBackend> backend_) : backend(backend_) {
-    timers.timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    ;
 }
 
 eBackendType Aquamarine::CHeadlessBackend::type() {
@@ -95,7 +89,7 @@ bool Aquamarine::CHeadlessBackend::start() {
 }
 
 std::vector<SP<SPollFD>> Aquamarine::CHeadlessBackend::pollFDs() {
-    return {makeShared<SPollFD>(timers.timerfd, [this]() { dispatchTimers(); })};
+    return {}; // timers live on the backend's timerfd
 }
 
 int Aquamarine::CHeadlessBackend::drmFD() {
@@ -138,54 +132,6 @@ bool Aquamarine::CHeadlessBackend::createOutput(const std::string& name) {
     return true;
 }
 
-void Aquamarine::CHeadlessBackend::dispatchTimers() {
-    std::vector<CTimer> toFire;
-    for (size_t i = 0; i < timers.timers.size(); ++i) {
-        if (timers.timers.at(i).expired()) {
-            toFire.emplace_back(timers.timers.at(i));
-            timers.timers.erase(timers.timers.begin() + i);
-            i--;
-            continue;
-        }
-    }
-
-    for (auto& copy : toFire) {
-        if (copy.what)
-            copy.what();
-    }
-
-    updateTimerFD();
-}
-
-void Aquamarine::CHeadlessBackend::updateTimerFD() {
-    long long  lowestNs = TIMESPEC_NSEC_PER_SEC * 240 /* 240s, 4 mins */;
-    const auto clocknow = std::chrono::steady_clock::now();
-    bool       any      = false;
-
-    for (auto& t : timers.timers) {
-        auto delta = std::chrono::duration_cast<std::chrono::microseconds>(t.when - clocknow).count() * 1000 /* µs -> ns */;
-
-        if (delta < lowestNs)
-            lowestNs = delta;
-    }
-
-    if (lowestNs < 0)
-        lowestNs = 0;
-
-    timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    timespecAddNs(&now, lowestNs);
-
-    itimerspec ts = {.it_value = now};
-
-    if (timerfd_settime(timers.timerfd, TFD_TIMER_ABSTIME, &ts, nullptr))
-        backend->log(AQ_LOG_ERROR, std::format("headless: failed to arm timerfd: {}", strerror(errno)));
-}
-
 SP<IAllocator> Aquamarine::CHeadlessBackend::preferredAllocator() {
     return backend->primaryAllocator;
 }
-
-bool Aquamarine::CHeadlessBackend::CTimer::expired() {
-    return std::chrono::steady_clock::now() > when;
-}
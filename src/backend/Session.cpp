@@ -10,18 +10,25 @@ extern "C" {
 #include <xf86drmMode.h>
 #include <linux/input.h>
 #include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 }
 
+#include "Shared.hpp"
+
 using namespace Aquamarine;
 using namespace Hyprutils::Memory;
 #define SP CSharedPointer
 
-static const std::string AQ_UNKNOWN_DEVICE_NAME = "UNKNOWN";
+static const std::string AQ_UNKNOWN_DEVICE_NAME       = "UNKNOWN";
+static const size_t      UDEV_MAX_EVENTS_PER_DISPATCH = 256;
+static const uint64_t    INPUT_SLOW_DISPATCH_NS       = 4000000; // one device hogging the loop for longer than this gets a warning
 
 // we can't really do better with libseat/libinput logs
 // because they don't allow us to pass "data" or anything...
 // Nobody should create multiple backends anyways really
 Hyprutils::Memory::CSharedPointer<CBackend> backendInUse;
+static CInputThread*                        inputThreadInUse = nullptr; // libseat / libinput logs go through it while it runs
 
 //
 static Aquamarine::eBackendLogLevel logLevelFromLibseat(libseat_log_level level) {
@@ -43,24 +50,34 @@ static Aquamarine::eBackendLogLevel logLevelFromLibinput(libinput_log_priority l
     return AQ_LOG_DEBUG;
 }
 
+// the input thread logs through libinput and libseat too, the consumer's logger is only ever called on the loop
+static void logFromLibrary(Aquamarine::eBackendLogLevel level, std::string&& line) {
+    if (inputThreadInUse) {
+        inputThreadInUse->queueLog(level, std::move(line));
+        return;
+    }
+
+    backendInUse->log(level, line);
+}
+
 static void libseatLog(libseat_log_level level, const char* fmt, va_list args) {
     if (!backendInUse)
         return;
 
-    static char string[1024];
+    char string[1024];
     vsnprintf(string, sizeof(string), fmt, args);
 
-    backendInUse->log(logLevelFromLibseat(level), std::format("[libseat] {}", string));
+    logFromLibrary(logLevelFromLibseat(level), std::format("[libseat] {}", string));
 }
 
 static void libinputLog(libinput*, libinput_log_priority level, const char* fmt, va_list args) {
     if (!backendInUse)
         return;
 
-    static char string[1024];
+    char string[1024];
     vsnprintf(string, sizeof(string), fmt, args);
 
-    backendInUse->log(logLevelFromLibinput(level), std::format("[libinput] {}", string));
+    logFromLibrary(logLevelFromLibinput(level), std::format("[libinput] {}", string));
 }
 
 // ------------ Libseat
@@ -89,9 +106,20 @@ static const libseat_seat_listener libseatListener = {
 
 //  ------------ Libinput
 
+// with the input thread, these run on it with libinputLock held
 static int libinputOpen(const char* path, int flags, void* data) {
     auto SESSION = (CSession*)data;
 
+    if (SESSION->inputThread) {
+        CSession::SInputFD inputFD;
+        inputFD.deviceID = libseat_open_device(SESSION->libseatHandle, path, &inputFD.fd);
+        if (inputFD.deviceID < 0)
+            return -1;
+
+        SESSION->inputFDs.emplace_back(inputFD);
+        return inputFD.fd;
+    }
+
     auto dev = makeShared<CSessionDevice>(SESSION->self.lock(), path);
     if (!dev->dev)
         return -1;
@@ -103,6 +131,16 @@ static int libinputOpen(const char* path, int flags, void* data) {
 static void libinputClose(int fd, void* data) {
     auto SESSION = (CSession*)data;
 
+    for (auto it = SESSION->inputFDs.begin(); it != SESSION->inputFDs.end(); ++it) {
+        if (it->fd != fd)
+            continue;
+
+        libseat_close_device(SESSION->libseatHandle, it->deviceID);
+        close(fd);
+        SESSION->inputFDs.erase(it);
+        return;
+    }
+
     std::erase_if(SESSION->sessionDevices, [fd](const auto& dev) {
         auto toRemove = dev->fd == fd;
         if (toRemove)
@@ -119,15 +157,16 @@ static const libinput_interface libinputListener = {
 // ------------
 
 Aquamarine::CSessionDevice::CSessionDevice(Hyprutils::Memory::CSharedPointer<CSession> session_, const std::string& path_) : session(session_), path(path_) {
+    auto lk  = session->lockLibinput();
     deviceID = libseat_open_device(session->libseatHandle, path.c_str(), &fd);
     if (deviceID < 0) {
-        session->backend->log(AQ_LOG_ERROR, std::format("libseat: Couldn't open device at {}", path_));
+        AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, std::format("libseat: Couldn't open device at {}", path_));
         return;
     }
 
     struct stat stat_;
     if (fstat(fd, &stat_) < 0) {
-        session->backend->log(AQ_LOG_ERROR, std::format("libseat: Couldn't stat device at {}", path_));
+        AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, std::format("libseat: Couldn't stat device at {}", path_));
         deviceID = -1;
         return;
     }
@@ -136,9 +175,11 @@ Aquamarine::CSessionDevice::CSessionDevice(Hyprutils::Memory::CSharedPointer<CSe
 }
 
 Aquamarine::CSessionDevice::~CSessionDevice() {
+    auto lk = session->lockLibinput();
+
     if (deviceID >= 0)
         if (libseat_close_device(session->libseatHandle, deviceID) < 0)
-            session->backend->log(AQ_LOG_ERROR, std::format("libseat: Couldn't close device at {}", path));
+            AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, std::format("libseat: Couldn't close device at {}", path));
     if (fd >= 0)
         close(fd);
 }
@@ -150,9 +191,9 @@ bool Aquamarine::CSessionDevice::supportsKMS() {
     bool kms = drmIsKMS(fd);
 
     if (kms)
-        session->backend->log(AQ_LOG_DEBUG, std::format("libseat: Device {} supports kms", path));
+        AQLOG(session->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_SESSION, std::format("libseat: Device {} supports kms", path));
     else
-        session->backend->log(AQ_LOG_DEBUG, std::format("libseat: Device {} does not support kms", path));
+        AQLOG(session->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_SESSION, std::format("libseat: Device {} does not support kms", path));
 
     return kms;
 }
@@ -181,13 +222,13 @@ SP<CSession> Aquamarine::CSession::attempt(Hyprutils::Memory::CSharedPointer<CBa
     session->libseatHandle = libseat_open_seat(&libseatListener, session.get());
 
     if (!session->libseatHandle) {
-        session->backend->log(AQ_LOG_ERROR, "libseat: failed to open a seat");
+        AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "libseat: failed to open a seat");
         return nullptr;
     }
 
     auto seatName = libseat_seat_name(session->libseatHandle);
     if (!seatName) {
-        session->backend->log(AQ_LOG_ERROR, "libseat: failed to get seat name");
+        AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "libseat: failed to get seat name");
         return nullptr;
     }
 
@@ -200,13 +241,13 @@ SP<CSession> Aquamarine::CSession::attempt(Hyprutils::Memory::CSharedPointer<CBa
 
     session->udevHandle = udev_new();
     if (!session->udevHandle) {
-        session->backend->log(AQ_LOG_ERROR, "udev: failed to create a new context");
+        AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "udev: failed to create a new context");
         return nullptr;
     }
 
     session->udevMonitor = udev_monitor_new_from_netlink(session->udevHandle, "udev");
     if (!session->udevMonitor) {
-        session->backend->log(AQ_LOG_ERROR, "udev: failed to create a new udevMonitor");
+        AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "udev: failed to create a new udevMonitor");
         return nullptr;
     }
 
@@ -215,24 +256,43 @@ SP<CSession> Aquamarine::CSession::attempt(Hyprutils::Memory::CSharedPointer<CBa
 
     // ----------- Libinput
 
+    // before the context, so that its devices already get opened the way the thread does it
+    if (envEnabled("AQ_INPUT_THREAD")) {
+        session->inputThread = makeShared<CInputThread>(session.get());
+        if (session->inputThread->readyFD < 0) {
+            AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "libinput: failed to set up the input thread, dispatching on the loop");
+            session->inputThread.reset();
+        } else
+            inputThreadInUse = session->inputThread.get();
+    }
+
     session->libinputHandle = libinput_udev_create_context(&libinputListener, session.get(), session->udevHandle);
     if (!session->libinputHandle) {
-        session->backend->log(AQ_LOG_ERROR, "libinput: failed to create a new context");
+        AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "libinput: failed to create a new context");
         return nullptr;
     }
 
     if (libinput_udev_assign_seat(session->libinputHandle, session->seatName.c_str())) {
-        session->backend->log(AQ_LOG_ERROR, "libinput: failed to assign a seat");
+        AQLOG(session->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "libinput: failed to assign a seat");
         return nullptr;
     }
 
     libinput_log_set_handler(session->libinputHandle, ::libinputLog);
     libinput_log_set_priority(session->libinputHandle, LIBINPUT_LOG_PRIORITY_DEBUG);
 
+    if (session->inputThread) {
+        AQLOG(session->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_SESSION, "libinput: AQ_INPUT_THREAD enabled, dispatching libinput on a separate thread");
+        session->inputThread->start();
+    }
+
     return session;
 }
 
 Aquamarine::CSession::~CSession() {
+    // the thread goes first, anything after this is on our thread only
+    inputThread.reset();
+    inputThreadInUse = nullptr;
+
     sessionDevices.clear();
     libinputDevices.clear();
 
@@ -288,91 +348,561 @@ void Aquamarine::CSession::dispatchUdevEvents() {
     if (!udevHandle || !udevMonitor)
         return;
 
-    auto device = udev_monitor_receive_device(udevMonitor);
+    // the udev context is shared with libinput
+    auto lk = lockLibinput();
+
+    // a burst (dock attached, many connectors changing...) is handled in one go. Back to back changes of a
+    // DRM device fold into one, while adds, changes and removes of a device keep their order.
+    struct SPendingEvent {
+        enum eType : uint8_t {
+            ADD = 0,
+            CHANGE,
+            REMOVE,
+        };
+
+        SP<CSessionDevice>           device;
+        eType                        type = CHANGE;
+        std::string                  path;                           // ADD
+        bool                         hotplug = false, lease = false; // CHANGE
+        CSessionDevice::SChangeEvent hotplugEvent;
+    };
 
-    if (!device)
-        return;
+    std::vector<SPendingEvent> pending;
+    size_t                     received = 0;
+
+    auto                       lastFor = [&pending](SP<CSessionDevice> device) -> SPendingEvent* {
+        for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+            if (it->device == device)
+                return &*it;
+        }
+        return nullptr;
+    };
+
+    // bounded, whatever's left keeps the fd readable for the next iteration
+    while (received < UDEV_MAX_EVENTS_PER_DISPATCH) {
+        auto device = udev_monitor_receive_device(udevMonitor);
+        if (!device)
+            break; // EAGAIN
+
+        received++;
+
+        auto sysname = udev_device_get_sysname(device);
+        auto devnode = udev_device_get_devnode(device);
+        auto action  = udev_device_get_action(device);
 
-    auto sysname = udev_device_get_sysname(device);
-    auto devnode = udev_device_get_devnode(device);
-    auto action  = udev_device_get_action(device);
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_SESSION, std::format("udev: new udev {} event for {}", action ? action : "unknown", sysname ? sysname : "unknown"));
 
-    backend->log(AQ_LOG_DEBUG, std::format("udev: new udev {} event for {}", action ? action : "unknown", sysname ? sysname : "unknown"));
+        if (!isDRMCard(sysname) || !action || !devnode) {
+            udev_device_unref(device);
+            continue;
+        }
+
+        dev_t              deviceNum = udev_device_get_devnum(device);
+        SP<CSessionDevice> sessionDevice;
+        for (auto& sDev : sessionDevices) {
+            if (sDev->dev == deviceNum) {
+                sessionDevice = sDev;
+                break;
+            }
+        }
+
+        if (!sessionDevice) {
+            udev_device_unref(device);
+            continue;
+        }
+
+        if (action == std::string{"add"}) {
+            if (auto last = lastFor(sessionDevice); !last || last->type != SPendingEvent::ADD)
+                pending.emplace_back(SPendingEvent{.device = sessionDevice, .type = SPendingEvent::ADD, .path = devnode});
+        } else if (action == std::string{"change"}) {
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_SESSION, std::format("udev: DRM device {} changed", sysname ? sysname : "unknown"));
+
+            auto last = lastFor(sessionDevice);
+            if (!last || last->type != SPendingEvent::CHANGE)
+                last = &pending.emplace_back(SPendingEvent{.device = sessionDevice, .type = SPendingEvent::CHANGE});
+
+            auto& change = *last;
+
+            //
+            auto prop = udev_device_get_property_value(device, "HOTPLUG");
+            if (prop && prop == std::string{"1"}) {
+                CSessionDevice::SChangeEvent event;
+                event.type = CSessionDevice::AQ_SESSION_EVENT_CHANGE_HOTPLUG;
+
+                prop = udev_device_get_property_value(device, "CONNECTOR");
+                if (prop)
+                    event.hotplug.connectorID = std::stoull(prop);
+
+                prop = udev_device_get_property_value(device, "PROPERTY");
+                if (prop)
+                    event.hotplug.propID = std::stoull(prop);
+
+                // several connectors changed, report it as a device-wide hotplug
+                if (change.hotplug && (change.hotplugEvent.hotplug.connectorID != event.hotplug.connectorID || change.hotplugEvent.hotplug.propID != event.hotplug.propID))
+                    event.hotplug = {};
+
+                change.hotplug      = true;
+                change.hotplugEvent = event;
+            } else if (prop = udev_device_get_property_value(device, "LEASE"); prop && prop == std::string{"1"}) {
+                change.lease = true;
+            } else {
+                AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_SESSION, std::format("udev: DRM device {} change event unrecognized", sysname ? sysname : "unknown"));
+                // unrecognized changes went out as a hotplug before, keep it that way
+                if (!change.hotplug) {
+                    change.hotplug      = true;
+                    change.hotplugEvent = {};
+                } else
+                    change.hotplugEvent.hotplug = {};
+            }
+        } else if (action == std::string{"remove"}) {
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_SESSION, std::format("udev: DRM device {} removed", sysname ? sysname : "unknown"));
+
+            // whatever came for it since it was last removed (an add, changes) is moot now
+            auto lastRemove = pending.end();
+            for (auto it = pending.begin(); it != pending.end(); ++it) {
+                if (it->device == sessionDevice && it->type == SPendingEvent::REMOVE)
+                    lastRemove = it;
+            }
+
+            const bool REMOVED = lastRemove != pending.end();
+            const auto FROM    = REMOVED ? lastRemove + 1 : pending.begin();
+            pending.erase(std::remove_if(FROM, pending.end(), [&sessionDevice](const auto& e) { return e.device == sessionDevice; }), pending.end());
+
+            if (!REMOVED)
+                pending.emplace_back(SPendingEvent{.device = sessionDevice, .type = SPendingEvent::REMOVE});
+        }
 
-    if (!isDRMCard(sysname) || !action || !devnode) {
         udev_device_unref(device);
-        return;
     }
 
-    dev_t              deviceNum = udev_device_get_devnum(device);
-    SP<CSessionDevice> sessionDevice;
-    for (auto& sDev : sessionDevices) {
-        if (sDev->dev == deviceNum) {
-            sessionDevice = sDev;
-            break;
+    if (received > 1)
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_SESSION, std::format("udev: handled {} events in one dispatch", received));
+
+    for (auto& e : pending) {
+        switch (e.type) {
+            case SPendingEvent::ADD: events.addDrmCard.emit(SAddDrmCardEvent{.path = e.path}); break;
+            case SPendingEvent::REMOVE: e.device->events.remove.emit(); break;
+            case SPendingEvent::CHANGE:
+                if (e.hotplug)
+                    e.device->events.change.emit(e.hotplugEvent);
+                if (e.lease)
+                    e.device->events.change.emit(CSessionDevice::SChangeEvent{.type = CSessionDevice::AQ_SESSION_EVENT_CHANGE_LEASE});
+                break;
         }
     }
+}
 
-    if (!sessionDevice) {
-        udev_device_unref(device);
-        return;
+static uint64_t libinputEventTimeUs(libinput_event* e) {
+    switch (libinput_event_get_type(e)) {
+        case LIBINPUT_EVENT_KEYBOARD_KEY: return libinput_event_keyboard_get_time_usec(libinput_event_get_keyboard_event(e));
+        case LIBINPUT_EVENT_POINTER_MOTION:
+        case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
+        case LIBINPUT_EVENT_POINTER_BUTTON:
+        case LIBINPUT_EVENT_POINTER_SCROLL_WHEEL:
+        case LIBINPUT_EVENT_POINTER_SCROLL_FINGER:
+        case LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS: return libinput_event_pointer_get_time_usec(libinput_event_get_pointer_event(e));
+        case LIBINPUT_EVENT_TOUCH_DOWN:
+        case LIBINPUT_EVENT_TOUCH_UP:
+        case LIBINPUT_EVENT_TOUCH_MOTION:
+        case LIBINPUT_EVENT_TOUCH_CANCEL:
+        case LIBINPUT_EVENT_TOUCH_FRAME: return libinput_event_touch_get_time_usec(libinput_event_get_touch_event(e));
+        case LIBINPUT_EVENT_TABLET_TOOL_AXIS:
+        case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
+        case LIBINPUT_EVENT_TABLET_TOOL_TIP:
+        case LIBINPUT_EVENT_TABLET_TOOL_BUTTON: return libinput_event_tablet_tool_get_time_usec(libinput_event_get_tablet_tool_event(e));
+        case LIBINPUT_EVENT_TABLET_PAD_BUTTON:
+        case LIBINPUT_EVENT_TABLET_PAD_RING:
+        case LIBINPUT_EVENT_TABLET_PAD_STRIP: return libinput_event_tablet_pad_get_time_usec(libinput_event_get_tablet_pad_event(e));
+        case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+        case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+        case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+        case LIBINPUT_EVENT_GESTURE_PINCH_END:
+        case LIBINPUT_EVENT_GESTURE_HOLD_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_HOLD_END: return libinput_event_gesture_get_time_usec(libinput_event_get_gesture_event(e));
+        case LIBINPUT_EVENT_SWITCH_TOGGLE: return libinput_event_switch_get_time_usec(libinput_event_get_switch_event(e));
+        default: break;
     }
 
-    if (action == std::string{"add"})
-        events.addDrmCard.emit(SAddDrmCardEvent{.path = devnode});
-    else if (action == std::string{"change"}) {
-        backend->log(AQ_LOG_DEBUG, std::format("udev: DRM device {} changed", sysname ? sysname : "unknown"));
-
-        CSessionDevice::SChangeEvent event;
-
-        //
-        auto prop = udev_device_get_property_value(device, "HOTPLUG");
-        if (prop && prop == std::string{"1"}) {
-            event.type = CSessionDevice::AQ_SESSION_EVENT_CHANGE_HOTPLUG;
-
-            prop = udev_device_get_property_value(device, "CONNECTOR");
-            if (prop)
-                event.hotplug.connectorID = std::stoull(prop);
-
-            prop = udev_device_get_property_value(device, "PROPERTY");
-            if (prop)
-                event.hotplug.propID = std::stoull(prop);
-        } else if (prop = udev_device_get_property_value(device, "LEASE"); prop && prop == std::string{"1"}) {
-            event.type = CSessionDevice::AQ_SESSION_EVENT_CHANGE_LEASE;
-        } else {
-            backend->log(AQ_LOG_DEBUG, std::format("udev: DRM device {} change event unrecognized", sysname ? sysname : "unknown"));
+    return 0;
+}
+
+static bool recordHoldsReferences(const SLibinputRecord& record) {
+    return record.type == LIBINPUT_EVENT_DEVICE_ADDED || record.type == LIBINPUT_EVENT_DEVICE_REMOVED || record.type == LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY;
+}
+
+// reads out everything handling the event needs, so the loop doesn't have to call into libinput for it.
+// With the input thread, this runs on it with libinputLock held.
+static void recordLibinputEvent(libinput_event* e, SLibinputRecord& record) {
+    record        = {};
+    record.type   = libinput_event_get_type(e);
+    record.device = libinput_event_get_device(e);
+    record.timeUs = libinputEventTimeUs(e);
+
+    switch (record.type) {
+        case LIBINPUT_EVENT_DEVICE_ADDED:
+        case LIBINPUT_EVENT_DEVICE_REMOVED: libinput_device_ref(record.device); break;
+
+        case LIBINPUT_EVENT_KEYBOARD_KEY: {
+            auto kbe   = libinput_event_get_keyboard_event(e);
+            record.key = {
+                .key     = libinput_event_keyboard_get_key(kbe),
+                .pressed = libinput_event_keyboard_get_key_state(kbe) == LIBINPUT_KEY_STATE_PRESSED,
+            };
+            break;
+        }
+
+        case LIBINPUT_EVENT_POINTER_MOTION: {
+            auto pe                  = libinput_event_get_pointer_event(e);
+            record.pointer.dx        = libinput_event_pointer_get_dx(pe);
+            record.pointer.dy        = libinput_event_pointer_get_dy(pe);
+            record.pointer.dxUnaccel = libinput_event_pointer_get_dx_unaccelerated(pe);
+            record.pointer.dyUnaccel = libinput_event_pointer_get_dy_unaccelerated(pe);
+            break;
+        }
+        case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE: {
+            auto pe          = libinput_event_get_pointer_event(e);
+            record.pointer.x = libinput_event_pointer_get_absolute_x_transformed(pe, 1);
+            record.pointer.y = libinput_event_pointer_get_absolute_y_transformed(pe, 1);
+            break;
+        }
+        case LIBINPUT_EVENT_POINTER_BUTTON: {
+            auto pe                        = libinput_event_get_pointer_event(e);
+            record.pointer.button          = libinput_event_pointer_get_button(pe);
+            record.pointer.seatButtonCount = libinput_event_pointer_get_seat_button_count(pe);
+            record.pointer.pressed         = libinput_event_pointer_get_button_state(pe) == LIBINPUT_BUTTON_STATE_PRESSED;
+            break;
+        }
+        case LIBINPUT_EVENT_POINTER_SCROLL_WHEEL:
+        case LIBINPUT_EVENT_POINTER_SCROLL_FINGER:
+        case LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS: {
+            static const std::array<libinput_pointer_axis, 2> LAXES = {
+                LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL,
+                LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL,
+            };
+
+            auto pe               = libinput_event_get_pointer_event(e);
+            record.scroll.natural = libinput_device_config_scroll_get_natural_scroll_enabled(record.device);
+
+            for (size_t i = 0; i < LAXES.size(); ++i) {
+                record.scroll.has[i] = libinput_event_pointer_has_axis(pe, LAXES[i]);
+                if (!record.scroll.has[i])
+                    continue;
+
+                record.scroll.value[i] = libinput_event_pointer_get_scroll_value(pe, LAXES[i]);
+                if (record.type == LIBINPUT_EVENT_POINTER_SCROLL_WHEEL)
+                    record.scroll.v120[i] = libinput_event_pointer_get_scroll_value_v120(pe, LAXES[i]);
+            }
+            break;
         }
 
-        sessionDevice->events.change.emit(event);
-    } else if (action == std::string{"remove"}) {
-        backend->log(AQ_LOG_DEBUG, std::format("udev: DRM device {} removed", sysname ? sysname : "unknown"));
-        sessionDevice->events.remove.emit();
+        case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_HOLD_BEGIN: record.gesture.fingers = (uint32_t)libinput_event_gesture_get_finger_count(libinput_event_get_gesture_event(e)); break;
+        case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+        case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE: {
+            auto ge                = libinput_event_get_gesture_event(e);
+            record.gesture.fingers = (uint32_t)libinput_event_gesture_get_finger_count(ge);
+            record.gesture.dx      = libinput_event_gesture_get_dx(ge);
+            record.gesture.dy      = libinput_event_gesture_get_dy(ge);
+            if (record.type == LIBINPUT_EVENT_GESTURE_PINCH_UPDATE) {
+                record.gesture.scale = libinput_event_gesture_get_scale(ge);
+                record.gesture.angle = libinput_event_gesture_get_angle_delta(ge);
+            }
+            break;
+        }
+        case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+        case LIBINPUT_EVENT_GESTURE_PINCH_END:
+        case LIBINPUT_EVENT_GESTURE_HOLD_END: record.gesture.cancelled = libinput_event_gesture_get_cancelled(libinput_event_get_gesture_event(e)); break;
+
+        case LIBINPUT_EVENT_TOUCH_DOWN:
+        case LIBINPUT_EVENT_TOUCH_MOTION: {
+            auto te           = libinput_event_get_touch_event(e);
+            record.touch.slot = libinput_event_touch_get_seat_slot(te);
+            record.touch.x    = libinput_event_touch_get_x_transformed(te, 1);
+            record.touch.y    = libinput_event_touch_get_y_transformed(te, 1);
+            break;
+        }
+        case LIBINPUT_EVENT_TOUCH_UP:
+        case LIBINPUT_EVENT_TOUCH_CANCEL: record.touch.slot = libinput_event_touch_get_seat_slot(libinput_event_get_touch_event(e)); break;
+
+        case LIBINPUT_EVENT_SWITCH_TOGGLE: {
+            auto se       = libinput_event_get_switch_event(e);
+            record.toggle = {
+                .which = (uint32_t)libinput_event_switch_get_switch(se),
+                .on    = libinput_event_switch_get_switch_state(se) == LIBINPUT_SWITCH_STATE_ON,
+            };
+            break;
+        }
+
+        case LIBINPUT_EVENT_TABLET_PAD_BUTTON: {
+            auto tpe           = libinput_event_get_tablet_pad_event(e);
+            record.pad.button  = libinput_event_tablet_pad_get_button_number(tpe);
+            record.pad.pressed = libinput_event_tablet_pad_get_button_state(tpe) == LIBINPUT_BUTTON_STATE_PRESSED;
+            record.pad.mode    = (uint16_t)libinput_event_tablet_pad_get_mode(tpe);
+            record.pad.group   = (uint16_t)libinput_tablet_pad_mode_group_get_index(libinput_event_tablet_pad_get_mode_group(tpe));
+            break;
+        }
+        case LIBINPUT_EVENT_TABLET_PAD_RING: {
+            auto tpe                 = libinput_event_get_tablet_pad_event(e);
+            record.pad.number        = libinput_event_tablet_pad_get_ring_number(tpe);
+            record.pad.pos           = libinput_event_tablet_pad_get_ring_position(tpe);
+            record.pad.unknownSource = libinput_event_tablet_pad_get_ring_source(tpe) == LIBINPUT_TABLET_PAD_RING_SOURCE_UNKNOWN;
+            record.pad.mode          = (uint16_t)libinput_event_tablet_pad_get_mode(tpe);
+            break;
+        }
+        case LIBINPUT_EVENT_TABLET_PAD_STRIP: {
+            auto tpe                 = libinput_event_get_tablet_pad_event(e);
+            record.pad.number        = libinput_event_tablet_pad_get_strip_number(tpe);
+            record.pad.pos           = libinput_event_tablet_pad_get_strip_position(tpe);
+            record.pad.unknownSource = libinput_event_tablet_pad_get_strip_source(tpe) == LIBINPUT_TABLET_PAD_STRIP_SOURCE_UNKNOWN;
+            record.pad.mode          = (uint16_t)libinput_event_tablet_pad_get_mode(tpe);
+            break;
+        }
+
+        case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY:
+        case LIBINPUT_EVENT_TABLET_TOOL_AXIS:
+        case LIBINPUT_EVENT_TABLET_TOOL_TIP:
+        case LIBINPUT_EVENT_TABLET_TOOL_BUTTON: {
+            auto  tte = libinput_event_get_tablet_tool_event(e);
+            auto& t   = record.tablet;
+
+            t.tool       = libinput_event_tablet_tool_get_tool(tte);
+            t.x          = libinput_event_tablet_tool_get_x_transformed(tte, 1);
+            t.y          = libinput_event_tablet_tool_get_y_transformed(tte, 1);
+            t.dx         = libinput_event_tablet_tool_get_dx(tte);
+            t.dy         = libinput_event_tablet_tool_get_dy(tte);
+            t.pressure   = libinput_event_tablet_tool_get_pressure(tte);
+            t.distance   = libinput_event_tablet_tool_get_distance(tte);
+            t.tiltX      = libinput_event_tablet_tool_get_tilt_x(tte);
+            t.tiltY      = libinput_event_tablet_tool_get_tilt_y(tte);
+            t.rotation   = libinput_event_tablet_tool_get_rotation(tte);
+            t.slider     = libinput_event_tablet_tool_get_slider_position(tte);
+            t.wheelDelta = libinput_event_tablet_tool_get_wheel_delta(tte);
+
+            if (libinput_event_tablet_tool_x_has_changed(tte))
+                t.updatedAxes |= AQ_TABLET_TOOL_AXIS_X;
+            if (libinput_event_tablet_tool_y_has_changed(tte))
+                t.updatedAxes |= AQ_TABLET_TOOL_AXIS_Y;
+            if (libinput_event_tablet_tool_pressure_has_changed(tte))
+                t.updatedAxes |= AQ_TABLET_TOOL_AXIS_PRESSURE;
+            if (libinput_event_tablet_tool_distance_has_changed(tte))
+                t.updatedAxes |= AQ_TABLET_TOOL_AXIS_DISTANCE;
+            if (libinput_event_tablet_tool_tilt_x_has_changed(tte))
+                t.updatedAxes |= AQ_TABLET_TOOL_AXIS_TILT_X;
+            if (libinput_event_tablet_tool_tilt_y_has_changed(tte))
+                t.updatedAxes |= AQ_TABLET_TOOL_AXIS_TILT_Y;
+            if (libinput_event_tablet_tool_rotation_has_changed(tte))
+                t.updatedAxes |= AQ_TABLET_TOOL_AXIS_ROTATION;
+            if (libinput_event_tablet_tool_slider_has_changed(tte))
+                t.updatedAxes |= AQ_TABLET_TOOL_AXIS_SLIDER;
+            if (libinput_event_tablet_tool_wheel_has_changed(tte))
+                t.updatedAxes |= AQ_TABLET_TOOL_AXIS_WHEEL;
+
+            if (record.type == LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY) {
+                // the loop sets the tool up on proximity in and tears it down on proximity out
+                libinput_tablet_tool_ref(t.tool);
+                t.in = libinput_event_tablet_tool_get_proximity_state(tte) == LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_IN;
+            } else if (record.type == LIBINPUT_EVENT_TABLET_TOOL_TIP)
+                t.down = libinput_event_tablet_tool_get_tip_state(tte) == LIBINPUT_TABLET_TOOL_TIP_DOWN;
+            else if (record.type == LIBINPUT_EVENT_TABLET_TOOL_BUTTON) {
+                t.button  = libinput_event_tablet_tool_get_button(tte);
+                t.pressed = libinput_event_tablet_tool_get_button_state(tte) == LIBINPUT_BUTTON_STATE_PRESSED;
+            }
+            break;
+        }
+
+        default: break;
     }
+}
 
-    udev_device_unref(device);
-    return;
+// drops the references recordLibinputEvent took, with libinputLock held
+static void releaseLibinputRecord(const SLibinputRecord& record) {
+    if (record.type == LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY)
+        libinput_tablet_tool_unref(record.tablet.tool);
+    else if (recordHoldsReferences(record))
+        libinput_device_unref(record.device);
 }
 
 void Aquamarine::CSession::dispatchLibinputEvents() {
     if (!libinputHandle)
         return;
 
-    if (int ret = libinput_dispatch(libinputHandle); ret) {
-        backend->log(AQ_LOG_ERROR, std::format("Couldn't dispatch libinput events: {}", strerror(-ret)));
-        return;
+    const bool COALESCE = backend->options.coalesceInput;
+
+    SLibinputRecord record;
+
+    if (inputThread) {
+        uint64_t ready = 0;
+        read(inputThread->readyFD, &ready, sizeof(ready));
+
+        inputThread->flushLogs();
+
+        while (inputThread->pop(record)) {
+            processLibinputEvent(record, COALESCE);
+        }
+
+        inputThread->popped();
+    } else {
+        if (int ret = libinput_dispatch(libinputHandle); ret) {
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, std::format("Couldn't dispatch libinput events: {}", strerror(-ret)));
+            return;
+        }
+
+        while (auto event = libinput_get_event(libinputHandle)) {
+            recordLibinputEvent(event, record);
+            libinput_event_destroy(event);
+            processLibinputEvent(record, COALESCE);
+        }
+    }
+
+    if (COALESCE)
+        flushCoalescedMotion();
+    if (backend->options.batchInput)
+        flushTabletBatches();
+
+    finishInputDispatch();
+}
+
+void Aquamarine::CSession::finishInputDispatch() {
+    for (auto& d : libinputDevices) {
+        if (d->dispatchEvents == 0)
+            continue;
+
+        auto& stats = d->stats;
+        stats.dispatches++;
+        stats.lastDispatchEvents   = d->dispatchEvents;
+        stats.lastDispatchHandleNs = d->dispatchHandleNs;
+        stats.maxDispatchEvents    = std::max(stats.maxDispatchEvents, d->dispatchEvents);
+
+        if (d->dispatchHandleNs > stats.maxDispatchHandleNs) {
+            stats.maxDispatchHandleNs = d->dispatchHandleNs;
+            if (stats.maxDispatchHandleNs > INPUT_SLOW_DISPATCH_NS)
+                AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_SESSION,
+                      std::format("libinput: {} took {:.2f}ms for {} events in one dispatch, a new worst", d->name, d->dispatchHandleNs / 1000000.0, d->dispatchEvents));
+        }
+
+        AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_SESSION,
+              std::format("libinput: {}: {} events in {}µs this dispatch, {} events total", d->name, d->dispatchEvents, d->dispatchHandleNs / 1000, stats.events));
+
+        d->dispatchEvents   = 0;
+        d->dispatchHandleNs = 0;
+    }
+}
+
+static uint64_t monotonicNs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void Aquamarine::CSession::processLibinputEvent(const SLibinputRecord& record, bool coalesce) {
+    const bool REFERENCES = recordHoldsReferences(record);
+
+    // device setup / teardown and tool refcounting call into libinput. Before dev, so a removed device goes with it held
+    std::unique_lock<std::recursive_mutex> lk;
+    if (REFERENCES)
+        lk = lockLibinput();
+
+    // held so a DEVICE_REMOVED can be accounted for after it's handled
+    SP<CLibinputDevice> dev = libinputDeviceFrom(record.device);
+
+    const uint64_t      BEGINNS = dev ? monotonicNs() : 0;
+
+    if (dev) {
+        if (record.timeUs) {
+            const uint64_t NOWUS = BEGINNS / 1000;
+            dev->latency.add(NOWUS > record.timeUs ? NOWUS - record.timeUs : 0);
+        }
+
+        dev->stats.eventsByType[CLibinputDevice::SStats::slotFor(record.type)]++;
+        dev->stats.events++;
+        dev->dispatchEvents++;
+    }
+
+    if (!coalesce || !coalesceLibinputEvent(record)) {
+        // anything that isn't motion goes out after the motion that came before it
+        if (coalesce)
+            flushCoalescedMotion();
+
+        handleLibinputEvent(record);
     }
 
-    libinput_event* event = libinput_get_event(libinputHandle);
-    while (event) {
-        handleLibinputEvent(event);
-        libinput_event_destroy(event);
-        event = libinput_get_event(libinputHandle);
+    if (REFERENCES)
+        releaseLibinputRecord(record);
+
+    if (dev) {
+        const uint64_t NS = monotonicNs() - BEGINNS;
+        dev->stats.handleNs += NS;
+        dev->dispatchHandleNs += NS;
+    }
+}
+
+bool Aquamarine::CSession::coalesceLibinputEvent(const SLibinputRecord& record) {
+    if (record.type != LIBINPUT_EVENT_POINTER_MOTION && record.type != LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE)
+        return false;
+
+    auto dev = libinputDeviceFrom(record.device);
+    if (!dev || !dev->mouse)
+        return false;
+
+    auto& pending = dev->pendingMotion;
+
+    if (record.type == LIBINPUT_EVENT_POINTER_MOTION) {
+        if (pending.hasWarp)
+            dev->flushMotion();
+
+        const IPointer::SMotionSample SAMPLE = {
+            .timeUs  = record.timeUs,
+            .delta   = {record.pointer.dx, record.pointer.dy},
+            .unaccel = {record.pointer.dxUnaccel, record.pointer.dyUnaccel},
+        };
+
+        if (!pending.hasMove) {
+            pending.move    = {};
+            pending.hasMove = true;
+        }
+
+        pending.move.timeMs  = (uint32_t)(SAMPLE.timeUs / 1000);
+        pending.move.timeUs  = SAMPLE.timeUs;
+        pending.move.delta   = pending.move.delta + SAMPLE.delta;
+        pending.move.unaccel = pending.move.unaccel + SAMPLE.unaccel;
+        pending.samples.emplace_back(SAMPLE);
+    } else {
+        if (pending.hasMove)
+            dev->flushMotion();
+
+        // absolute positions don't add up, the last one wins
+        pending.warp = IPointer::SWarpEvent{
+            .timeMs   = (uint32_t)(record.timeUs / 1000),
+            .timeUs   = record.timeUs,
+            .absolute = {record.pointer.x, record.pointer.y},
+        };
+        pending.hasWarp = true;
+    }
+
+    return true;
+}
+
+void Aquamarine::CSession::flushCoalescedMotion() {
+    for (auto& d : libinputDevices) {
+        d->flushMotion();
+    }
+}
+
+void Aquamarine::CSession::flushTabletBatches() {
+    for (auto& d : libinputDevices) {
+        d->flushTabletBatch();
     }
 }
 
 void Aquamarine::CSession::dispatchLibseatEvents() {
+    // also covers libinput_suspend / resume in the seat callbacks
+    auto lk = lockLibinput();
+
     if (libseat_dispatch(libseatHandle, 0) == -1)
-        backend->log(AQ_LOG_ERROR, "Couldn't dispatch libseat events");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "Couldn't dispatch libseat events");
 }
 
 void Aquamarine::CSession::dispatchPendingEventsAsync() {
@@ -384,55 +914,238 @@ void Aquamarine::CSession::dispatchPendingEventsAsync() {
 std::vector<Hyprutils::Memory::CSharedPointer<SPollFD>> Aquamarine::CSession::pollFDs() {
     // clang-format off
     return {
-        makeShared<SPollFD>(libseat_get_fd(libseatHandle), [this](){    dispatchLibseatEvents();  }),
-        makeShared<SPollFD>(udev_monitor_get_fd(udevMonitor), [this](){ dispatchUdevEvents();     }),
-        makeShared<SPollFD>(libinput_get_fd(libinputHandle), [this](){  dispatchLibinputEvents(); })
+        makeShared<SPollFD>(libseat_get_fd(libseatHandle), [this](){                                          dispatchLibseatEvents();  }),
+        makeShared<SPollFD>(udev_monitor_get_fd(udevMonitor), [this](){                                       dispatchUdevEvents();     }),
+        makeShared<SPollFD>(inputThread ? inputThread->readyFD : libinput_get_fd(libinputHandle), [this](){  dispatchLibinputEvents(); })
     };
     // clang-format on
 }
 
 bool Aquamarine::CSession::switchVT(uint32_t vt) {
+    auto lk = lockLibinput();
     return libseat_switch_session(libseatHandle, vt) == 0;
 }
 
-void Aquamarine::CSession::handleLibinputEvent(libinput_event* e) {
-    auto device    = libinput_event_get_device(e);
-    auto eventType = libinput_event_get_type(e);
-    auto data      = libinput_device_get_user_data(device);
+std::string Aquamarine::CSession::dumpInputStats() {
+    std::string out;
+    for (auto& d : libinputDevices) {
+        out += d->dumpStats();
+    }
 
-    backend->log(AQ_LOG_TRACE, std::format("libinput: Event {}", (int)eventType));
+    return out;
+}
+
+std::unique_lock<std::recursive_mutex> Aquamarine::CSession::lockLibinput() {
+    if (!inputThread)
+        return {};
+
+    return std::unique_lock(libinputLock);
+}
+
+Aquamarine::CInputThread::CInputThread(CSession* session_) : session(session_) {
+    readyFD = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    wakeFD  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (wakeFD < 0 && readyFD >= 0) {
+        close(readyFD);
+        readyFD = -1;
+    }
+}
+
+Aquamarine::CInputThread::~CInputThread() {
+    exit = true;
+
+    if (thread.joinable()) {
+        uint64_t wake = 1;
+        write(wakeFD, &wake, sizeof(wake));
+        thread.join();
+    }
+
+    // whatever the loop didn't get to
+    SLibinputRecord record;
+    while (pop(record)) {
+        releaseLibinputRecord(record);
+    }
+
+    flushLogs();
+
+    if (readyFD >= 0)
+        close(readyFD);
+    if (wakeFD >= 0)
+        close(wakeFD);
+}
+
+void Aquamarine::CInputThread::start() {
+    thread = std::thread([this]() { run(); });
+}
+
+void Aquamarine::CInputThread::run() {
+    pollfd fds[] = {
+        {.fd = libinput_get_fd(session->libinputHandle), .events = POLLIN},
+        {.fd = wakeFD, .events = POLLIN},
+    };
+    const int LIBINPUTFD = fds[0].fd;
 
-    if (!data && eventType != LIBINPUT_EVENT_DEVICE_ADDED) {
-        backend->log(AQ_LOG_ERROR, "libinput: No aq device in event and not added");
+    while (!exit) {
+        bool queued = false;
+
+        {
+            std::lock_guard lg(session->libinputLock);
+            libinput_dispatch(session->libinputHandle);
+            queued = drain();
+        }
+
+        if (queued) {
+            uint64_t ready = 1;
+            write(readyFD, &ready, sizeof(ready));
+        }
+
+        // with the ring full, leave libinput be until the loop makes room
+        fds[0].fd = stalled ? -1 : LIBINPUTFD;
+
+        if (poll(fds, 2, -1) < 0 && errno != EINTR)
+            break;
+
+        if (fds[1].revents & POLLIN) {
+            uint64_t wake = 0;
+            read(wakeFD, &wake, sizeof(wake));
+        }
+    }
+}
+
+bool Aquamarine::CInputThread::drain() {
+    bool queued = false;
+
+    while (true) {
+        const auto HEAD = head.load(std::memory_order_relaxed);
+
+        if (HEAD - tail.load() >= RING_SIZE) {
+            stalled = true;
+            // the loop might've popped everything before seeing stalled
+            if (HEAD - tail.load() >= RING_SIZE)
+                break;
+            stalled = false;
+        }
+
+        auto e = libinput_get_event(session->libinputHandle);
+        if (!e)
+            break;
+
+        recordLibinputEvent(e, ring[HEAD % RING_SIZE]);
+        libinput_event_destroy(e);
+        head.store(HEAD + 1, std::memory_order_release);
+        queued = true;
+    }
+
+    return queued;
+}
+
+bool Aquamarine::CInputThread::pop(SLibinputRecord& record) {
+    const auto TAIL = tail.load(std::memory_order_relaxed);
+
+    if (TAIL == head.load(std::memory_order_acquire))
+        return false;
+
+    record = ring[TAIL % RING_SIZE];
+    tail.store(TAIL + 1);
+    return true;
+}
+
+void Aquamarine::CInputThread::popped() {
+    if (!stalled.exchange(false))
         return;
+
+    uint64_t wake = 1;
+    write(wakeFD, &wake, sizeof(wake));
+}
+
+void Aquamarine::CInputThread::queueLog(eBackendLogLevel level, std::string&& line) {
+    {
+        std::lock_guard lg(logLock);
+        logLines.emplace_back(level, std::move(line));
+    }
+
+    uint64_t ready = 1;
+    write(readyFD, &ready, sizeof(ready));
+}
+
+void Aquamarine::CInputThread::flushLogs() {
+    std::vector<std::pair<eBackendLogLevel, std::string>> lines;
+
+    {
+        std::lock_guard lg(logLock);
+        lines.swap(logLines);
     }
 
-    if (!data) {
-        auto dev  = libinputDevices.emplace_back(makeShared<CLibinputDevice>(device, self));
+    if (!backendInUse)
+        return;
+
+    for (auto& [level, line] : lines) {
+        backendInUse->log(level, line);
+    }
+}
+
+SP<CLibinputDevice> Aquamarine::CSession::libinputDeviceFrom(libinput_device* device) {
+    for (auto& d : libinputDevices) {
+        if (d->device == device)
+            return d;
+    }
+
+    return nullptr;
+}
+
+void Aquamarine::CSession::handleLibinputEvent(const SLibinputRecord& record) {
+    const auto TYPE = record.type;
+
+    AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_SESSION, std::format("libinput: Event {}", TYPE));
+
+    auto hlDevice = libinputDeviceFrom(record.device);
+
+    if (!hlDevice && TYPE != LIBINPUT_EVENT_DEVICE_ADDED) {
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "libinput: No aq device in event and not added");
+        return;
+    }
+
+    if (!hlDevice) {
+        auto dev  = libinputDevices.emplace_back(makeShared<CLibinputDevice>(record.device, self));
         dev->self = dev;
         dev->init();
         return;
     }
 
-    auto hlDevice    = ((CLibinputDevice*)data)->self.lock();
-    bool destroyTool = false;
+    const bool BATCH     = backend->options.batchInput;
+    const auto TIMEMS    = (uint32_t)(record.timeUs / 1000);
+    const auto TOOLEVENT = TYPE >= LIBINPUT_EVENT_TABLET_TOOL_AXIS && TYPE <= LIBINPUT_EVENT_TABLET_TOOL_BUTTON;
+
+    // tools are only set up on proximity in, which holds libinputLock. Their other events find them already there.
+    SP<CLibinputTabletTool> tool;
+    if (TOOLEVENT) {
+        tool = hlDevice->toolFrom(record.tablet.tool, TYPE == LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY);
 
-    switch (eventType) {
+        if (!tool) {
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_SESSION, "libinput: Tablet tool event without the tool being in proximity");
+            return;
+        }
+    }
+
+    switch (TYPE) {
         case LIBINPUT_EVENT_DEVICE_ADDED:
             /* shouldn't happen */
             break;
         case LIBINPUT_EVENT_DEVICE_REMOVED:
-            std::erase_if(libinputDevices, [device](const auto& d) { return d->device == device; });
+            hlDevice->flushTouchBatch();
+            hlDevice->flushTabletBatch();
+            std::erase_if(libinputDevices, [&record](const auto& d) { return d->device == record.device; });
             break;
 
             // --------- keyboard
 
         case LIBINPUT_EVENT_KEYBOARD_KEY: {
-            auto kbe = libinput_event_get_keyboard_event(e);
             hlDevice->keyboard->events.key.emit(IKeyboard::SKeyEvent{
-                .timeMs  = (uint32_t)(libinput_event_keyboard_get_time_usec(kbe) / 1000),
-                .key     = libinput_event_keyboard_get_key(kbe),
-                .pressed = libinput_event_keyboard_get_key_state(kbe) == LIBINPUT_KEY_STATE_PRESSED,
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .key     = record.key.key,
+                .pressed = record.key.pressed,
             });
             break;
         }
@@ -440,37 +1153,37 @@ void Aquamarine::CSession::handleLibinputEvent(libinput_event* e) {
             // --------- pointer
 
         case LIBINPUT_EVENT_POINTER_MOTION: {
-            auto pe = libinput_event_get_pointer_event(e);
             hlDevice->mouse->events.move.emit(IPointer::SMoveEvent{
-                .timeMs  = (uint32_t)(libinput_event_pointer_get_time_usec(pe) / 1000),
-                .delta   = {libinput_event_pointer_get_dx(pe), libinput_event_pointer_get_dy(pe)},
-                .unaccel = {libinput_event_pointer_get_dx_unaccelerated(pe), libinput_event_pointer_get_dy_unaccelerated(pe)},
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .delta   = {record.pointer.dx, record.pointer.dy},
+                .unaccel = {record.pointer.dxUnaccel, record.pointer.dyUnaccel},
             });
             hlDevice->mouse->events.frame.emit();
             break;
         }
 
         case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE: {
-            auto pe = libinput_event_get_pointer_event(e);
             hlDevice->mouse->events.warp.emit(IPointer::SWarpEvent{
-                .timeMs   = (uint32_t)(libinput_event_pointer_get_time_usec(pe) / 1000),
-                .absolute = {libinput_event_pointer_get_absolute_x_transformed(pe, 1), libinput_event_pointer_get_absolute_y_transformed(pe, 1)},
+                .timeMs   = TIMEMS,
+                .timeUs   = record.timeUs,
+                .absolute = {record.pointer.x, record.pointer.y},
             });
             hlDevice->mouse->events.frame.emit();
             break;
         }
 
         case LIBINPUT_EVENT_POINTER_BUTTON: {
-            auto       pe        = libinput_event_get_pointer_event(e);
-            const auto SEATCOUNT = libinput_event_pointer_get_seat_button_count(pe);
-            const bool PRESSED   = libinput_event_pointer_get_button_state(pe) == LIBINPUT_BUTTON_STATE_PRESSED;
+            const auto SEATCOUNT = record.pointer.seatButtonCount;
+            const bool PRESSED   = record.pointer.pressed;
 
             if ((PRESSED && SEATCOUNT != 1) || (!PRESSED && SEATCOUNT != 0))
                 break;
 
             hlDevice->mouse->events.button.emit(IPointer::SButtonEvent{
-                .timeMs  = (uint32_t)(libinput_event_pointer_get_time_usec(pe) / 1000),
-                .button  = libinput_event_pointer_get_button(pe),
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .button  = record.pointer.button,
                 .pressed = PRESSED,
             });
             hlDevice->mouse->events.frame.emit();
@@ -480,36 +1193,34 @@ void Aquamarine::CSession::handleLibinputEvent(libinput_event* e) {
         case LIBINPUT_EVENT_POINTER_SCROLL_WHEEL:
         case LIBINPUT_EVENT_POINTER_SCROLL_FINGER:
         case LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS: {
-            auto                 pe = libinput_event_get_pointer_event(e);
-
             IPointer::SAxisEvent aqe = {
-                .timeMs = (uint32_t)(libinput_event_pointer_get_time_usec(pe) / 1000),
+                .timeMs = TIMEMS,
+                .timeUs = record.timeUs,
             };
 
-            switch (eventType) {
+            switch (TYPE) {
                 case LIBINPUT_EVENT_POINTER_SCROLL_WHEEL: aqe.source = IPointer::AQ_POINTER_AXIS_SOURCE_WHEEL; break;
                 case LIBINPUT_EVENT_POINTER_SCROLL_FINGER: aqe.source = IPointer::AQ_POINTER_AXIS_SOURCE_FINGER; break;
                 case LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS: aqe.source = IPointer::AQ_POINTER_AXIS_SOURCE_CONTINUOUS; break;
                 default: break; /* unreachable */
             }
 
-            static const std::array<libinput_pointer_axis, 2> LAXES = {
-                LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL,
-                LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL,
+            // in the record's order: vertical, horizontal
+            static const std::array<IPointer::ePointerAxis, 2> AXES = {
+                IPointer::AQ_POINTER_AXIS_VERTICAL,
+                IPointer::AQ_POINTER_AXIS_HORIZONTAL,
             };
 
-            for (auto& axis : LAXES) {
-                if (!libinput_event_pointer_has_axis(pe, axis))
+            for (size_t i = 0; i < AXES.size(); ++i) {
+                if (!record.scroll.has[i])
                     continue;
 
-                aqe.axis      = axis == LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL ? IPointer::AQ_POINTER_AXIS_VERTICAL : IPointer::AQ_POINTER_AXIS_HORIZONTAL;
-                aqe.delta     = libinput_event_pointer_get_scroll_value(pe, axis);
-                aqe.direction = IPointer::AQ_POINTER_AXIS_RELATIVE_IDENTICAL;
-                if (libinput_device_config_scroll_get_natural_scroll_enabled(device))
-                    aqe.direction = IPointer::AQ_POINTER_AXIS_RELATIVE_INVERTED;
+                aqe.axis      = AXES[i];
+                aqe.delta     = record.scroll.value[i];
+                aqe.direction = record.scroll.natural ? IPointer::AQ_POINTER_AXIS_RELATIVE_INVERTED : IPointer::AQ_POINTER_AXIS_RELATIVE_IDENTICAL;
 
                 if (aqe.source == IPointer::AQ_POINTER_AXIS_SOURCE_WHEEL)
-                    aqe.discrete = libinput_event_pointer_get_scroll_value_v120(pe, axis);
+                    aqe.discrete = record.scroll.v120[i];
 
                 hlDevice->mouse->events.axis.emit(aqe);
             }
@@ -519,72 +1230,72 @@ void Aquamarine::CSession::handleLibinputEvent(libinput_event* e) {
         }
 
         case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN: {
-            auto ge = libinput_event_get_gesture_event(e);
             hlDevice->mouse->events.swipeBegin.emit(IPointer::SSwipeBeginEvent{
-                .timeMs  = (uint32_t)(libinput_event_gesture_get_time_usec(ge) / 1000),
-                .fingers = (uint32_t)libinput_event_gesture_get_finger_count(ge),
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .fingers = record.gesture.fingers,
             });
             break;
         }
         case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE: {
-            auto ge = libinput_event_get_gesture_event(e);
             hlDevice->mouse->events.swipeUpdate.emit(IPointer::SSwipeUpdateEvent{
-                .timeMs  = (uint32_t)(libinput_event_gesture_get_time_usec(ge) / 1000),
-                .fingers = (uint32_t)libinput_event_gesture_get_finger_count(ge),
-                .delta   = {libinput_event_gesture_get_dx(ge), libinput_event_gesture_get_dy(ge)},
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .fingers = record.gesture.fingers,
+                .delta   = {record.gesture.dx, record.gesture.dy},
             });
             break;
         }
         case LIBINPUT_EVENT_GESTURE_SWIPE_END: {
-            auto ge = libinput_event_get_gesture_event(e);
             hlDevice->mouse->events.swipeEnd.emit(IPointer::SSwipeEndEvent{
-                .timeMs    = (uint32_t)(libinput_event_gesture_get_time_usec(ge) / 1000),
-                .cancelled = (bool)libinput_event_gesture_get_cancelled(ge),
+                .timeMs    = TIMEMS,
+                .timeUs    = record.timeUs,
+                .cancelled = record.gesture.cancelled,
             });
             break;
         }
 
         case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN: {
-            auto ge = libinput_event_get_gesture_event(e);
             hlDevice->mouse->events.pinchBegin.emit(IPointer::SPinchBeginEvent{
-                .timeMs  = (uint32_t)(libinput_event_gesture_get_time_usec(ge) / 1000),
-                .fingers = (uint32_t)libinput_event_gesture_get_finger_count(ge),
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .fingers = record.gesture.fingers,
             });
             break;
         }
         case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE: {
-            auto ge = libinput_event_get_gesture_event(e);
             hlDevice->mouse->events.pinchUpdate.emit(IPointer::SPinchUpdateEvent{
-                .timeMs   = (uint32_t)(libinput_event_gesture_get_time_usec(ge) / 1000),
-                .fingers  = (uint32_t)libinput_event_gesture_get_finger_count(ge),
-                .delta    = {libinput_event_gesture_get_dx(ge), libinput_event_gesture_get_dy(ge)},
-                .scale    = libinput_event_gesture_get_scale(ge),
-                .rotation = libinput_event_gesture_get_angle_delta(ge),
+                .timeMs   = TIMEMS,
+                .timeUs   = record.timeUs,
+                .fingers  = record.gesture.fingers,
+                .delta    = {record.gesture.dx, record.gesture.dy},
+                .scale    = record.gesture.scale,
+                .rotation = record.gesture.angle,
             });
             break;
         }
         case LIBINPUT_EVENT_GESTURE_PINCH_END: {
-            auto ge = libinput_event_get_gesture_event(e);
             hlDevice->mouse->events.pinchEnd.emit(IPointer::SPinchEndEvent{
-                .timeMs    = (uint32_t)(libinput_event_gesture_get_time_usec(ge) / 1000),
-                .cancelled = (bool)libinput_event_gesture_get_cancelled(ge),
+                .timeMs    = TIMEMS,
+                .timeUs    = record.timeUs,
+                .cancelled = record.gesture.cancelled,
             });
             break;
         }
 
         case LIBINPUT_EVENT_GESTURE_HOLD_BEGIN: {
-            auto ge = libinput_event_get_gesture_event(e);
             hlDevice->mouse->events.holdBegin.emit(IPointer::SHoldBeginEvent{
-                .timeMs  = (uint32_t)(libinput_event_gesture_get_time_usec(ge) / 1000),
-                .fingers = (uint32_t)libinput_event_gesture_get_finger_count(ge),
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .fingers = record.gesture.fingers,
             });
             break;
         }
         case LIBINPUT_EVENT_GESTURE_HOLD_END: {
-            auto ge = libinput_event_get_gesture_event(e);
             hlDevice->mouse->events.holdEnd.emit(IPointer::SHoldEndEvent{
-                .timeMs    = (uint32_t)(libinput_event_gesture_get_time_usec(ge) / 1000),
-                .cancelled = (bool)libinput_event_gesture_get_cancelled(ge),
+                .timeMs    = TIMEMS,
+                .timeUs    = record.timeUs,
+                .cancelled = record.gesture.cancelled,
             });
             break;
         }
@@ -592,41 +1303,61 @@ void Aquamarine::CSession::handleLibinputEvent(libinput_event* e) {
             // --------- touch
 
         case LIBINPUT_EVENT_TOUCH_DOWN: {
-            auto te = libinput_event_get_touch_event(e);
+            // batched motions came first, they go out before this
+            if (BATCH)
+                hlDevice->flushTouchBatch();
+
             hlDevice->touch->events.down.emit(ITouch::SDownEvent{
-                .timeMs  = (uint32_t)(libinput_event_touch_get_time_usec(te) / 1000),
-                .touchID = libinput_event_touch_get_seat_slot(te),
-                .pos     = {libinput_event_touch_get_x_transformed(te, 1), libinput_event_touch_get_y_transformed(te, 1)},
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .touchID = record.touch.slot,
+                .pos     = {record.touch.x, record.touch.y},
             });
             break;
         }
         case LIBINPUT_EVENT_TOUCH_UP: {
-            auto te = libinput_event_get_touch_event(e);
+            if (BATCH)
+                hlDevice->flushTouchBatch();
+
             hlDevice->touch->events.up.emit(ITouch::SUpEvent{
-                .timeMs  = (uint32_t)(libinput_event_touch_get_time_usec(te) / 1000),
-                .touchID = libinput_event_touch_get_seat_slot(te),
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .touchID = record.touch.slot,
             });
             break;
         }
         case LIBINPUT_EVENT_TOUCH_MOTION: {
-            auto te = libinput_event_get_touch_event(e);
+            if (BATCH) {
+                auto& pending = hlDevice->pendingTouch;
+                pending.timeUs.emplace_back(record.timeUs);
+                pending.touchID.emplace_back(record.touch.slot);
+                pending.x.emplace_back(record.touch.x);
+                pending.y.emplace_back(record.touch.y);
+                break;
+            }
+
             hlDevice->touch->events.move.emit(ITouch::SMotionEvent{
-                .timeMs  = (uint32_t)(libinput_event_touch_get_time_usec(te) / 1000),
-                .touchID = libinput_event_touch_get_seat_slot(te),
-                .pos     = {libinput_event_touch_get_x_transformed(te, 1), libinput_event_touch_get_y_transformed(te, 1)},
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .touchID = record.touch.slot,
+                .pos     = {record.touch.x, record.touch.y},
             });
             break;
         }
         case LIBINPUT_EVENT_TOUCH_CANCEL: {
-            auto te = libinput_event_get_touch_event(e);
+            if (BATCH)
+                hlDevice->flushTouchBatch();
+
             hlDevice->touch->events.cancel.emit(ITouch::SCancelEvent{
-                .timeMs  = (uint32_t)(libinput_event_touch_get_time_usec(te) / 1000),
-                .touchID = libinput_event_touch_get_seat_slot(te),
+                .timeMs  = TIMEMS,
+                .timeUs  = record.timeUs,
+                .touchID = record.touch.slot,
             });
             break;
         }
         case LIBINPUT_EVENT_TOUCH_FRAME: {
-            auto te = libinput_event_get_touch_event(e);
+            if (BATCH)
+                hlDevice->flushTouchBatch();
             hlDevice->touch->events.frame.emit();
             break;
         }
@@ -634,21 +1365,20 @@ void Aquamarine::CSession::handleLibinputEvent(libinput_event* e) {
             // --------- switch
 
         case LIBINPUT_EVENT_SWITCH_TOGGLE: {
-            auto       se = libinput_event_get_switch_event(e);
-
-            const bool ENABLED = libinput_event_switch_get_switch_state(se) == LIBINPUT_SWITCH_STATE_ON;
+            const bool ENABLED = record.toggle.on;
 
             if (ENABLED == hlDevice->switchy->state)
                 return;
             hlDevice->switchy->state = ENABLED;
 
-            switch (libinput_event_switch_get_switch(se)) {
+            switch (record.toggle.which) {
                 case LIBINPUT_SWITCH_LID: hlDevice->switchy->type = ISwitch::AQ_SWITCH_TYPE_LID; break;
                 case LIBINPUT_SWITCH_TABLET_MODE: hlDevice->switchy->type = ISwitch::AQ_SWITCH_TYPE_TABLET_MODE; break;
             }
 
             hlDevice->switchy->events.fire.emit(ISwitch::SFireEvent{
-                .timeMs = (uint32_t)(libinput_event_switch_get_time_usec(se) / 1000),
+                .timeMs = TIMEMS,
+                .timeUs = record.timeUs,
                 .type   = hlDevice->switchy->type,
                 .enable = ENABLED,
             });
@@ -658,59 +1388,53 @@ void Aquamarine::CSession::handleLibinputEvent(libinput_event* e) {
             // --------- tbalet
 
         case LIBINPUT_EVENT_TABLET_PAD_BUTTON: {
-            auto tpe = libinput_event_get_tablet_pad_event(e);
-
             hlDevice->tabletPad->events.button.emit(ITabletPad::SButtonEvent{
-                .timeMs = (uint32_t)(libinput_event_tablet_pad_get_time_usec(tpe) / 1000),
-                .button = libinput_event_tablet_pad_get_button_number(tpe),
-                .down   = libinput_event_tablet_pad_get_button_state(tpe) == LIBINPUT_BUTTON_STATE_PRESSED,
-                .mode   = (uint16_t)libinput_event_tablet_pad_get_mode(tpe),
-                .group  = (uint16_t)libinput_tablet_pad_mode_group_get_index(libinput_event_tablet_pad_get_mode_group(tpe)),
+                .timeMs = TIMEMS,
+                .timeUs = record.timeUs,
+                .button = record.pad.button,
+                .down   = record.pad.pressed,
+                .mode   = record.pad.mode,
+                .group  = record.pad.group,
             });
             break;
         }
         case LIBINPUT_EVENT_TABLET_PAD_RING: {
-            auto tpe = libinput_event_get_tablet_pad_event(e);
-
             hlDevice->tabletPad->events.ring.emit(ITabletPad::SRingEvent{
-                .timeMs = (uint32_t)(libinput_event_tablet_pad_get_time_usec(tpe) / 1000),
-                .source = libinput_event_tablet_pad_get_ring_source(tpe) == LIBINPUT_TABLET_PAD_RING_SOURCE_UNKNOWN ? ITabletPad::AQ_TABLET_PAD_RING_SOURCE_UNKNOWN :
-                                                                                                                      ITabletPad::AQ_TABLET_PAD_RING_SOURCE_FINGER,
-                .ring   = (uint16_t)libinput_event_tablet_pad_get_ring_number(tpe),
-                .pos    = libinput_event_tablet_pad_get_ring_position(tpe),
-                .mode   = (uint16_t)libinput_event_tablet_pad_get_mode(tpe),
+                .timeMs = TIMEMS,
+                .timeUs = record.timeUs,
+                .source = record.pad.unknownSource ? ITabletPad::AQ_TABLET_PAD_RING_SOURCE_UNKNOWN : ITabletPad::AQ_TABLET_PAD_RING_SOURCE_FINGER,
+                .ring   = (uint16_t)record.pad.number,
+                .pos    = record.pad.pos,
+                .mode   = record.pad.mode,
             });
             break;
         }
         case LIBINPUT_EVENT_TABLET_PAD_STRIP: {
-            auto tpe = libinput_event_get_tablet_pad_event(e);
-
             hlDevice->tabletPad->events.strip.emit(ITabletPad::SStripEvent{
-                .timeMs = (uint32_t)(libinput_event_tablet_pad_get_time_usec(tpe) / 1000),
-                .source = libinput_event_tablet_pad_get_strip_source(tpe) == LIBINPUT_TABLET_PAD_STRIP_SOURCE_UNKNOWN ? ITabletPad::AQ_TABLET_PAD_STRIP_SOURCE_UNKNOWN :
-                                                                                                                        ITabletPad::AQ_TABLET_PAD_STRIP_SOURCE_FINGER,
-                .strip  = (uint16_t)libinput_event_tablet_pad_get_strip_number(tpe),
-                .pos    = libinput_event_tablet_pad_get_strip_position(tpe),
-                .mode   = (uint16_t)libinput_event_tablet_pad_get_mode(tpe),
+                .timeMs = TIMEMS,
+                .timeUs = record.timeUs,
+                .source = record.pad.unknownSource ? ITabletPad::AQ_TABLET_PAD_STRIP_SOURCE_UNKNOWN : ITabletPad::AQ_TABLET_PAD_STRIP_SOURCE_FINGER,
+                .strip  = (uint16_t)record.pad.number,
+                .pos    = record.pad.pos,
+                .mode   = record.pad.mode,
             });
             break;
         }
 
         case LIBINPUT_EVENT_TABLET_TOOL_PROXIMITY: {
-            auto tte  = libinput_event_get_tablet_tool_event(e);
-            auto tool = hlDevice->toolFrom(libinput_event_tablet_tool_get_tool(tte));
+            // batched axes go out before anything else of the tablet
+            if (BATCH)
+                hlDevice->flushTabletBatch();
 
             hlDevice->tablet->events.proximity.emit(ITablet::SProximityEvent{
                 .tool     = tool,
-                .timeMs   = (uint32_t)(libinput_event_tablet_tool_get_time_usec(tte) / 1000),
-                .absolute = {libinput_event_tablet_tool_get_x_transformed(tte, 1), libinput_event_tablet_tool_get_y_transformed(tte, 1)},
-                .in       = libinput_event_tablet_tool_get_proximity_state(tte) == LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_IN,
+                .timeMs   = TIMEMS,
+                .timeUs   = record.timeUs,
+                .absolute = {record.tablet.x, record.tablet.y},
+                .in       = record.tablet.in,
             });
 
-            destroyTool = !libinput_tablet_tool_is_unique(libinput_event_tablet_tool_get_tool(tte)) &&
-                libinput_event_tablet_tool_get_proximity_state(tte) == LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_OUT;
-
-            if (libinput_event_tablet_tool_get_proximity_state(tte) == LIBINPUT_TABLET_TOOL_PROXIMITY_STATE_OUT) {
+            if (!record.tablet.in) {
                 std::erase(hlDevice->tabletTools, tool);
                 break;
             }
@@ -718,81 +1442,86 @@ void Aquamarine::CSession::handleLibinputEvent(libinput_event* e) {
             // fallthrough. If this is proximity in, also process axis.
         }
         case LIBINPUT_EVENT_TABLET_TOOL_AXIS: {
-            auto                tte  = libinput_event_get_tablet_tool_event(e);
-            auto                tool = hlDevice->toolFrom(libinput_event_tablet_tool_get_tool(tte));
+            const auto&         t = record.tablet;
 
             ITablet::SAxisEvent event = {
-                .tool   = tool,
-                .timeMs = (uint32_t)(libinput_event_tablet_tool_get_time_usec(tte) / 1000),
+                .tool        = tool,
+                .timeMs      = TIMEMS,
+                .timeUs      = record.timeUs,
+                .updatedAxes = t.updatedAxes,
             };
 
-            if (libinput_event_tablet_tool_x_has_changed(tte)) {
-                event.updatedAxes |= AQ_TABLET_TOOL_AXIS_X;
-                event.absolute.x = libinput_event_tablet_tool_get_x_transformed(tte, 1);
-                event.delta.x    = libinput_event_tablet_tool_get_dx(tte);
-            }
-            if (libinput_event_tablet_tool_y_has_changed(tte)) {
-                event.updatedAxes |= AQ_TABLET_TOOL_AXIS_Y;
-                event.absolute.y = libinput_event_tablet_tool_get_y_transformed(tte, 1);
-                event.delta.y    = libinput_event_tablet_tool_get_dy(tte);
-            }
-            if (libinput_event_tablet_tool_pressure_has_changed(tte)) {
-                event.updatedAxes |= AQ_TABLET_TOOL_AXIS_PRESSURE;
-                event.pressure = libinput_event_tablet_tool_get_pressure(tte);
-            }
-            if (libinput_event_tablet_tool_distance_has_changed(tte)) {
-                event.updatedAxes |= AQ_TABLET_TOOL_AXIS_DISTANCE;
-                event.distance = libinput_event_tablet_tool_get_distance(tte);
-            }
-            if (libinput_event_tablet_tool_tilt_x_has_changed(tte)) {
-                event.updatedAxes |= AQ_TABLET_TOOL_AXIS_TILT_X;
-                event.tilt.x = libinput_event_tablet_tool_get_tilt_x(tte);
+            if (t.updatedAxes & AQ_TABLET_TOOL_AXIS_X) {
+                event.absolute.x = t.x;
+                event.delta.x    = t.dx;
             }
-            if (libinput_event_tablet_tool_tilt_y_has_changed(tte)) {
-                event.updatedAxes |= AQ_TABLET_TOOL_AXIS_TILT_Y;
-                event.tilt.y = libinput_event_tablet_tool_get_tilt_y(tte);
+            if (t.updatedAxes & AQ_TABLET_TOOL_AXIS_Y) {
+                event.absolute.y = t.y;
+                event.delta.y    = t.dy;
             }
-            if (libinput_event_tablet_tool_rotation_has_changed(tte)) {
-                event.updatedAxes |= AQ_TABLET_TOOL_AXIS_ROTATION;
-                event.rotation = libinput_event_tablet_tool_get_rotation(tte);
-            }
-            if (libinput_event_tablet_tool_slider_has_changed(tte)) {
-                event.updatedAxes |= AQ_TABLET_TOOL_AXIS_SLIDER;
-                event.slider = libinput_event_tablet_tool_get_slider_position(tte);
-            }
-            if (libinput_event_tablet_tool_wheel_has_changed(tte)) {
-                event.updatedAxes |= AQ_TABLET_TOOL_AXIS_WHEEL;
-                event.wheelDelta = libinput_event_tablet_tool_get_wheel_delta(tte);
-            }
-
-            hlDevice->tablet->events.axis.emit(event);
-
-            if (destroyTool)
-                std::erase(hlDevice->tabletTools, tool);
+            if (t.updatedAxes & AQ_TABLET_TOOL_AXIS_PRESSURE)
+                event.pressure = t.pressure;
+            if (t.updatedAxes & AQ_TABLET_TOOL_AXIS_DISTANCE)
+                event.distance = t.distance;
+            if (t.updatedAxes & AQ_TABLET_TOOL_AXIS_TILT_X)
+                event.tilt.x = t.tiltX;
+            if (t.updatedAxes & AQ_TABLET_TOOL_AXIS_TILT_Y)
+                event.tilt.y = t.tiltY;
+            if (t.updatedAxes & AQ_TABLET_TOOL_AXIS_ROTATION)
+                event.rotation = t.rotation;
+            if (t.updatedAxes & AQ_TABLET_TOOL_AXIS_SLIDER)
+                event.slider = t.slider;
+            if (t.updatedAxes & AQ_TABLET_TOOL_AXIS_WHEEL)
+                event.wheelDelta = t.wheelDelta;
+
+            if (BATCH) {
+                auto& pending = hlDevice->pendingTablet;
+                if (pending.tool != tool) {
+                    hlDevice->flushTabletBatch();
+                    pending.tool = tool;
+                }
+
+                pending.timeUs.emplace_back(event.timeUs);
+                pending.updatedAxes.emplace_back(event.updatedAxes);
+                pending.x.emplace_back(t.x);
+                pending.y.emplace_back(t.y);
+                pending.dx.emplace_back(t.dx);
+                pending.dy.emplace_back(t.dy);
+                pending.tiltX.emplace_back(t.tiltX);
+                pending.tiltY.emplace_back(t.tiltY);
+                pending.pressure.emplace_back(t.pressure);
+                pending.distance.emplace_back(t.distance);
+                pending.rotation.emplace_back(t.rotation);
+                pending.slider.emplace_back(t.slider);
+                pending.wheelDelta.emplace_back(t.wheelDelta);
+            } else
+                hlDevice->tablet->events.axis.emit(event);
 
             break;
         }
         case LIBINPUT_EVENT_TABLET_TOOL_TIP: {
-            auto tte  = libinput_event_get_tablet_tool_event(e);
-            auto tool = hlDevice->toolFrom(libinput_event_tablet_tool_get_tool(tte));
+            if (BATCH)
+                hlDevice->flushTabletBatch();
 
             hlDevice->tablet->events.tip.emit(ITablet::STipEvent{
                 .tool     = tool,
-                .timeMs   = (uint32_t)(libinput_event_tablet_tool_get_time_usec(tte) / 1000),
-                .absolute = {libinput_event_tablet_tool_get_x_transformed(tte, 1), libinput_event_tablet_tool_get_y_transformed(tte, 1)},
-                .down     = libinput_event_tablet_tool_get_tip_state(tte) == LIBINPUT_TABLET_TOOL_TIP_DOWN,
+                .timeMs   = TIMEMS,
+                .timeUs   = record.timeUs,
+                .absolute = {record.tablet.x, record.tablet.y},
+                .down     = record.tablet.down,
             });
             break;
         }
         case LIBINPUT_EVENT_TABLET_TOOL_BUTTON: {
-            auto tte  = libinput_event_get_tablet_tool_event(e);
-            auto tool = hlDevice->toolFrom(libinput_event_tablet_tool_get_tool(tte));
+            if (BATCH)
+                hlDevice->flushTabletBatch();
 
             hlDevice->tablet->events.button.emit(ITablet::SButtonEvent{
                 .tool   = tool,
-                .timeMs = (uint32_t)(libinput_event_tablet_tool_get_time_usec(tte) / 1000),
-                .button = libinput_event_tablet_tool_get_button(tte),
-                .down   = libinput_event_tablet_tool_get_button_state(tte) == LIBINPUT_BUTTON_STATE_PRESSED,
+                .timeMs = TIMEMS,
+                .timeUs = record.timeUs,
+                .button = record.tablet.button,
+                .down   = record.tablet.pressed,
             });
             break;
         }
@@ -810,7 +1539,7 @@ void Aquamarine::CLibinputDevice::init() {
     const auto PRODUCT = libinput_device_get_id_product(device);
     const auto NAME    = libinput_device_get_name(device);
 
-    session->backend->log(AQ_LOG_DEBUG, std::format("libinput: New device {}: {}-{}", NAME ? NAME : "Unknown", VENDOR, PRODUCT));
+    AQLOG(session->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_SESSION, std::format("libinput: New device {}: {}-{}", NAME ? NAME : "Unknown", VENDOR, PRODUCT));
 
     name = NAME;
 
@@ -859,12 +1588,119 @@ Aquamarine::CLibinputDevice::~CLibinputDevice() {
     libinput_device_unref(device);
 }
 
-SP<CLibinputTabletTool> Aquamarine::CLibinputDevice::toolFrom(libinput_tablet_tool* tool) {
+void Aquamarine::CLibinputDevice::flushMotion() {
+    if (!mouse)
+        return;
+
+    if (pendingMotion.hasMove) {
+        pendingMotion.hasMove      = false;
+        pendingMotion.move.samples = pendingMotion.samples;
+        mouse->events.move.emit(pendingMotion.move);
+        mouse->events.frame.emit();
+        pendingMotion.move.samples = {};
+        pendingMotion.samples.clear();
+    }
+
+    if (pendingMotion.hasWarp) {
+        pendingMotion.hasWarp = false;
+        mouse->events.warp.emit(pendingMotion.warp);
+        mouse->events.frame.emit();
+    }
+}
+
+void Aquamarine::CLibinputDevice::SStats::reset() {
+    *this = {};
+}
+
+size_t Aquamarine::CLibinputDevice::SStats::slotFor(uint32_t type) {
+    const size_t GROUP = type / 100, N = type % 100;
+    if (GROUP >= TYPE_GROUPS || N >= TYPES_PER_GROUP)
+        return 0;
+
+    return GROUP * TYPES_PER_GROUP + N;
+}
+
+uint64_t Aquamarine::CLibinputDevice::SStats::eventsOfType(uint32_t type) const {
+    return eventsByType[slotFor(type)];
+}
+
+std::string Aquamarine::CLibinputDevice::dumpStats() const {
+    std::string out = std::format("{}: {} events in {} dispatches, {:.2f}ms handling them (worst dispatch: {} events, {:.2f}ms), latency avg {}µs p99 {}µs max {}µs\n",
+                                  name, stats.events, stats.dispatches, stats.handleNs / 1000000.0, stats.maxDispatchEvents, stats.maxDispatchHandleNs / 1000000.0,
+                                  latency.averageUs(), latency.percentileUs(0.99), latency.maxUs);
+
+    for (size_t i = 0; i < stats.eventsByType.size(); ++i) {
+        if (!stats.eventsByType[i])
+            continue;
+
+        out += std::format("  libinput event type {}: {}\n", (i / SStats::TYPES_PER_GROUP) * 100 + i % SStats::TYPES_PER_GROUP, stats.eventsByType[i]);
+    }
+
+    return out;
+}
+
+void Aquamarine::CLibinputDevice::flushTouchBatch() {
+    if (pendingTouch.timeUs.empty())
+        return;
+
+    if (touch)
+        touch->events.moveBatch.emit(ITouch::SMotionBatch{
+            .timeUs  = pendingTouch.timeUs,
+            .touchID = pendingTouch.touchID,
+            .x       = pendingTouch.x,
+            .y       = pendingTouch.y,
+        });
+
+    pendingTouch.timeUs.clear();
+    pendingTouch.touchID.clear();
+    pendingTouch.x.clear();
+    pendingTouch.y.clear();
+}
+
+void Aquamarine::CLibinputDevice::flushTabletBatch() {
+    auto& pending = pendingTablet;
+
+    if (pending.timeUs.empty()) {
+        pending.tool.reset();
+        return;
+    }
+
+    if (tablet)
+        tablet->events.axisBatch.emit(ITablet::SAxisBatch{
+            .tool        = pending.tool,
+            .timeUs      = pending.timeUs,
+            .updatedAxes = pending.updatedAxes,
+            .x           = pending.x,
+            .y           = pending.y,
+            .dx          = pending.dx,
+            .dy          = pending.dy,
+            .tiltX       = pending.tiltX,
+            .tiltY       = pending.tiltY,
+            .pressure    = pending.pressure,
+            .distance    = pending.distance,
+            .rotation    = pending.rotation,
+            .slider      = pending.slider,
+            .wheelDelta  = pending.wheelDelta,
+        });
+
+    pending.tool.reset();
+    for (auto v : {&pending.x, &pending.y, &pending.dx, &pending.dy, &pending.tiltX, &pending.tiltY, &pending.pressure, &pending.distance, &pending.rotation, &pending.slider,
+                   &pending.wheelDelta}) {
+        v->clear();
+    }
+    pending.timeUs.clear();
+    pending.updatedAxes.clear();
+}
+
+SP<CLibinputTabletTool> Aquamarine::CLibinputDevice::toolFrom(libinput_tablet_tool* tool, bool create) {
     for (auto& t : tabletTools) {
         if (t->libinputTool == tool)
             return t;
     }
 
+    if (!create)
+        return nullptr;
+
     auto newt = makeShared<CLibinputTabletTool>(self.lock(), tool);
     tabletTools.emplace_back(newt);
     if (session->backend->ready)
@@ -903,6 +1739,7 @@ const std::string& Aquamarine::CLibinputKeyboard::getName() {
 }
 
 void Aquamarine::CLibinputKeyboard::updateLEDs(uint32_t leds) {
+    auto lk = device->session->lockLibinput();
     libinput_device_led_update(device->device, (libinput_led)leds);
 }
 
@@ -8,13 +8,51 @@
 #include <gbm.h>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <linux/dma-buf.h>
 #include <unistd.h>
+#include <array>
+#include <algorithm>
 
 using namespace Aquamarine;
 using namespace Hyprutils::Memory;
 using namespace Hyprutils::Math;
 #define SP CSharedPointer
 
+// past this many rects a damage_buffer request each costs more than it saves the host
+static const size_t MAX_DAMAGE_RECTS = 16;
+// an animated cursor can be written while the host still holds the last frames
+static const size_t CURSOR_SHM_SLOTS     = 4;
+static const size_t CURSOR_SHM_MAX_SLOTS = 16; // past this the host isn't releasing them, and cursor updates wait for it
+
+// host timestamps are in the host's presentation clock, consumers expect CLOCK_MONOTONIC like from DRM
+static timespec toMonotonic(const timespec& t, clockid_t clock) {
+    if (clock == CLOCK_MONOTONIC)
+        return t;
+
+    timespec nowHost, nowMono;
+    clock_gettime(clock, &nowHost);
+    clock_gettime(CLOCK_MONOTONIC, &nowMono);
+
+    const auto NS = [](const timespec& ts) { return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec; };
+    const auto R  = NS(t) - NS(nowHost) + NS(nowMono);
+    return {.tv_sec = (time_t)(R / 1000000000), .tv_nsec = (long)(R % 1000000000)};
+}
+
+// AQ_WAYLAND_RENDER_SCALE, see docs/env.md
+static double renderScale() {
+    static const double SCALE = []() {
+        const auto ENV = getenv("AQ_WAYLAND_RENDER_SCALE");
+        if (!ENV)
+            return 1.0;
+
+        const double S = strtod(ENV, nullptr);
+        return S > 0.0 ? S : 1.0;
+    }();
+
+    return SCALE;
+}
+
 static std::pair<int, std::string> openExclusiveShm() {
     // Only absolute paths can be shared across different shm_open() calls
     srand(time(nullptr));
@@ -29,6 +67,15 @@ static std::pair<int, std::string> openExclusiveShm() {
     return {-1, ""};
 }
 
+static bool resizeSHMFile(int fd, size_t len) {
+    int ret;
+    do {
+        ret = ftruncate(fd, len);
+    } while (ret < 0 && errno == EINTR);
+
+    return ret >= 0;
+}
+
 static int allocateSHMFile(size_t len) {
     auto [fd, name] = openExclusiveShm();
     if (fd < 0)
@@ -36,12 +83,7 @@ static int allocateSHMFile(size_t len) {
 
     shm_unlink(name.c_str());
 
-    int ret;
-    do {
-        ret = ftruncate(fd, len);
-    } while (ret < 0 && errno == EINTR);
-
-    if (ret < 0) {
+    if (!resizeSHMFile(fd, len)) {
         close(fd);
         return -1;
     }
@@ -73,54 +115,80 @@ Aquamarine::CWaylandBackend::CWaylandBackend(SP<CBackend> backend_) : backend(ba
 }
 
 bool Aquamarine::CWaylandBackend::start() {
-    backend->log(AQ_LOG_DEBUG, "Starting the Wayland backend!");
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, "Starting the Wayland backend!");
 
     waylandState.display = wl_display_connect(nullptr);
 
     if (!waylandState.display) {
-        backend->log(AQ_LOG_ERROR, "Wayland backend cannot start: wl_display_connect failed (is a wayland compositor running?)");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, "Wayland backend cannot start: wl_display_connect failed (is a wayland compositor running?)");
         return false;
     }
 
     waylandState.registry = makeShared<CCWlRegistry>((wl_proxy*)wl_display_get_registry(waylandState.display));
 
-    backend->log(AQ_LOG_DEBUG, std::format("Got registry at 0x{:x}", (uintptr_t)waylandState.registry->resource()));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("Got registry at 0x{:x}", (uintptr_t)waylandState.registry->resource()));
 
     waylandState.registry->setGlobal([this](CCWlRegistry* r, uint32_t id, const char* name, uint32_t version) {
-        TRACE(backend->log(AQ_LOG_TRACE, std::format(" | received global: {} (version {}) with id {}", name, version, id)));
+        TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format(" | received global: {} (version {}) with id {}", name, version, id)));
 
         const std::string NAME = name;
 
         if (NAME == "wl_seat") {
-            TRACE(backend->log(AQ_LOG_TRACE, std::format("  > binding to global: {} (version {}) with id {}", name, 9, id)));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 9, id)));
             waylandState.seat = makeShared<CCWlSeat>((wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &wl_seat_interface, 9));
             initSeat();
         } else if (NAME == "xdg_wm_base") {
-            TRACE(backend->log(AQ_LOG_TRACE, std::format("  > binding to global: {} (version {}) with id {}", name, 6, id)));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 6, id)));
             waylandState.xdg = makeShared<CCXdgWmBase>((wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &xdg_wm_base_interface, 6));
             initShell();
         } else if (NAME == "wl_compositor") {
-            TRACE(backend->log(AQ_LOG_TRACE, std::format("  > binding to global: {} (version {}) with id {}", name, 6, id)));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 6, id)));
             waylandState.compositor = makeShared<CCWlCompositor>((wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &wl_compositor_interface, 6));
         } else if (NAME == "wl_shm") {
-            TRACE(backend->log(AQ_LOG_TRACE, std::format("  > binding to global: {} (version {}) with id {}", name, 1, id)));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 1, id)));
             waylandState.shm = makeShared<CCWlShm>((wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &wl_shm_interface, 1));
         } else if (NAME == "zwp_linux_dmabuf_v1") {
-            TRACE(backend->log(AQ_LOG_TRACE, std::format("  > binding to global: {} (version {}) with id {}", name, 4, id)));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 4, id)));
             waylandState.dmabuf =
                 makeShared<CCZwpLinuxDmabufV1>((wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &zwp_linux_dmabuf_v1_interface, 4));
             if (!initDmabuf()) {
-                backend->log(AQ_LOG_ERROR, "Wayland backend cannot start: zwp_linux_dmabuf_v1 init failed");
+                AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, "Wayland backend cannot start: zwp_linux_dmabuf_v1 init failed");
                 waylandState.dmabufFailed = true;
             }
+        } else if (NAME == "zwp_relative_pointer_manager_v1") {
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 1, id)));
+            waylandState.relativePointerManager = makeShared<CCZwpRelativePointerManagerV1>(
+                (wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &zwp_relative_pointer_manager_v1_interface, 1));
+            for (auto& p : pointers) {
+                p->bindRelative();
+            }
+        } else if (NAME == "wp_presentation") {
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 1, id)));
+            waylandState.presentation =
+                makeShared<CCWpPresentation>((wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &wp_presentation_interface, 1));
+            waylandState.presentation->setClockId([this](CCWpPresentation* r, uint32_t clockID) {
+                AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("wp_presentation: host clock is {}", clockID));
+                waylandState.presentationClock = clockID;
+            });
+        } else if (NAME == "wp_viewporter") {
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 1, id)));
+            waylandState.viewporter = makeShared<CCWpViewporter>((wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &wp_viewporter_interface, 1));
+        } else if (NAME == "wp_fractional_scale_manager_v1") {
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 1, id)));
+            waylandState.fractionalScaleManager = makeShared<CCWpFractionalScaleManagerV1>(
+                (wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &wp_fractional_scale_manager_v1_interface, 1));
+        } else if (NAME == "wp_linux_drm_syncobj_manager_v1") {
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("  > binding to global: {} (version {}) with id {}", name, 1, id)));
+            waylandState.syncobjManager = makeShared<CCWpLinuxDrmSyncobjManagerV1>(
+                (wl_proxy*)wl_registry_bind((wl_registry*)waylandState.registry->resource(), id, &wp_linux_drm_syncobj_manager_v1_interface, 1));
         }
     });
-    waylandState.registry->setGlobalRemove([this](CCWlRegistry* r, uint32_t id) { backend->log(AQ_LOG_DEBUG, std::format("Global {} removed", id)); });
+    waylandState.registry->setGlobalRemove([this](CCWlRegistry* r, uint32_t id) { AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("Global {} removed", id)); });
 
     wl_display_roundtrip(waylandState.display);
 
     if (!waylandState.xdg || !waylandState.compositor || !waylandState.seat || !waylandState.dmabuf || waylandState.dmabufFailed || !waylandState.shm) {
-        backend->log(AQ_LOG_ERROR, "Wayland backend cannot start: Missing protocols");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, "Wayland backend cannot start: Missing protocols");
         return false;
     }
 
@@ -190,7 +258,7 @@ void Aquamarine::CWaylandBackend::onReady() {
     for (auto& o : outputs) {
         o->swapchain = CSwapchain::create(backend->primaryAllocator, self.lock());
         if (!o->swapchain) {
-            backend->log(AQ_LOG_ERROR, std::format("Output {} failed: swapchain creation failed", o->name));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {} failed: swapchain creation failed", o->name));
             continue;
         }
     }
@@ -200,11 +268,12 @@ Aquamarine::CWaylandKeyboard::CWaylandKeyboard(SP<CCWlKeyboard> keyboard_, Hypru
     if (!keyboard->resource())
         return;
 
-    backend->backend->log(AQ_LOG_DEBUG, "New wayland keyboard wl_keyboard");
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, "New wayland keyboard wl_keyboard");
 
     keyboard->setKey([this](CCWlKeyboard* r, uint32_t serial, uint32_t timeMs, uint32_t key, wl_keyboard_key_state state) {
         events.key.emit(SKeyEvent{
             .timeMs  = timeMs,
+            .timeUs  = (uint64_t)timeMs * 1000,
             .key     = key,
             .pressed = state == WL_KEYBOARD_KEY_STATE_PRESSED,
         });
@@ -232,26 +301,14 @@ Aquamarine::CWaylandPointer::CWaylandPointer(SP<CCWlPointer> pointer_, Hyprutils
     if (!pointer->resource())
         return;
 
-    backend->backend->log(AQ_LOG_DEBUG, "New wayland pointer wl_pointer");
-
-    pointer->setMotion([this](CCWlPointer* r, uint32_t serial, wl_fixed_t x, wl_fixed_t y) {
-        const auto STATE = backend->focusedOutput->state->state();
-
-        if (!backend->focusedOutput || (!STATE.mode && !STATE.customMode))
-            return;
-
-        const Vector2D size = STATE.customMode ? STATE.customMode->pixelSize : STATE.mode->pixelSize;
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, "New wayland pointer wl_pointer");
 
-        Vector2D       local = {wl_fixed_to_double(x), wl_fixed_to_double(y)};
-        local                = local / size;
+    pointer->setMotion([this](CCWlPointer* r, uint32_t timeMs, wl_fixed_t x, wl_fixed_t y) {
+        lastTimeMs = timeMs;
 
-        timespec now;
-        clock_gettime(CLOCK_MONOTONIC, &now);
-
-        events.warp.emit(SWarpEvent{
-            .timeMs   = (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000),
-            .absolute = local,
-        });
+        // one source per host motion: with a relative pointer, the moves come from it and only enter warps
+        if (!relativePointer)
+            warpTo(timeMs, x, y);
     });
 
     pointer->setEnter([this](CCWlPointer* r, uint32_t serial, wl_proxy* surface, wl_fixed_t x, wl_fixed_t y) {
@@ -262,10 +319,13 @@ Aquamarine::CWaylandPointer::CWaylandPointer(SP<CCWlPointer> pointer_, Hyprutils
                 continue;
 
             backend->focusedOutput = o;
-            backend->backend->log(AQ_LOG_DEBUG, std::format("[wayland] focus changed: {}", o->name));
+            AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("[wayland] focus changed: {}", o->name));
             o->onEnter(pointer, serial);
             break;
         }
+
+        // relative moves only make sense from where the pointer came in. Enter has no timestamp, go with the last one.
+        warpTo(lastTimeMs, x, y);
     });
 
     pointer->setLeave([this](CCWlPointer* r, uint32_t serial, wl_proxy* surface) {
@@ -278,26 +338,77 @@ Aquamarine::CWaylandPointer::CWaylandPointer(SP<CCWlPointer> pointer_, Hyprutils
     });
 
     pointer->setButton([this](CCWlPointer* r, uint32_t serial, uint32_t timeMs, uint32_t button, wl_pointer_button_state state) {
+        lastTimeMs = timeMs;
         events.button.emit(SButtonEvent{
             .timeMs  = timeMs,
+            .timeUs  = (uint64_t)timeMs * 1000,
             .button  = button,
             .pressed = state == WL_POINTER_BUTTON_STATE_PRESSED,
         });
     });
 
     pointer->setAxis([this](CCWlPointer* r, uint32_t timeMs, wl_pointer_axis axis, wl_fixed_t value) {
+        lastTimeMs = timeMs;
         events.axis.emit(SAxisEvent{
             .timeMs = timeMs,
+            .timeUs = (uint64_t)timeMs * 1000,
             .axis   = axis == WL_POINTER_AXIS_HORIZONTAL_SCROLL ? AQ_POINTER_AXIS_HORIZONTAL : AQ_POINTER_AXIS_VERTICAL,
             .delta  = wl_fixed_to_double(value),
         });
     });
 
     pointer->setFrame([this](CCWlPointer* r) { events.frame.emit(); });
+
+    bindRelative();
 }
 
 Aquamarine::CWaylandPointer::~CWaylandPointer() {
-    ;
+    if (relativePointer)
+        relativePointer->sendDestroy();
+}
+
+void Aquamarine::CWaylandPointer::bindRelative() {
+    if (relativePointer || !backend->waylandState.relativePointerManager)
+        return;
+
+    relativePointer = makeShared<CCZwpRelativePointerV1>(backend->waylandState.relativePointerManager->sendGetRelativePointer(pointer->resource()));
+
+    if (!relativePointer->resource()) {
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, "zwp_relative_pointer_v1: failed to get a relative pointer");
+        relativePointer.reset();
+        return;
+    }
+
+    relativePointer->setRelativeMotion(
+        [this](CCZwpRelativePointerV1* r, uint32_t utimeHi, uint32_t utimeLo, wl_fixed_t dx, wl_fixed_t dy, wl_fixed_t dxUnaccel, wl_fixed_t dyUnaccel) {
+            const uint64_t TIMEUS = ((uint64_t)utimeHi << 32) | utimeLo;
+
+            // deltas are surface-local, the consumer renders in buffer pixels (they differ with a viewport)
+            Vector2D scale  = {1, 1};
+            auto     output = backend->focusedOutput.lock();
+            if (output && output->surfaceSize.x > 0 && output->surfaceSize.y > 0 && output->bufferSize.x > 0 && output->bufferSize.y > 0)
+                scale = output->bufferSize / output->surfaceSize;
+
+            events.move.emit(SMoveEvent{
+                .timeMs  = (uint32_t)(TIMEUS / 1000),
+                .timeUs  = TIMEUS,
+                .delta   = Vector2D{wl_fixed_to_double(dx), wl_fixed_to_double(dy)} * scale,
+                .unaccel = Vector2D{wl_fixed_to_double(dxUnaccel), wl_fixed_to_double(dyUnaccel)} * scale,
+            });
+        });
+}
+
+void Aquamarine::CWaylandPointer::warpTo(uint32_t timeMs, wl_fixed_t x, wl_fixed_t y) {
+    auto output = backend->focusedOutput.lock();
+    if (!output || output->surfaceSize.x <= 0 || output->surfaceSize.y <= 0)
+        return;
+
+    // wl_pointer only has ms precision
+    events.warp.emit(SWarpEvent{
+        .timeMs   = timeMs,
+        .timeUs   = (uint64_t)timeMs * 1000,
+        .absolute = Vector2D{wl_fixed_to_double(x), wl_fixed_to_double(y)} / output->surfaceSize,
+    });
 }
 
 const std::string& Aquamarine::CWaylandPointer::getName() {
@@ -327,28 +438,140 @@ void Aquamarine::CWaylandBackend::initShell() {
     waylandState.xdg->setPing([](CCXdgWmBase* r, uint32_t serial) { r->sendPong(serial); });
 }
 
+Aquamarine::CWaylandDmabufFeedback::CWaylandDmabufFeedback(SP<CCZwpLinuxDmabufFeedbackV1> feedback_, Hyprutils::Memory::CWeakPointer<CWaylandBackend> backend_) :
+    feedback(feedback_), backend(backend_) {
+    feedback->setFormatTable([this](CCZwpLinuxDmabufFeedbackV1* r, int32_t fd, uint32_t size) {
+#pragma pack(push, 1)
+        struct wlDrmFormatMarshalled {
+            uint32_t drmFormat;
+            char     pad[4];
+            uint64_t modifier;
+        };
+#pragma pack(pop)
+        static_assert(sizeof(wlDrmFormatMarshalled) == 16);
+
+        auto formatTable = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (formatTable == MAP_FAILED) {
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("zwp_linux_dmabuf_v1: Failed to mmap the format table"));
+            return;
+        }
+
+        const auto FORMATS = (wlDrmFormatMarshalled*)formatTable;
+
+        table.clear();
+        table.reserve(size / 16);
+        for (size_t i = 0; i < size / 16; ++i) {
+            table.emplace_back(FORMATS[i].drmFormat, FORMATS[i].modifier);
+        }
+
+        munmap(formatTable, size);
+    });
+
+    feedback->setMainDevice([this](CCZwpLinuxDmabufFeedbackV1* r, wl_array* deviceArr) {
+        ASSERT(deviceArr->size == sizeof(pendingMainDevice));
+        memcpy(&pendingMainDevice, deviceArr->data, sizeof(pendingMainDevice));
+    });
+
+    feedback->setTrancheTargetDevice([this](CCZwpLinuxDmabufFeedbackV1* r, wl_array* deviceArr) {
+        ASSERT(deviceArr->size == sizeof(pendingTranche.device));
+        memcpy(&pendingTranche.device, deviceArr->data, sizeof(pendingTranche.device));
+    });
+
+    feedback->setTrancheFlags([this](CCZwpLinuxDmabufFeedbackV1* r, zwpLinuxDmabufFeedbackV1TrancheFlags flags) {
+        pendingTranche.scanout = flags & ZWP_LINUX_DMABUF_FEEDBACK_V1_TRANCHE_FLAGS_SCANOUT;
+    });
+
+    feedback->setTrancheFormats([this](CCZwpLinuxDmabufFeedbackV1* r, wl_array* indicesArr) {
+        const auto INDICES = (uint16_t*)indicesArr->data;
+
+        for (size_t i = 0; i < indicesArr->size / sizeof(uint16_t); ++i) {
+            if (INDICES[i] >= table.size()) {
+                AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("zwp_linux_dmabuf_v1: tranche format index {} out of bounds", INDICES[i]));
+                continue;
+            }
+
+            const auto& [FORMAT, MODIFIER] = table[INDICES[i]];
+
+            auto it = std::ranges::find_if(pendingTranche.formats, [FORMAT](const auto& e) { return e.drmFormat == FORMAT; });
+            if (it == pendingTranche.formats.end()) {
+                pendingTranche.formats.emplace_back(SDRMFormat{.drmFormat = FORMAT, .modifiers = {MODIFIER}});
+                continue;
+            }
+
+            it->modifiers.emplace_back(MODIFIER);
+        }
+    });
+
+    feedback->setTrancheDone([this](CCZwpLinuxDmabufFeedbackV1* r) {
+        pendingTranches.emplace_back(std::move(pendingTranche));
+        pendingTranche = {};
+    });
+
+    feedback->setDone([this](CCZwpLinuxDmabufFeedbackV1* r) {
+        // every done resends all tranches, the format table and main device only when they changed
+        mainDevice = pendingMainDevice;
+        tranches   = std::move(pendingTranches);
+        pendingTranches.clear();
+
+        if (onDone)
+            onDone();
+    });
+}
+
+Aquamarine::CWaylandDmabufFeedback::~CWaylandDmabufFeedback() {
+    if (feedback)
+        feedback->sendDestroy();
+}
+
+std::vector<SDRMFormat> Aquamarine::CWaylandDmabufFeedback::preferredFormats() const {
+    std::vector<SDRMFormat> result;
+
+    for (const auto& tranche : tranches) {
+        // scanout on some other device is of no use to buffers we render on ours
+        if (tranche.scanout && tranche.device != mainDevice)
+            continue;
+
+        for (const auto& fmt : tranche.formats) {
+            if (std::ranges::any_of(result, [&fmt](const auto& e) { return e.drmFormat == fmt.drmFormat; }))
+                continue;
+
+            result.emplace_back(fmt);
+        }
+    }
+
+    return result;
+}
+
 bool Aquamarine::CWaylandBackend::initDmabuf() {
-    waylandState.dmabufFeedback = makeShared<CCZwpLinuxDmabufFeedbackV1>(waylandState.dmabuf->sendGetDefaultFeedback());
-    if (!waylandState.dmabufFeedback) {
-        backend->log(AQ_LOG_ERROR, "initDmabuf: failed to get default feedback");
+    auto feedback = makeShared<CCZwpLinuxDmabufFeedbackV1>(waylandState.dmabuf->sendGetDefaultFeedback());
+    if (!feedback->resource()) {
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, "initDmabuf: failed to get default feedback");
         return false;
     }
 
-    waylandState.dmabufFeedback->setDone([this](CCZwpLinuxDmabufFeedbackV1* r) {
-        // no-op
-        backend->log(AQ_LOG_DEBUG, "zwp_linux_dmabuf_v1: Got done");
-    });
+    waylandState.dmabufFeedback         = makeShared<CWaylandDmabufFeedback>(feedback, self);
+    waylandState.dmabufFeedback->onDone = [this]() {
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, "zwp_linux_dmabuf_v1: Got done");
+
+        dmabufFormats = waylandState.dmabufFeedback->preferredFormats();
 
-    waylandState.dmabufFeedback->setMainDevice([this](CCZwpLinuxDmabufFeedbackV1* r, wl_array* deviceArr) {
-        backend->log(AQ_LOG_DEBUG, "zwp_linux_dmabuf_v1: Got main device");
+        for (const auto& fmt : dmabufFormats) {
+            for (const auto& mod : fmt.modifiers) {
+                auto modName = drmGetFormatModifierName(mod);
+                AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND,
+                      std::format("zwp_linux_dmabuf_v1: Got format {} with modifier {}", fourccToName(fmt.drmFormat), modName ? modName : "UNKNOWN"));
+                free(modName);
+            }
+        }
 
-        dev_t device;
-        ASSERT(deviceArr->size == sizeof(device));
-        memcpy(&device, deviceArr->data, sizeof(device));
+        // the node we render on is picked once, a later main device only changes what the host prefers
+        if (!drmState.nodeName.empty())
+            return;
 
         drmDevice* drmDev;
-        if (drmGetDeviceFromDevId(device, /* flags */ 0, &drmDev) != 0) {
-            backend->log(AQ_LOG_ERROR, "zwp_linux_dmabuf_v1: drmGetDeviceFromDevId failed");
+        if (drmGetDeviceFromDevId(waylandState.dmabufFeedback->mainDevice, /* flags */ 0, &drmDev) != 0) {
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, "zwp_linux_dmabuf_v1: drmGetDeviceFromDevId failed");
             return;
         }
 
@@ -360,11 +583,12 @@ bool Aquamarine::CWaylandBackend::initDmabuf() {
             // Mesa will open the right render node under-the-hood.
             ASSERT(drmDev->available_nodes & (1 << DRM_NODE_PRIMARY));
             name = drmDev->nodes[DRM_NODE_PRIMARY];
-            backend->log(AQ_LOG_WARNING, "zwp_linux_dmabuf_v1: DRM device has no render node, using primary.");
+            AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_WAYLAND, "zwp_linux_dmabuf_v1: DRM device has no render node, using primary.");
         }
 
         if (!name) {
-            backend->log(AQ_LOG_ERROR, "zwp_linux_dmabuf_v1: no node name");
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, "zwp_linux_dmabuf_v1: no node name");
+            drmFreeDevice(&drmDev);
             return;
         }
 
@@ -372,56 +596,22 @@ bool Aquamarine::CWaylandBackend::initDmabuf() {
 
         drmFreeDevice(&drmDev);
 
-        backend->log(AQ_LOG_DEBUG, std::format("zwp_linux_dmabuf_v1: Got node {}", drmState.nodeName));
-    });
-
-    waylandState.dmabufFeedback->setFormatTable([this](CCZwpLinuxDmabufFeedbackV1* r, int32_t fd, uint32_t size) {
-#pragma pack(push, 1)
-        struct wlDrmFormatMarshalled {
-            uint32_t drmFormat;
-            char     pad[4];
-            uint64_t modifier;
-        };
-#pragma pack(pop)
-        static_assert(sizeof(wlDrmFormatMarshalled) == 16);
-
-        auto formatTable = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
-        if (formatTable == MAP_FAILED) {
-            backend->log(AQ_LOG_ERROR, std::format("zwp_linux_dmabuf_v1: Failed to mmap the format table"));
-            return;
-        }
-
-        const auto FORMATS = (wlDrmFormatMarshalled*)formatTable;
-
-        for (size_t i = 0; i < size / 16; ++i) {
-            auto& fmt = FORMATS[i];
-
-            auto  modName = drmGetFormatModifierName(fmt.modifier);
-            backend->log(AQ_LOG_DEBUG, std::format("zwp_linux_dmabuf_v1: Got format {} with modifier {}", fourccToName(fmt.drmFormat), modName ? modName : "UNKNOWN"));
-            free(modName);
-
-            auto it = std::find_if(dmabufFormats.begin(), dmabufFormats.end(), [&fmt](const auto& e) { return e.drmFormat == fmt.drmFormat; });
-            if (it == dmabufFormats.end()) {
-                dmabufFormats.emplace_back(SDRMFormat{.drmFormat = fmt.drmFormat, .modifiers = {fmt.modifier}});
-                continue;
-            }
-
-            it->modifiers.emplace_back(fmt.modifier);
-        }
-
-        munmap(formatTable, size);
-    });
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("zwp_linux_dmabuf_v1: Got node {}", drmState.nodeName));
+    };
 
     wl_display_roundtrip(waylandState.display);
 
     if (!drmState.nodeName.empty()) {
         drmState.fd = open(drmState.nodeName.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
         if (drmState.fd < 0) {
-            backend->log(AQ_LOG_ERROR, std::format("zwp_linux_dmabuf_v1: Failed to open node {}", drmState.nodeName));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("zwp_linux_dmabuf_v1: Failed to open node {}", drmState.nodeName));
             return false;
         }
 
-        backend->log(AQ_LOG_DEBUG, std::format("zwp_linux_dmabuf_v1: opened node {} with fd {}", drmState.nodeName, drmState.fd));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("zwp_linux_dmabuf_v1: opened node {} with fd {}", drmState.nodeName, drmState.fd));
+
+        uint64_t cap               = 0;
+        drmState.supportsTimelines = drmGetCap(drmState.fd, DRM_CAP_SYNCOBJ_TIMELINE, &cap) == 0 && cap == 1;
     }
 
     return true;
@@ -445,35 +635,65 @@ Aquamarine::CWaylandOutput::CWaylandOutput(const std::string& name_, Hyprutils::
     waylandState.surface = makeShared<CCWlSurface>(backend->waylandState.compositor->sendCreateSurface());
 
     if (!waylandState.surface->resource()) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {} failed: no surface given. Errno: {}", name, errno));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {} failed: no surface given. Errno: {}", name, errno));
         return;
     }
 
+    if (backend->waylandState.viewporter) {
+        waylandState.viewport = makeShared<CCWpViewport>(backend->waylandState.viewporter->sendGetViewport(waylandState.surface->resource()));
+
+        // the preferred scale is only of use if the host can scale our buffer to the window
+        if (backend->waylandState.fractionalScaleManager) {
+            waylandState.fractionalScale =
+                makeShared<CCWpFractionalScaleV1>(backend->waylandState.fractionalScaleManager->sendGetFractionalScale(waylandState.surface->resource()));
+            waylandState.fractionalScale->setPreferredScale([this](CCWpFractionalScaleV1* r, uint32_t scale) {
+                preferredScale = scale / 120.0;
+                AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: preferred scale {:.3f}", name, preferredScale));
+                if (windowSize.x > 0 && windowSize.y > 0)
+                    emitPreferredSize();
+            });
+        }
+    }
+
+    auto feedback = makeShared<CCZwpLinuxDmabufFeedbackV1>(backend->waylandState.dmabuf->sendGetSurfaceFeedback(waylandState.surface->resource()));
+    if (feedback->resource()) {
+        waylandState.dmabufFeedback         = makeShared<CWaylandDmabufFeedback>(feedback, backend);
+        waylandState.dmabufFeedback->onDone = [this]() { onSurfaceFeedback(); };
+    }
+
+    // the host only hands back release points, there is no out fence to give the consumer, so supportsExplicit stays off
+    if (backend->waylandState.syncobjManager && backend->drmState.supportsTimelines)
+        supportsExplicitInFence = initExplicitSync();
+
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND,
+          std::format("Output {}: Explicit sync {}", name, supportsExplicitInFence ? "supported for in fences" : "unsupported"));
+
     waylandState.xdgSurface = makeShared<CCXdgSurface>(backend->waylandState.xdg->sendGetXdgSurface(waylandState.surface->resource()));
 
     if (!waylandState.xdgSurface->resource()) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {} failed: no xdgSurface given. Errno: {}", name, errno));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {} failed: no xdgSurface given. Errno: {}", name, errno));
         return;
     }
 
     waylandState.xdgSurface->setConfigure([this](CCXdgSurface* r, uint32_t serial) {
-        backend->backend->log(AQ_LOG_DEBUG, std::format("Output {}: configure surface with {}", name, serial));
+        AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: configure surface with {}", name, serial));
         r->sendAckConfigure(serial);
     });
 
     waylandState.xdgToplevel = makeShared<CCXdgToplevel>(waylandState.xdgSurface->sendGetToplevel());
 
     if (!waylandState.xdgToplevel->resource()) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {} failed: no xdgToplevel given. Errno: {}", name, errno));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {} failed: no xdgToplevel given. Errno: {}", name, errno));
         return;
     }
 
     waylandState.xdgToplevel->setWmCapabilities(
-        [this](CCXdgToplevel* r, wl_array* arr) { backend->backend->log(AQ_LOG_DEBUG, std::format("Output {}: wm_capabilities received", name)); });
+        [this](CCXdgToplevel* r, wl_array* arr) { AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: wm_capabilities received", name)); });
 
     waylandState.xdgToplevel->setConfigure([this](CCXdgToplevel* r, int32_t w, int32_t h, wl_array* arr) {
-        backend->backend->log(AQ_LOG_DEBUG, std::format("Output {}: configure toplevel with {}x{}", name, w, h));
-        events.state.emit(SStateEvent{.size = {w, h}});
+        AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: configure toplevel with {}x{}", name, w, h));
+        windowSize = {w, h};
+        emitPreferredSize();
         sendFrameAndSetCallback();
     });
 
@@ -491,7 +711,7 @@ Aquamarine::CWaylandOutput::CWaylandOutput(const std::string& name_, Hyprutils::
 
     inputRegion->sendDestroy();
 
-    backend->backend->log(AQ_LOG_DEBUG, std::format("Output {}: initialized", name));
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: initialized", name));
 }
 
 Aquamarine::CWaylandOutput::~CWaylandOutput() {
@@ -501,17 +721,61 @@ Aquamarine::CWaylandOutput::~CWaylandOutput() {
         waylandState.xdgToplevel->sendDestroy();
     if (waylandState.xdgSurface)
         waylandState.xdgSurface->sendDestroy();
+    if (waylandState.fractionalScale)
+        waylandState.fractionalScale->sendDestroy();
+    waylandState.dmabufFeedback.reset();
+    if (waylandState.syncobjSurface)
+        waylandState.syncobjSurface->sendDestroy();
+    if (waylandState.acquireTimeline)
+        waylandState.acquireTimeline->sendDestroy();
+    if (waylandState.releaseTimeline)
+        waylandState.releaseTimeline->sendDestroy();
+    if (syncobjState.acquire)
+        drmSyncobjDestroy(backend->drmState.fd, syncobjState.acquire);
+    if (syncobjState.release)
+        drmSyncobjDestroy(backend->drmState.fd, syncobjState.release);
+    if (waylandState.viewport)
+        waylandState.viewport->sendDestroy();
     if (waylandState.surface)
         waylandState.surface->sendDestroy();
+
+    cursorState.shmSlots.clear();
+    cursorState.shmPool.reset();
+    if (cursorState.shmData)
+        munmap(cursorState.shmData, cursorState.shmSize);
+    if (cursorState.shmFD >= 0)
+        close(cursorState.shmFD);
 }
 
 std::vector<SDRMFormat> Aquamarine::CWaylandOutput::getRenderFormats() {
-    // TODO
-    // this is technically wrong because this returns the format table formats
-    // the actually supported formats are given by tranche formats
+    if (!surfaceFormats.empty())
+        return surfaceFormats;
+
     return backend->getRenderFormats();
 }
 
+const std::vector<SWaylandDmabufTranche>& Aquamarine::CWaylandOutput::dmabufTranches() {
+    static const std::vector<SWaylandDmabufTranche> EMPTY;
+    return waylandState.dmabufFeedback ? waylandState.dmabufFeedback->tranches : EMPTY;
+}
+
+void Aquamarine::CWaylandOutput::onSurfaceFeedback() {
+    auto formats = waylandState.dmabufFeedback->preferredFormats();
+
+    // the host tells us where the surface is best off, e.g. a scanout tranche once it's fullscreen on a plane
+    const bool SAME = formats.size() == surfaceFormats.size() && std::ranges::equal(formats, surfaceFormats, [](const auto& a, const auto& b) {
+                          return a.drmFormat == b.drmFormat && a.modifiers == b.modifiers;
+                      });
+    if (SAME)
+        return;
+
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND,
+          std::format("Output {}: surface feedback changed, {} formats in {} tranches", name, formats.size(), waylandState.dmabufFeedback->tranches.size()));
+
+    surfaceFormats        = std::move(formats);
+    surfaceFormatsChanged = true;
+}
+
 bool Aquamarine::CWaylandOutput::destroy() {
     events.destroy.emit();
     waylandState.surface->sendAttach(nullptr, 0, 0);
@@ -534,31 +798,39 @@ bool Aquamarine::CWaylandOutput::commit() {
     else if (state->internalState.mode)
         pixelSize = state->internalState.mode->pixelSize;
     else {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: pending state rejected: invalid mode", name));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: pending state rejected: invalid mode", name));
         return false;
     }
 
     uint32_t format = state->internalState.drmFormat;
 
     if (format == DRM_FORMAT_INVALID) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: pending state rejected: invalid format", name));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: pending state rejected: invalid format", name));
         return false;
     }
 
     if (!swapchain) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: no swapchain, lying because it will soon be here", name));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: no swapchain, lying because it will soon be here", name));
         return true;
     }
 
-    if (!swapchain->reconfigure(SSwapchainOptions{.length = 2, .size = pixelSize, .format = format})) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: pending state rejected: swapchain failed reconfiguring", name));
+    if (surfaceFormatsChanged) {
+        swapchain->setFormats(surfaceFormats);
+        surfaceFormatsChanged = false;
+    }
+
+    // the host holds on to buffers until their release point, a third one keeps us from waiting on it
+    const size_t LENGTH = waylandState.syncobjSurface ? 3 : 2;
+
+    if (!swapchain->reconfigure(SSwapchainOptions{.length = LENGTH, .size = pixelSize, .format = format, .skipLocked = true})) {
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: pending state rejected: swapchain failed reconfiguring", name));
         return false;
     }
 
     if (!state->internalState.buffer) {
         // if the consumer explicitly committed a null buffer, that's a violation.
         if (state->internalState.committed & COutputState::AQ_OUTPUT_STATE_BUFFER) {
-            backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: pending state rejected: no buffer", name));
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: pending state rejected: no buffer", name));
             return false;
         }
 
@@ -570,17 +842,26 @@ bool Aquamarine::CWaylandOutput::commit() {
     auto wlBuffer = wlBufferFromBuffer(state->internalState.buffer);
 
     if (!wlBuffer) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: pending state rejected: no wlBuffer??", name));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: pending state rejected: no wlBuffer??", name));
         return false;
     }
 
-    if (wlBuffer->pendingRelease)
-        backend->backend->log(AQ_LOG_WARNING, std::format("Output {}: pending state has a non-released buffer??", name));
+    pollReleasePoints();
+
+    if (state->internalState.buffer->lockedByBackend)
+        AQLOG(backend->backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: pending state has a non-released buffer??", name));
 
-    wlBuffer->pendingRelease = true;
+    if (waylandState.syncobjSurface && !setSyncPoints(wlBuffer)) {
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: pending state rejected: failed to set sync points", name));
+        return false;
+    }
+
+    state->internalState.buffer->lockedByBackend = true;
 
     waylandState.surface->sendAttach(wlBuffer->waylandState.buffer.get(), 0, 0);
-    waylandState.surface->sendDamageBuffer(0, 0, INT32_MAX, INT32_MAX);
+    damageBuffer(pixelSize);
+    updateViewport(pixelSize);
+    requestPresentFeedback();
     waylandState.surface->sendCommit();
 
     readyForFrameCallback = true;
@@ -617,6 +898,238 @@ SP<CWaylandBuffer> Aquamarine::CWaylandOutput::wlBufferFromBuffer(SP<IBuffer> bu
     return wlBuffer;
 }
 
+void Aquamarine::CWaylandOutput::damageBuffer(const Vector2D& size) {
+    const auto& STATE = state->internalState;
+
+    // no damage with a new buffer is more likely a consumer that doesn't track damage than one that changed nothing
+    if (!(STATE.committed & COutputState::AQ_OUTPUT_STATE_DAMAGE) || STATE.damage.empty()) {
+        waylandState.surface->sendDamageBuffer(0, 0, INT32_MAX, INT32_MAX);
+        return;
+    }
+
+    CRegion damage = STATE.damage;
+    damage.intersect(0, 0, size.x, size.y);
+
+    auto rects = damage.getRects();
+
+    if (rects.size() > MAX_DAMAGE_RECTS) {
+        // merge by horizontal bands of the buffer, so damage far apart vertically stays apart
+        std::array<pixman_box32_t, MAX_DAMAGE_RECTS> bands = {};
+        std::array<bool, MAX_DAMAGE_RECTS>           used  = {};
+        const int32_t                                BANDH = std::max<int32_t>(1, (size.y + MAX_DAMAGE_RECTS - 1) / MAX_DAMAGE_RECTS);
+
+        for (const auto& r : rects) {
+            const size_t BAND = std::clamp<int32_t>(r.y1 / BANDH, 0, MAX_DAMAGE_RECTS - 1);
+            auto&        b    = bands[BAND];
+
+            if (!used[BAND]) {
+                b          = r;
+                used[BAND] = true;
+                continue;
+            }
+
+            b.x1 = std::min(b.x1, r.x1);
+            b.y1 = std::min(b.y1, r.y1);
+            b.x2 = std::max(b.x2, r.x2);
+            b.y2 = std::max(b.y2, r.y2);
+        }
+
+        rects.clear();
+        for (size_t i = 0; i < MAX_DAMAGE_RECTS; ++i) {
+            if (used[i])
+                rects.emplace_back(bands[i]);
+        }
+    }
+
+    for (const auto& r : rects) {
+        waylandState.surface->sendDamageBuffer(r.x1, r.y1, r.x2 - r.x1, r.y2 - r.y1);
+    }
+}
+
+void Aquamarine::CWaylandOutput::emitPreferredSize() {
+    // without a viewport the buffer is the window, and 0x0 asks the consumer to pick a size
+    if (!waylandState.viewport || windowSize.x <= 0 || windowSize.y <= 0) {
+        events.state.emit(SStateEvent{.size = windowSize});
+        return;
+    }
+
+    events.state.emit(SStateEvent{.size = (windowSize * preferredScale * renderScale()).round()});
+}
+
+void Aquamarine::CWaylandOutput::updateViewport(const Vector2D& bufferSize_) {
+    bufferSize = bufferSize_;
+
+    if (!waylandState.viewport) {
+        surfaceSize = bufferSize;
+        return;
+    }
+
+    // the buffer may be any size, the host scales it to the window
+    const Vector2D DESTINATION = windowSize.x > 0 && windowSize.y > 0 ? windowSize : Vector2D{-1, -1};
+    if (DESTINATION != viewportDestination) {
+        waylandState.viewport->sendSetDestination(DESTINATION.x, DESTINATION.y);
+        viewportDestination = DESTINATION;
+    }
+
+    surfaceSize = DESTINATION.x > 0 ? DESTINATION : bufferSize;
+}
+
+void Aquamarine::CWaylandOutput::requestPresentFeedback() {
+    if (!backend->waylandState.presentation)
+        return;
+
+    auto& finished = waylandState.finishedPresentFeedbacks;
+    std::erase_if(waylandState.presentFeedbacks, [&finished](const auto& f) { return std::ranges::find(finished, f.get()) != finished.end(); });
+    finished.clear();
+
+    auto feedback = makeShared<CCWpPresentationFeedback>(backend->waylandState.presentation->sendFeedback(waylandState.surface->resource()));
+    if (!feedback->resource()) {
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: wp_presentation: failed to get a feedback", name));
+        return;
+    }
+
+    feedback->setPresented([this](CCWpPresentationFeedback* r, uint32_t tvSecHi, uint32_t tvSecLo, uint32_t tvNsec, uint32_t refreshNs, uint32_t seqHi, uint32_t seqLo,
+                                  uint32_t kind) {
+        const timespec HOSTWHEN = {.tv_sec = (time_t)(((uint64_t)tvSecHi << 32) | tvSecLo), .tv_nsec = (long)tvNsec};
+        timespec       when     = toMonotonic(HOSTWHEN, backend->waylandState.presentationClock);
+
+        uint32_t       flags = 0;
+        if (kind & WP_PRESENTATION_FEEDBACK_KIND_VSYNC)
+            flags |= AQ_OUTPUT_PRESENT_VSYNC;
+        if (kind & WP_PRESENTATION_FEEDBACK_KIND_HW_CLOCK)
+            flags |= AQ_OUTPUT_PRESENT_HW_CLOCK;
+        if (kind & WP_PRESENTATION_FEEDBACK_KIND_HW_COMPLETION)
+            flags |= AQ_OUTPUT_PRESENT_HW_COMPLETION;
+        if (kind & WP_PRESENTATION_FEEDBACK_KIND_ZERO_COPY)
+            flags |= AQ_OUTPUT_PRESENT_ZEROCOPY;
+
+        waylandState.finishedPresentFeedbacks.emplace_back(r);
+
+        events.present.emit(SPresentEvent{
+            .presented = true,
+            .when      = &when,
+            .seq       = seqLo,
+            .refresh   = (int)refreshNs,
+            .flags     = flags,
+        });
+    });
+
+    feedback->setDiscarded([this](CCWpPresentationFeedback* r) {
+        waylandState.finishedPresentFeedbacks.emplace_back(r);
+        events.present.emit(SPresentEvent{.presented = false});
+    });
+
+    waylandState.presentFeedbacks.emplace_back(feedback);
+}
+
+bool Aquamarine::CWaylandOutput::initExplicitSync() {
+    const int DRMFD = backend->drmState.fd;
+
+    auto      importTimeline = [this, DRMFD](uint32_t& handle) -> SP<CCWpLinuxDrmSyncobjTimelineV1> {
+        if (drmSyncobjCreate(DRMFD, 0, &handle) != 0) {
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: drmSyncobjCreate failed", name));
+            return nullptr;
+        }
+
+        int timelineFD = -1;
+        if (drmSyncobjHandleToFD(DRMFD, handle, &timelineFD) != 0) {
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: drmSyncobjHandleToFD failed", name));
+            return nullptr;
+        }
+
+        auto timeline = makeShared<CCWpLinuxDrmSyncobjTimelineV1>(backend->waylandState.syncobjManager->sendImportTimeline(timelineFD));
+        close(timelineFD);
+
+        if (!timeline->resource()) {
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: failed to import a timeline", name));
+            return nullptr;
+        }
+
+        return timeline;
+    };
+
+    waylandState.acquireTimeline = importTimeline(syncobjState.acquire);
+    waylandState.releaseTimeline = importTimeline(syncobjState.release);
+    if (!waylandState.acquireTimeline || !waylandState.releaseTimeline)
+        return false;
+
+    waylandState.syncobjSurface =
+        makeShared<CCWpLinuxDrmSyncobjSurfaceV1>(backend->waylandState.syncobjManager->sendGetSurface(waylandState.surface->resource()));
+
+    if (!waylandState.syncobjSurface->resource()) {
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: failed to get a syncobj surface", name));
+        waylandState.syncobjSurface.reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool Aquamarine::CWaylandOutput::setSyncPoints(SP<CWaylandBuffer> wlBuffer) {
+    const int DRMFD    = backend->drmState.fd;
+    uint64_t  point    = ++syncobjState.point;
+    int       fence    = -1;
+    bool      ownFence = false;
+
+    if ((state->internalState.committed & COutputState::AQ_OUTPUT_STATE_EXPLICIT_IN_FENCE) && state->internalState.explicitInFence >= 0)
+        fence = state->internalState.explicitInFence;
+    else {
+        // once the surface is synced explicitly every buffer needs an acquire point. Without a fence from the consumer, use the buffer's implicit one.
+        dma_buf_export_sync_file request = {.flags = DMA_BUF_SYNC_READ, .fd = -1};
+        const auto               ATTRS   = state->internalState.buffer->dmabuf();
+        if (ATTRS.success && ioctl(ATTRS.fds.at(0), DMA_BUF_IOCTL_EXPORT_SYNC_FILE, &request) == 0) {
+            fence    = request.fd;
+            ownFence = true;
+        }
+    }
+
+    bool imported = false;
+    if (fence >= 0) {
+        // a sync_file goes onto a timeline point through a binary syncobj
+        uint32_t tmp = 0;
+        if (drmSyncobjCreate(DRMFD, 0, &tmp) == 0) {
+            imported = drmSyncobjImportSyncFile(DRMFD, tmp, fence) == 0 && drmSyncobjTransfer(DRMFD, syncobjState.acquire, point, tmp, 0, 0) == 0;
+            drmSyncobjDestroy(DRMFD, tmp);
+        }
+
+        if (ownFence)
+            close(fence);
+    }
+
+    if (!imported) {
+        // nothing to wait on (or it couldn't be imported), let the host go ahead
+        TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: no acquire fence for point {}, signaling it", name, point)));
+        if (drmSyncobjTimelineSignal(DRMFD, &syncobjState.acquire, &point, 1) != 0)
+            return false;
+    }
+
+    waylandState.syncobjSurface->sendSetAcquirePoint(waylandState.acquireTimeline.get(), point >> 32, point & 0xFFFFFFFF);
+    waylandState.syncobjSurface->sendSetReleasePoint(waylandState.releaseTimeline.get(), point >> 32, point & 0xFFFFFFFF);
+
+    wlBuffer->releasePoint = point;
+
+    return true;
+}
+
+void Aquamarine::CWaylandOutput::pollReleasePoints() {
+    if (!syncobjState.release)
+        return;
+
+    // the host signals release points in commit order, one query covers every buffer
+    uint64_t released = 0;
+    if (drmSyncobjQuery(backend->drmState.fd, &syncobjState.release, &released, 1) != 0)
+        return;
+
+    for (auto& [buffer, wlBuffer] : backendState.buffers) {
+        if (!wlBuffer->releasePoint || wlBuffer->releasePoint > released)
+            continue;
+
+        wlBuffer->releasePoint = 0;
+        if (auto buf = buffer.lock())
+            buf->lockedByBackend = false;
+    }
+}
+
 void Aquamarine::CWaylandOutput::sendFrameAndSetCallback() {
     events.frame.emit();
     frameScheduled = false;
@@ -631,6 +1144,17 @@ void Aquamarine::CWaylandOutput::onFrameDone() {
     waylandState.frameCallback.reset();
     readyForFrameCallback = false;
 
+    // whatever the host let go of by now can be rendered to on this frame
+    pollReleasePoints();
+
+    // without wp_presentation, the frame callback is the closest thing to a present we get.
+    // Its timestamp has no defined base, so the time we got it at is used instead.
+    if (!backend->waylandState.presentation) {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        events.present.emit(SPresentEvent{.presented = true, .when = &now});
+    }
+
     // FIXME: this is wrong, but otherwise we get bugs.
     // thanks @phonetic112
     scheduleFrame(AQ_SCHEDULE_NEEDS_FRAME);
@@ -648,7 +1172,7 @@ bool Aquamarine::CWaylandOutput::setCursor(Hyprutils::Memory::CSharedPointer<IBu
         cursorState.cursorSurface = makeShared<CCWlSurface>(backend->waylandState.compositor->sendCreateSurface());
 
     if (!cursorState.cursorSurface) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: Failed to create a wl_surface for the cursor", name));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: Failed to create a wl_surface for the cursor", name));
         return false;
     }
 
@@ -662,38 +1186,13 @@ bool Aquamarine::CWaylandOutput::setCursor(Hyprutils::Memory::CSharedPointer<IBu
     cursorState.cursorBuffer = buffer;
     cursorState.hotspot      = hotspot;
 
-    if (buffer->shm().success) {
-        auto attrs                    = buffer->shm();
-        auto [pixelData, fmt, bufLen] = buffer->beginDataPtr(0);
-
-        int fd = allocateSHMFile(bufLen);
-        if (fd < 0) {
-            backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: Failed to allocate a shm file", name));
-            return false;
-        }
-
-        void* data = mmap(nullptr, bufLen, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-        if (data == MAP_FAILED) {
-            backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: Failed to mmap the cursor pixel data", name));
-            close(fd);
-            return false;
-        }
-
-        memcpy(data, pixelData, bufLen);
-        munmap(data, bufLen);
-
-        auto pool = makeShared<CCWlShmPool>(backend->waylandState.shm->sendCreatePool(fd, bufLen));
-        if (!pool) {
-            backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: Failed to submit a wl_shm pool", name));
-            close(fd);
-            return false;
-        }
+    cursorState.shmUpdatePending = false;
 
-        cursorState.cursorWlBuffer = makeShared<CCWlBuffer>(pool->sendCreateBuffer(0, attrs.size.x, attrs.size.y, attrs.stride, shmFormatFromDRM(attrs.format)));
-
-        pool.reset();
-
-        close(fd);
+    if (buffer->shm().success) {
+        cursorState.cursorWlBuffer = shmCursorBuffer(buffer);
+        // set again once the host releases a buffer, the last cursor stays up until then
+        if (!cursorState.cursorWlBuffer && cursorState.shmUpdatePending)
+            return true;
     } else if (auto attrs = buffer->dmabuf(); attrs.success) {
         auto params = makeShared<CCZwpLinuxBufferParamsV1>(backend->waylandState.dmabuf->sendCreateParams());
 
@@ -703,12 +1202,12 @@ bool Aquamarine::CWaylandOutput::setCursor(Hyprutils::Memory::CSharedPointer<IBu
 
         cursorState.cursorWlBuffer = makeShared<CCWlBuffer>(params->sendCreateImmed(attrs.size.x, attrs.size.y, attrs.format, (zwpLinuxBufferParamsV1Flags)0));
     } else {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: Failed to create a buffer for cursor: No known attrs (tried dmabuf / shm)", name));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: Failed to create a buffer for cursor: No known attrs (tried dmabuf / shm)", name));
         return false;
     }
 
     if (!cursorState.cursorWlBuffer) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("Output {}: Failed to create a buffer for cursor", name));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: Failed to create a buffer for cursor", name));
         return false;
     }
 
@@ -725,6 +1224,133 @@ bool Aquamarine::CWaylandOutput::setCursor(Hyprutils::Memory::CSharedPointer<IBu
     return true;
 }
 
+SP<CCWlBuffer> Aquamarine::CWaylandOutput::shmCursorBuffer(SP<IBuffer> buffer) {
+    auto attrs                    = buffer->shm();
+    auto [pixelData, fmt, bufLen] = buffer->beginDataPtr(0);
+
+    if (bufLen > cursorState.shmSlotSize && !growCursorPool(bufLen))
+        return nullptr;
+
+    // the next slot the host is done with. One it still holds may be read from any time, so never write those.
+    auto&  slots = cursorState.shmSlots;
+    size_t idx   = slots.size();
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const size_t CANDIDATE = (cursorState.nextShmSlot + i) % slots.size();
+        if (!slots[CANDIDATE].busy) {
+            idx = CANDIDATE;
+            break;
+        }
+    }
+
+    if (idx == slots.size()) {
+        if (!addCursorSlot()) {
+            AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: the host holds every cursor buffer, the update waits for a release", name));
+            cursorState.shmUpdatePending = true;
+            return nullptr;
+        }
+
+        idx = slots.size() - 1;
+    }
+
+    cursorState.nextShmSlot = (idx + 1) % slots.size();
+    auto& slot              = slots[idx];
+
+    memcpy(cursorState.shmData + slot.offset, pixelData, bufLen);
+
+    if (!slot.buffer || slot.size != attrs.size || slot.stride != attrs.stride || slot.format != attrs.format) {
+        slot.buffer = makeShared<CCWlBuffer>(
+            cursorState.shmPool->sendCreateBuffer(slot.offset, attrs.size.x, attrs.size.y, attrs.stride, shmFormatFromDRM(attrs.format)));
+        slot.size   = attrs.size;
+        slot.stride = attrs.stride;
+        slot.format = attrs.format;
+
+        slot.buffer->setRelease([this, idx](CCWlBuffer* r) {
+            // the pool may have been regrown into fewer slots since
+            if (idx >= cursorState.shmSlots.size() || cursorState.shmSlots[idx].buffer.get() != r)
+                return;
+
+            cursorState.shmSlots[idx].busy = false;
+
+            if (cursorState.shmUpdatePending && cursorState.cursorBuffer) {
+                cursorState.shmUpdatePending = false;
+                setCursor(cursorState.cursorBuffer, cursorState.hotspot);
+            }
+        });
+    }
+
+    slot.busy = true;
+    return slot.buffer;
+}
+
+bool Aquamarine::CWaylandOutput::resizeCursorPool(size_t size) {
+    const size_t OLDSIZE = cursorState.shmSize;
+
+    if (cursorState.shmFD < 0) {
+        cursorState.shmFD = allocateSHMFile(size);
+        if (cursorState.shmFD < 0) {
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: Failed to allocate a shm file", name));
+            return false;
+        }
+    } else if (!resizeSHMFile(cursorState.shmFD, size)) {
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: Failed to grow the cursor shm file", name));
+        return false;
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, cursorState.shmFD, 0);
+    if (data == MAP_FAILED) {
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: Failed to mmap the cursor pixel data", name));
+        return false;
+    }
+
+    if (cursorState.shmData)
+        munmap(cursorState.shmData, OLDSIZE);
+    cursorState.shmData = (uint8_t*)data;
+    cursorState.shmSize = size;
+
+    if (!cursorState.shmPool) {
+        cursorState.shmPool = makeShared<CCWlShmPool>(backend->waylandState.shm->sendCreatePool(cursorState.shmFD, size));
+        if (!cursorState.shmPool->resource()) {
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: Failed to submit a wl_shm pool", name));
+            cursorState.shmPool.reset();
+            return false;
+        }
+    } else
+        cursorState.shmPool->sendResize(size);
+
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_WAYLAND, std::format("Output {}: cursor shm pool grown to {} bytes", name, size));
+    return true;
+}
+
+bool Aquamarine::CWaylandOutput::growCursorPool(size_t slotSize) {
+    slotSize = (slotSize + 63) & ~(size_t)63;
+
+    const size_t OLDSIZE = cursorState.shmSize;
+    if (!resizeCursorPool(OLDSIZE + slotSize * CURSOR_SHM_SLOTS))
+        return false;
+
+    // the old slots' buffers go away with them, the attached one lives on in cursorWlBuffer
+    cursorState.shmSlots.resize(CURSOR_SHM_SLOTS);
+    for (size_t i = 0; i < CURSOR_SHM_SLOTS; ++i) {
+        cursorState.shmSlots[i] = {.offset = OLDSIZE + i * slotSize};
+    }
+
+    cursorState.shmSlotSize = slotSize;
+    cursorState.nextShmSlot = 0;
+    return true;
+}
+
+bool Aquamarine::CWaylandOutput::addCursorSlot() {
+    if (cursorState.shmSlots.size() >= CURSOR_SHM_MAX_SLOTS)
+        return false;
+
+    const size_t OFFSET = cursorState.shmSize;
+    if (!resizeCursorPool(OFFSET + cursorState.shmSlotSize))
+        return false;
+
+    cursorState.shmSlots.emplace_back().offset = OFFSET;
+    return true;
+}
+
 void Aquamarine::CWaylandOutput::moveCursor(const Hyprutils::Math::Vector2D& coord, bool skipShedule) {
     return;
 }
@@ -743,8 +1369,8 @@ Hyprutils::Math::Vector2D Aquamarine::CWaylandOutput::cursorPlaneSize() {
 }
 
 void Aquamarine::CWaylandOutput::scheduleFrame(const scheduleFrameReason reason) {
-    TRACE(backend->backend->log(AQ_LOG_TRACE,
-                                std::format("CWaylandOutput::scheduleFrame: reason {}, needsFrame {}, frameScheduled {}", (uint32_t)reason, needsFrame, frameScheduled)));
+    TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_WAYLAND,
+                std::format("CWaylandOutput::scheduleFrame: reason {}, needsFrame {}, frameScheduled {}", (uint32_t)reason, needsFrame, frameScheduled)));
     needsFrame = true;
 
     if (frameScheduled)
@@ -762,7 +1388,7 @@ Aquamarine::CWaylandBuffer::CWaylandBuffer(SP<IBuffer> buffer_, Hyprutils::Memor
     auto params = makeShared<CCZwpLinuxBufferParamsV1>(backend->waylandState.dmabuf->sendCreateParams());
 
     if (!params) {
-        backend->backend->log(AQ_LOG_ERROR, "WaylandBuffer: failed to query params");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_WAYLAND, "WaylandBuffer: failed to query params");
         return;
     }
 
@@ -774,7 +1400,14 @@ Aquamarine::CWaylandBuffer::CWaylandBuffer(SP<IBuffer> buffer_, Hyprutils::Memor
 
     waylandState.buffer = makeShared<CCWlBuffer>(params->sendCreateImmed(attrs.size.x, attrs.size.y, attrs.format, (zwpLinuxBufferParamsV1Flags)0));
 
-    waylandState.buffer->setRelease([this](CCWlBuffer* r) { pendingRelease = false; });
+    waylandState.buffer->setRelease([this](CCWlBuffer* r) {
+        // with a release point, the host may still be reading from the buffer on the gpu
+        if (releasePoint)
+            return;
+
+        if (auto buf = buffer.lock())
+            buf->lockedByBackend = false;
+    });
 
     params->sendDestroy();
 }
@@ -34,6 +34,8 @@ using namespace Hyprutils::Memory;
 using namespace Hyprutils::Math;
 #define SP CSharedPointer
 
+constexpr int HOTPLUG_DEBOUNCE_MS = 50;
+
 Aquamarine::CDRMBackend::CDRMBackend(SP<CBackend> backend_) : backend(backend_) {
     listeners.sessionActivate = backend->session->events.changeActive.registerListener([this](std::any d) {
         if (backend->session->active) {
@@ -63,13 +65,13 @@ static std::vector<SP<CSessionDevice>> scanGPUs(SP<CBackend> backend) {
     auto enumerate = enumDRMCards(backend->session->udevHandle);
 
     if (!enumerate) {
-        backend->log(AQ_LOG_ERROR, "drm: couldn't enumerate gpus with udev");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: couldn't enumerate gpus with udev");
         return {};
     }
 
     if (!udev_enumerate_get_list_entry(enumerate)) {
         // TODO: wait for them.
-        backend->log(AQ_LOG_ERROR, "drm: No gpus in scanGPUs.");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: No gpus in scanGPUs.");
         return {};
     }
 
@@ -82,18 +84,19 @@ static std::vector<SP<CSessionDevice>> scanGPUs(SP<CBackend> backend) {
         auto path   = udev_list_entry_get_name(entry);
         auto device = udev_device_new_from_syspath(backend->session->udevHandle, path);
         if (!device) {
-            backend->log(AQ_LOG_WARNING, std::format("drm: Skipping device {}", path ? path : "unknown"));
+            AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_DRM, std::format("drm: Skipping device {}", path ? path : "unknown"));
             continue;
         }
 
-        backend->log(AQ_LOG_DEBUG, std::format("drm: Enumerated device {}", path ? path : "unknown"));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Enumerated device {}", path ? path : "unknown"));
 
         auto seat = udev_device_get_property_value(device, "ID_SEAT");
         if (!seat)
             seat = "seat0";
 
         if (!backend->session->seatName.empty() && backend->session->seatName != seat) {
-            backend->log(AQ_LOG_WARNING, std::format("drm: Skipping device {} because seat {} doesn't match our {}", path ? path : "unknown", seat, backend->session->seatName));
+            AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_DRM,
+                  std::format("drm: Skipping device {} because seat {} doesn't match our {}", path ? path : "unknown", seat, backend->session->seatName));
             udev_device_unref(device);
             continue;
         }
@@ -106,14 +109,14 @@ static std::vector<SP<CSessionDevice>> scanGPUs(SP<CBackend> backend) {
         }
 
         if (!udev_device_get_devnode(device)) {
-            backend->log(AQ_LOG_ERROR, std::format("drm: Skipping device {}, no devnode", path ? path : "unknown"));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Skipping device {}, no devnode", path ? path : "unknown"));
             udev_device_unref(device);
             continue;
         }
 
         auto sessionDevice = CSessionDevice::openIfKMS(backend->session, udev_device_get_devnode(device));
         if (!sessionDevice) {
-            backend->log(AQ_LOG_ERROR, std::format("drm: Skipping device {}, not a KMS device", path ? path : "unknown"));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Skipping device {}, not a KMS device", path ? path : "unknown"));
             udev_device_unref(device);
             continue;
         }
@@ -134,7 +137,7 @@ static std::vector<SP<CSessionDevice>> scanGPUs(SP<CBackend> backend) {
 
     auto                            explicitGpus = getenv("AQ_DRM_DEVICES");
     if (explicitGpus) {
-        backend->log(AQ_LOG_DEBUG, std::format("drm: Explicit device list {}", explicitGpus));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Explicit device list {}", explicitGpus));
         Hyprutils::String::CVarList explicitDevices(explicitGpus, 0, ':', true);
 
         // Iterate over GPUs and canonicalize the paths
@@ -146,7 +149,7 @@ static std::vector<SP<CSessionDevice>> scanGPUs(SP<CBackend> backend) {
             // If there is an error, log and continue.
             // TODO: Verify that the path is a valid DRM device. (https://gitlab.freedesktop.org/wlroots/wlroots/-/blob/master/backend/session/session.c?ref_type=heads#L369-387)
             if (ec) {
-                backend->log(AQ_LOG_ERROR, std::format("drm: Failed to canonicalize path {}", d));
+                AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Failed to canonicalize path {}", d));
                 continue;
             }
 
@@ -164,9 +167,9 @@ static std::vector<SP<CSessionDevice>> scanGPUs(SP<CBackend> backend) {
             }
 
             if (found)
-                backend->log(AQ_LOG_DEBUG, std::format("drm: Explicit device {} found", d));
+                AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Explicit device {} found", d));
             else
-                backend->log(AQ_LOG_ERROR, std::format("drm: Explicit device {} not found", d));
+                AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Explicit device {} not found", d));
         }
     } else {
         for (auto& d : devices) {
@@ -182,12 +185,12 @@ std::vector<SP<CDRMBackend>> Aquamarine::CDRMBackend::attempt(SP<CBackend> backe
         backend->session = CSession::attempt(backend);
 
     if (!backend->session) {
-        backend->log(AQ_LOG_ERROR, "Failed to open a session");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "Failed to open a session");
         return {};
     }
 
     if (!backend->session->active) {
-        backend->log(AQ_LOG_DEBUG, "Session is not active, waiting for 5s");
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "Session is not active, waiting for 5s");
 
         auto started = std::chrono::system_clock::now();
 
@@ -196,13 +199,13 @@ std::vector<SP<CDRMBackend>> Aquamarine::CDRMBackend::attempt(SP<CBackend> backe
             backend->session->dispatchPendingEventsAsync();
 
             if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - started).count() >= 5000) {
-                backend->log(AQ_LOG_DEBUG, "Session timeout reached");
+                AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "Session timeout reached");
                 break;
             }
         }
 
         if (!backend->session->active) {
-            backend->log(AQ_LOG_DEBUG, "Session could not be activated in time");
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "Session could not be activated in time");
             return {};
         }
     }
@@ -210,11 +213,11 @@ std::vector<SP<CDRMBackend>> Aquamarine::CDRMBackend::attempt(SP<CBackend> backe
     auto gpus = scanGPUs(backend);
 
     if (gpus.empty()) {
-        backend->log(AQ_LOG_ERROR, "drm: Found no gpus to use, cannot continue");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Found no gpus to use, cannot continue");
         return {};
     }
 
-    backend->log(AQ_LOG_DEBUG, std::format("drm: Found {} GPUs", gpus.size()));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Found {} GPUs", gpus.size()));
 
     std::vector<SP<CDRMBackend>> backends;
     SP<CDRMBackend>              newPrimary;
@@ -224,25 +227,25 @@ std::vector<SP<CDRMBackend>> Aquamarine::CDRMBackend::attempt(SP<CBackend> backe
         drmBackend->self = drmBackend;
 
         if (!drmBackend->registerGPU(gpu, newPrimary)) {
-            backend->log(AQ_LOG_ERROR, std::format("drm: Failed to register gpu {}", gpu->path));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Failed to register gpu {}", gpu->path));
             continue;
         } else
-            backend->log(AQ_LOG_DEBUG, std::format("drm: Registered gpu {}", gpu->path));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Registered gpu {}", gpu->path));
 
         // TODO: consider listening for new devices
         // But if you expect me to handle gpu hotswaps you are probably insane LOL
 
         if (!drmBackend->checkFeatures()) {
-            backend->log(AQ_LOG_ERROR, "drm: Failed checking features");
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Failed checking features");
             continue;
         }
 
         if (!drmBackend->initResources()) {
-            backend->log(AQ_LOG_ERROR, "drm: Failed initializing resources");
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Failed initializing resources");
             continue;
         }
 
-        backend->log(AQ_LOG_DEBUG, std::format("drm: Basic init pass for gpu {}", gpu->path));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Basic init pass for gpu {}", gpu->path));
 
         drmBackend->grabFormats();
 
@@ -251,7 +254,7 @@ std::vector<SP<CDRMBackend>> Aquamarine::CDRMBackend::attempt(SP<CBackend> backe
         drmBackend->recheckCRTCs();
 
         if (!newPrimary) {
-            backend->log(AQ_LOG_DEBUG, std::format("drm: gpu {} becomes primary drm", gpu->path));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: gpu {} becomes primary drm", gpu->path));
             newPrimary = drmBackend;
         }
 
@@ -265,11 +268,20 @@ std::vector<SP<CDRMBackend>> Aquamarine::CDRMBackend::attempt(SP<CBackend> backe
 }
 
 Aquamarine::CDRMBackend::~CDRMBackend() {
-    ;
+    if (hotplugTimer && backend)
+        backend->cancelTimer(hotplugTimer);
 }
 
 void Aquamarine::CDRMBackend::log(eBackendLogLevel l, const std::string& s) {
-    backend->log(l, s);
+    backend->log(l, AQ_SUBSYSTEM_DRM, s);
+}
+
+void Aquamarine::CDRMBackend::log(eBackendLogLevel l, eBackendLogSubsystem sub, const std::string& s) {
+    backend->log(l, sub, s);
+}
+
+bool Aquamarine::CDRMBackend::shouldLog(eBackendLogLevel l, eBackendLogSubsystem sub) {
+    return backend->shouldLog(l, sub);
 }
 
 bool Aquamarine::CDRMBackend::sessionActive() {
@@ -277,15 +289,15 @@ bool Aquamarine::CDRMBackend::sessionActive() {
 }
 
 void Aquamarine::CDRMBackend::restoreAfterVT() {
-    backend->log(AQ_LOG_DEBUG, "drm: Restoring after VT switch");
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: Restoring after VT switch");
 
     scanConnectors();
     recheckCRTCs();
 
-    backend->log(AQ_LOG_DEBUG, "drm: Rescanned connectors");
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: Rescanned connectors");
 
     if (!impl->reset())
-        backend->log(AQ_LOG_ERROR, "drm: failed reset");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: failed reset");
 
     std::vector<SP<SDRMConnector>> noMode;
 
@@ -301,10 +313,12 @@ void Aquamarine::CDRMBackend::restoreAfterVT() {
             .test     = false,
         };
 
+        c->isModesetPending = false;
+
         auto& STATE = c->output->state->state();
 
         if (!STATE.customMode && !STATE.mode) {
-            backend->log(AQ_LOG_WARNING, "drm: Connector {} has output but state has no mode, will send a reset state event later.");
+            AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_DRM, "drm: Connector {} has output but state has no mode, will send a reset state event later.");
             noMode.emplace_back(c);
             continue;
         }
@@ -322,23 +336,40 @@ void Aquamarine::CDRMBackend::restoreAfterVT() {
             drmFB = CDRMFB::create(buf, self, &isNew);
 
             if (!drmFB)
-                backend->log(AQ_LOG_ERROR, "drm: Buffer failed to import to KMS");
+                AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Buffer failed to import to KMS");
 
             data.mainFB = drmFB;
         }
 
+        // with a buffer, let the kernel do the modeset in the background and tell us via a pf event
+        if (data.mainFB && STATE.enabled) {
+            data.blocking = false;
+            data.flags    = DRM_MODE_PAGE_FLIP_EVENT;
+        }
+
         if (c->crtc->pendingCursor)
             data.cursorFB = c->crtc->pendingCursor;
 
         if (data.cursorFB && data.cursorFB->buffer->dmabuf().modifier == DRM_FORMAT_MOD_INVALID)
             data.cursorFB = nullptr;
 
-        backend->log(AQ_LOG_DEBUG,
-                     std::format("drm: Restoring crtc {} with clock {} hdisplay {} vdisplay {} vrefresh {}", c->crtc->id, data.modeInfo.clock, data.modeInfo.hdisplay,
-                                 data.modeInfo.vdisplay, data.modeInfo.vrefresh));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM,
+              std::format("drm: Restoring crtc {} with clock {} hdisplay {} vdisplay {} vrefresh {}", c->crtc->id, data.modeInfo.clock, data.modeInfo.hdisplay,
+                          data.modeInfo.vdisplay, data.modeInfo.vrefresh));
+
+        bool ok = impl->commit(c, data);
 
-        if (!impl->commit(c, data))
-            backend->log(AQ_LOG_ERROR, std::format("drm: crtc {} failed restore", c->crtc->id));
+        if (!ok && !data.blocking) {
+            // the modeset may pull in crtc state the previous connector's nonblocking modeset still holds (EBUSY), a blocking one waits for it
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: nonblocking restore of crtc {} failed, retrying blocking", c->crtc->id));
+            data.blocking = true;
+            ok            = impl->commit(c, data);
+        }
+
+        if (!ok)
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: crtc {} failed restore", c->crtc->id));
+        else if (!c->isModesetPending && !c->isCommitInFlight)
+            c->output->events.modeset.emit();
     }
 
     for (auto& c : noMode) {
@@ -361,22 +392,22 @@ bool Aquamarine::CDRMBackend::checkFeatures() {
 
     uint64_t cap = 0;
     if (drmGetCap(gpu->fd, DRM_CAP_PRIME, &cap) || !(cap & DRM_PRIME_CAP_IMPORT)) {
-        backend->log(AQ_LOG_ERROR, std::format("drm: DRM_PRIME_CAP_IMPORT unsupported"));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: DRM_PRIME_CAP_IMPORT unsupported"));
         return false;
     }
 
     if (drmGetCap(gpu->fd, DRM_CAP_CRTC_IN_VBLANK_EVENT, &cap) || !cap) {
-        backend->log(AQ_LOG_ERROR, std::format("drm: DRM_CAP_CRTC_IN_VBLANK_EVENT unsupported"));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: DRM_CAP_CRTC_IN_VBLANK_EVENT unsupported"));
         return false;
     }
 
     if (drmGetCap(gpu->fd, DRM_CAP_TIMESTAMP_MONOTONIC, &cap) || !cap) {
-        backend->log(AQ_LOG_ERROR, std::format("drm: DRM_PRIME_CAP_IMPORT unsupported"));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: DRM_PRIME_CAP_IMPORT unsupported"));
         return false;
     }
 
     if (drmSetClientCap(gpu->fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1)) {
-        backend->log(AQ_LOG_ERROR, std::format("drm: DRM_CLIENT_CAP_UNIVERSAL_PLANES unsupported"));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: DRM_CLIENT_CAP_UNIVERSAL_PLANES unsupported"));
         return false;
     }
 
@@ -385,21 +416,26 @@ bool Aquamarine::CDRMBackend::checkFeatures() {
     drmProps.supportsTimelines       = drmGetCap(gpu->fd, DRM_CAP_SYNCOBJ_TIMELINE, &cap) == 0 && cap == 1;
 
     if (envEnabled("AQ_NO_ATOMIC")) {
-        backend->log(AQ_LOG_WARNING, "drm: AQ_NO_ATOMIC enabled, using the legacy drm iface");
+        AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_DRM, "drm: AQ_NO_ATOMIC enabled, using the legacy drm iface");
         impl = makeShared<CDRMLegacyImpl>(self.lock());
     } else if (drmSetClientCap(gpu->fd, DRM_CLIENT_CAP_ATOMIC, 1)) {
-        backend->log(AQ_LOG_WARNING, "drm: failed to set DRM_CLIENT_CAP_ATOMIC, falling back to legacy");
+        AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_DRM, "drm: failed to set DRM_CLIENT_CAP_ATOMIC, falling back to legacy");
         impl = makeShared<CDRMLegacyImpl>(self.lock());
     } else {
-        backend->log(AQ_LOG_DEBUG, "drm: Atomic supported, using atomic for modesetting");
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: Atomic supported, using atomic for modesetting");
         impl                         = makeShared<CDRMAtomicImpl>(self.lock());
         drmProps.supportsAsyncCommit = drmGetCap(gpu->fd, DRM_CAP_ATOMIC_ASYNC_PAGE_FLIP, &cap) == 0 && cap == 1;
         atomic                       = true;
+
+        if (envEnabled("AQ_DRM_COMMIT_THREAD")) {
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: AQ_DRM_COMMIT_THREAD enabled, blocking commits will run on a worker thread");
+            commitThread = makeShared<CDRMCommitThread>(backend.get());
+        }
     }
 
-    backend->log(AQ_LOG_DEBUG, std::format("drm: drmProps.supportsAsyncCommit: {}", drmProps.supportsAsyncCommit));
-    backend->log(AQ_LOG_DEBUG, std::format("drm: drmProps.supportsAddFb2Modifiers: {}", drmProps.supportsAddFb2Modifiers));
-    backend->log(AQ_LOG_DEBUG, std::format("drm: drmProps.supportsTimelines: {}", drmProps.supportsTimelines));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: drmProps.supportsAsyncCommit: {}", drmProps.supportsAsyncCommit));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: drmProps.supportsAddFb2Modifiers: {}", drmProps.supportsAddFb2Modifiers));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: drmProps.supportsTimelines: {}", drmProps.supportsTimelines));
 
     // TODO: allow no-modifiers?
 
@@ -409,11 +445,11 @@ bool Aquamarine::CDRMBackend::checkFeatures() {
 bool Aquamarine::CDRMBackend::initResources() {
     auto resources = drmModeGetResources(gpu->fd);
     if (!resources) {
-        backend->log(AQ_LOG_ERROR, std::format("drm: drmModeGetResources failed"));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: drmModeGetResources failed"));
         return false;
     }
 
-    backend->log(AQ_LOG_DEBUG, std::format("drm: found {} CRTCs", resources->count_crtcs));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: found {} CRTCs", resources->count_crtcs));
 
     for (size_t i = 0; i < resources->count_crtcs; ++i) {
         auto CRTC     = makeShared<SDRMCRTC>();
@@ -422,7 +458,7 @@ bool Aquamarine::CDRMBackend::initResources() {
 
         auto drmCRTC = drmModeGetCrtc(gpu->fd, CRTC->id);
         if (!drmCRTC) {
-            backend->log(AQ_LOG_ERROR, std::format("drm: drmModeGetCrtc for crtc {} failed", CRTC->id));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: drmModeGetCrtc for crtc {} failed", CRTC->id));
             drmModeFreeResources(resources);
             crtcs.clear();
             return false;
@@ -432,7 +468,7 @@ bool Aquamarine::CDRMBackend::initResources() {
         drmModeFreeCrtc(drmCRTC);
 
         if (!getDRMCRTCProps(gpu->fd, CRTC->id, &CRTC->props)) {
-            backend->log(AQ_LOG_ERROR, std::format("drm: getDRMCRTCProps for crtc {} failed", CRTC->id));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: getDRMCRTCProps for crtc {} failed", CRTC->id));
             drmModeFreeResources(resources);
             crtcs.clear();
             return false;
@@ -442,24 +478,24 @@ bool Aquamarine::CDRMBackend::initResources() {
     }
 
     if (crtcs.size() > 32) {
-        backend->log(AQ_LOG_CRITICAL, "drm: Cannot support more than 32 CRTCs");
+        AQLOG(backend, AQ_LOG_CRITICAL, AQ_SUBSYSTEM_DRM, "drm: Cannot support more than 32 CRTCs");
         return false;
     }
 
     // initialize planes
     auto planeResources = drmModeGetPlaneResources(gpu->fd);
     if (!planeResources) {
-        backend->log(AQ_LOG_ERROR, std::format("drm: drmModeGetPlaneResources failed"));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: drmModeGetPlaneResources failed"));
         return false;
     }
 
-    backend->log(AQ_LOG_DEBUG, std::format("drm: found {} planes", planeResources->count_planes));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: found {} planes", planeResources->count_planes));
 
     for (uint32_t i = 0; i < planeResources->count_planes; ++i) {
         auto id    = planeResources->planes[i];
         auto plane = drmModeGetPlane(gpu->fd, id);
         if (!plane) {
-            backend->log(AQ_LOG_ERROR, std::format("drm: drmModeGetPlane for plane {} failed", id));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: drmModeGetPlane for plane {} failed", id));
             drmModeFreeResources(resources);
             crtcs.clear();
             planes.clear();
@@ -470,7 +506,7 @@ bool Aquamarine::CDRMBackend::initResources() {
         aqPlane->backend = self;
         aqPlane->self    = aqPlane;
         if (!aqPlane->init((drmModePlane*)plane)) {
-            backend->log(AQ_LOG_ERROR, std::format("drm: aqPlane->init for plane {} failed", id));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: aqPlane->init for plane {} failed", id));
             drmModeFreeResources(resources);
             crtcs.clear();
             planes.clear();
@@ -500,14 +536,14 @@ bool Aquamarine::CDRMBackend::initMgpu() {
     mgpu.allocator    = newAllocator;
 
     if (!mgpu.allocator) {
-        backend->log(AQ_LOG_ERROR, "drm: initMgpu: no allocator");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: initMgpu: no allocator");
         return false;
     }
 
     mgpu.renderer = CDRMRenderer::attempt(newAllocator, backend.lock());
 
     if (!mgpu.renderer) {
-        backend->log(AQ_LOG_ERROR, "drm: initMgpu: no renderer");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: initMgpu: no renderer");
         return false;
     }
 
@@ -543,17 +579,17 @@ void Aquamarine::CDRMBackend::recheckCRTCs() {
     if (connectors.empty() || crtcs.empty())
         return;
 
-    backend->log(AQ_LOG_DEBUG, "drm: Rechecking CRTCs");
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: Rechecking CRTCs");
 
     std::vector<SP<SDRMConnector>> recheck, changed;
     for (auto& c : connectors) {
         if (c->crtc && c->status == DRM_MODE_CONNECTED) {
-            backend->log(AQ_LOG_DEBUG, std::format("drm: Skipping connector {}, has crtc {} and is connected", c->szName, c->crtc->id));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Skipping connector {}, has crtc {} and is connected", c->szName, c->crtc->id));
             continue;
         }
 
         recheck.emplace_back(c);
-        backend->log(AQ_LOG_DEBUG, std::format("drm: connector {}, has crtc {}, will be rechecked", c->szName, c->crtc ? (int)c->crtc->id : -1));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: connector {}, has crtc {}, will be rechecked", c->szName, c->crtc ? (int)c->crtc->id : -1));
     }
 
     for (size_t i = 0; i < crtcs.size(); ++i) {
@@ -565,7 +601,7 @@ void Aquamarine::CDRMBackend::recheckCRTCs() {
             if (c->status != DRM_MODE_CONNECTED)
                 continue;
 
-            backend->log(AQ_LOG_DEBUG, std::format("drm: slot {} crtc {} taken by {}, skipping", i, c->crtc->id, c->szName));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: slot {} crtc {} taken by {}, skipping", i, c->crtc->id, c->szName));
             taken = true;
             break;
         }
@@ -589,8 +625,8 @@ void Aquamarine::CDRMBackend::recheckCRTCs() {
                 c->output->commit();
             }
 
-            backend->log(AQ_LOG_DEBUG,
-                         std::format("drm: connected slot {} crtc {} assigned to {}{}", i, crtcs.at(i)->id, c->szName, c->crtc ? std::format(" (old {})", c->crtc->id) : ""));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM,
+                  std::format("drm: connected slot {} crtc {} assigned to {}{}", i, crtcs.at(i)->id, c->szName, c->crtc ? std::format(" (old {})", c->crtc->id) : ""));
             c->crtc  = crtcs.at(i);
             assigned = true;
             changed.emplace_back(c);
@@ -599,14 +635,15 @@ void Aquamarine::CDRMBackend::recheckCRTCs() {
         }
 
         if (!assigned)
-            backend->log(AQ_LOG_DEBUG, std::format("drm: slot {} crtc {} unassigned", i, crtcs.at(i)->id));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: slot {} crtc {} unassigned", i, crtcs.at(i)->id));
     }
 
     for (auto& c : connectors) {
         if (c->status == DRM_MODE_CONNECTED)
             continue;
 
-        backend->log(AQ_LOG_DEBUG, std::format("drm: Connector {} is not connected{}", c->szName, c->crtc ? std::format(", removing old crtc {}", c->crtc->id) : ""));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM,
+              std::format("drm: Connector {} is not connected{}", c->szName, c->crtc ? std::format(", removing old crtc {}", c->crtc->id) : ""));
     }
 
     // if any connectors get a crtc and are connected, we need to rescan to assign them outputs.
@@ -622,7 +659,7 @@ void Aquamarine::CDRMBackend::recheckCRTCs() {
             c->output->events.state.emit(IOutput::SStateEvent{});
     }
 
-    backend->log(AQ_LOG_DEBUG, "drm: rescanning after realloc");
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: rescanning after realloc");
     scanConnectors();
 }
 
@@ -644,26 +681,32 @@ bool Aquamarine::CDRMBackend::registerGPU(SP<CSessionDevice> gpu_, SP<CDRMBacken
     if (std::string_view(drmVerName) == "evdi")
         primary = {};
 
-    backend->log(AQ_LOG_DEBUG,
-                 std::format("drm: Starting backend for {}, with driver {}{}", drmName ? drmName : "unknown", drmVerName,
-                             (primary ? std::format(" with primary {}", primary->gpu->path) : "")));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM,
+          std::format("drm: Starting backend for {}, with driver {}{}", drmName ? drmName : "unknown", drmVerName,
+                      (primary ? std::format(" with primary {}", primary->gpu->path) : "")));
 
     drmFreeVersion(drmVer);
 
+    hotplugTimer = makeShared<CBackendTimer>([this]() {
+        scanConnectors();
+        recheckCRTCs();
+    });
+
     listeners.gpuChange = gpu->events.change.registerListener([this](std::any d) {
         auto E = std::any_cast<CSessionDevice::SChangeEvent>(d);
         if (E.type == CSessionDevice::AQ_SESSION_EVENT_CHANGE_HOTPLUG) {
-            backend->log(AQ_LOG_DEBUG, std::format("drm: Got a hotplug event for {}", gpuName));
-            scanConnectors();
-            recheckCRTCs();
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Got a hotplug event for {}", gpuName));
+            // connectors tend to send a burst of these when (un)plugged, rescan once it settles
+            backend->rescheduleTimer(hotplugTimer, std::chrono::milliseconds(HOTPLUG_DEBOUNCE_MS));
         } else if (E.type == CSessionDevice::AQ_SESSION_EVENT_CHANGE_LEASE) {
-            backend->log(AQ_LOG_DEBUG, std::format("drm: Got a lease event for {}", gpuName));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Got a lease event for {}", gpuName));
             scanLeases();
         }
     });
 
-    listeners.gpuRemove = gpu->events.remove.registerListener(
-        [this](std::any d) { backend->log(AQ_LOG_ERROR, std::format("drm: !!!!FIXME: Got a remove event for {}, this is not handled properly!!!!!", gpuName)); });
+    listeners.gpuRemove = gpu->events.remove.registerListener([this](std::any d) {
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: !!!!FIXME: Got a remove event for {}, this is not handled properly!!!!!", gpuName));
+    });
 
     return true;
 }
@@ -673,11 +716,11 @@ eBackendType Aquamarine::CDRMBackend::type() {
 }
 
 void Aquamarine::CDRMBackend::scanConnectors() {
-    backend->log(AQ_LOG_DEBUG, std::format("drm: Scanning connectors for {}", gpu->path));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Scanning connectors for {}", gpu->path));
 
     auto resources = drmModeGetResources(gpu->fd);
     if (!resources) {
-        backend->log(AQ_LOG_ERROR, std::format("drm: Scanning connectors for {} failed", gpu->path));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Scanning connectors for {} failed", gpu->path));
         return;
     }
 
@@ -687,44 +730,44 @@ void Aquamarine::CDRMBackend::scanConnectors() {
         SP<SDRMConnector> conn;
         auto              drmConn = drmModeGetConnector(gpu->fd, connectorID);
 
-        backend->log(AQ_LOG_DEBUG, std::format("drm: Scanning connector id {}", connectorID));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Scanning connector id {}", connectorID));
 
         if (!drmConn) {
-            backend->log(AQ_LOG_ERROR, std::format("drm: Failed to get connector id {}", connectorID));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Failed to get connector id {}", connectorID));
             continue;
         }
 
         auto it = std::find_if(connectors.begin(), connectors.end(), [connectorID](const auto& e) { return e->id == connectorID; });
         if (it == connectors.end()) {
-            backend->log(AQ_LOG_DEBUG, std::format("drm: Initializing connector id {}", connectorID));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Initializing connector id {}", connectorID));
             conn          = connectors.emplace_back(SP<SDRMConnector>(new SDRMConnector()));
             conn->self    = conn;
             conn->backend = self;
             conn->id      = connectorID;
             if (!conn->init(drmConn)) {
-                backend->log(AQ_LOG_ERROR, std::format("drm: Connector id {} failed initializing", connectorID));
+                AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Connector id {} failed initializing", connectorID));
                 connectors.pop_back();
                 continue;
             }
         } else {
-            backend->log(AQ_LOG_DEBUG, std::format("drm: Connector id {} already initialized", connectorID));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Connector id {} already initialized", connectorID));
             conn = *it;
         }
 
         conn->status = drmConn->connection;
 
         if (!conn->crtc) {
-            backend->log(AQ_LOG_DEBUG, std::format("drm: Ignoring connector {} because it has no CRTC", connectorID));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Ignoring connector {} because it has no CRTC", connectorID));
             continue;
         }
 
-        backend->log(AQ_LOG_DEBUG, std::format("drm: Connector {} connection state: {}", connectorID, (int)drmConn->connection));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Connector {} connection state: {}", connectorID, (int)drmConn->connection));
 
         if (conn->status == DRM_MODE_CONNECTED && !conn->output) {
-            backend->log(AQ_LOG_DEBUG, std::format("drm: Connector {} connected", conn->szName));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Connector {} connected", conn->szName));
             conn->connect(drmConn);
         } else if (conn->status != DRM_MODE_CONNECTED && conn->output) {
-            backend->log(AQ_LOG_DEBUG, std::format("drm: Connector {} disconnected", conn->szName));
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Connector {} disconnected", conn->szName));
             conn->disconnect();
         }
 
@@ -737,7 +780,7 @@ void Aquamarine::CDRMBackend::scanConnectors() {
 void Aquamarine::CDRMBackend::scanLeases() {
     auto lessees = drmModeListLessees(gpu->fd);
     if (!lessees) {
-        backend->log(AQ_LOG_ERROR, "drmModeListLessees failed");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drmModeListLessees failed");
         return;
     }
 
@@ -756,7 +799,7 @@ void Aquamarine::CDRMBackend::scanLeases() {
         if (has)
             continue;
 
-        backend->log(AQ_LOG_DEBUG, std::format("lessee {} gone, removing", c->output->lease->lesseeID));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("lessee {} gone, removing", c->output->lease->lesseeID));
 
         // don't terminate
         c->output->lease->active = false;
@@ -797,15 +840,21 @@ static void handlePF(int fd, unsigned seq, unsigned tv_sec, unsigned tv_usec, un
 
     pageFlip->connector->isPageFlipPending = false;
 
+    const bool MODESET                    = pageFlip->connector->isModesetPending;
+    pageFlip->connector->isModesetPending = false;
+
     const auto& BACKEND = pageFlip->connector->backend;
 
-    TRACE(BACKEND->log(AQ_LOG_TRACE, std::format("drm: pf event seq {} sec {} usec {} crtc {}", seq, tv_sec, tv_usec, crtc_id)));
+    TRACE(AQLOG(BACKEND, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("drm: pf event seq {} sec {} usec {} crtc {}", seq, tv_sec, tv_usec, crtc_id)));
 
     if (pageFlip->connector->status != DRM_MODE_CONNECTED || !pageFlip->connector->crtc) {
-        BACKEND->log(AQ_LOG_DEBUG, "drm: Ignoring a pf event from a disabled crtc / connector");
+        AQLOG(BACKEND, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: Ignoring a pf event from a disabled crtc / connector");
         return;
     }
 
+    if (MODESET)
+        pageFlip->connector->output->events.modeset.emit();
+
     pageFlip->connector->onPresent();
 
     uint32_t flags = IOutput::AQ_OUTPUT_PRESENT_VSYNC | IOutput::AQ_OUTPUT_PRESENT_HW_CLOCK | IOutput::AQ_OUTPUT_PRESENT_HW_COMPLETION | IOutput::AQ_OUTPUT_PRESENT_ZEROCOPY;
@@ -831,11 +880,85 @@ bool Aquamarine::CDRMBackend::dispatchEvents() {
     };
 
     if (drmHandleEvent(gpu->fd, &event) != 0)
-        backend->log(AQ_LOG_ERROR, std::format("drm: Failed to handle event on fd {}", gpu->fd));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Failed to handle event on fd {}", gpu->fd));
 
     return true;
 }
 
+Aquamarine::CDRMCommitThread::CDRMCommitThread(CBackend* backend_) : backend(backend_), queue(std::make_shared<SQueue>()) {
+    thread = std::thread([q = queue, this]() {
+        while (true) {
+            std::function<int(void)> job;
+
+            {
+                std::unique_lock lk(q->lock);
+                q->signal.wait(lk, [&q]() { return q->exit || !q->jobs.empty(); });
+
+                if (q->jobs.empty())
+                    return; // exiting, and nothing left to do
+
+                job = std::move(q->jobs.front());
+                q->jobs.pop_front();
+            }
+
+            const int RET = job();
+
+            {
+                std::lock_guard lg(q->lock);
+                q->results.emplace_back(RET);
+            }
+
+            // the task can outlive us, hence the weak ref
+            backend->postToLoop([wq = std::weak_ptr<SQueue>(q), this]() {
+                if (!wq.expired())
+                    dispatchCompletions();
+            });
+        }
+    });
+}
+
+Aquamarine::CDRMCommitThread::~CDRMCommitThread() {
+    {
+        std::lock_guard lg(queue->lock);
+        queue->exit = true;
+    }
+    queue->signal.notify_all();
+
+    if (thread.joinable())
+        thread.join();
+}
+
+void Aquamarine::CDRMCommitThread::submit(std::function<int(void)> job, std::function<void(int)> onDone) {
+    pending.emplace_back(std::move(onDone));
+
+    {
+        std::lock_guard lg(queue->lock);
+        queue->jobs.emplace_back(std::move(job));
+    }
+    queue->signal.notify_one();
+}
+
+void Aquamarine::CDRMCommitThread::dispatchCompletions() {
+    std::vector<int> results;
+
+    {
+        std::lock_guard lg(queue->lock);
+        results.swap(queue->results);
+    }
+
+    // jobs complete in order, so the results line up with pending
+    for (const auto& r : results) {
+        if (pending.empty())
+            break;
+
+        auto onDone = std::move(pending.front());
+        pending.pop_front();
+
+        if (onDone)
+            onDone(r);
+    }
+}
+
 uint32_t Aquamarine::CDRMBackend::capabilities() {
     return eBackendCapabilities::AQ_BACKEND_CAPABILITY_POINTER;
 }
@@ -845,20 +968,20 @@ bool Aquamarine::CDRMBackend::setCursor(SP<IBuffer> buffer, const Hyprutils::Mat
 }
 
 void Aquamarine::CDRMBackend::onReady() {
-    backend->log(AQ_LOG_DEBUG, std::format("drm: Connectors size2 {}", connectors.size()));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Connectors size2 {}", connectors.size()));
 
     // init a drm renderer to gather gl formats.
     // if we are secondary, initMgpu will have done that
     if (!primary) {
         auto a = CGBMAllocator::create(backend->reopenDRMNode(gpu->fd), backend);
         if (!a)
-            backend->log(AQ_LOG_ERROR, "drm: onReady: no renderer for gl formats");
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: onReady: no renderer for gl formats");
         else {
             auto r = CDRMRenderer::attempt(a, backend.lock());
             if (!r)
-                backend->log(AQ_LOG_ERROR, "drm: onReady: no renderer for gl formats");
+                AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: onReady: no renderer for gl formats");
             else {
-                TRACE(backend->log(AQ_LOG_TRACE, std::format("drm: onReady: gathered {} gl formats", r->formats.size())));
+                TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("drm: onReady: gathered {} gl formats", r->formats.size())));
                 buildGlFormats(r->formats);
                 r.reset();
                 a.reset();
@@ -867,11 +990,11 @@ void Aquamarine::CDRMBackend::onReady() {
     }
 
     for (auto& c : connectors) {
-        backend->log(AQ_LOG_DEBUG, std::format("drm: onReady: connector {}", c->id));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: onReady: connector {}", c->id));
         if (!c->output)
             continue;
 
-        backend->log(AQ_LOG_DEBUG, std::format("drm: onReady: connector {} has output name {}", c->id, c->output->name));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: onReady: connector {} has output name {}", c->id, c->output->name));
 
         // swapchain has to be created here because allocator is absent in connect if not ready
         c->output->swapchain = CSwapchain::create(backend->primaryAllocator, self.lock());
@@ -882,7 +1005,7 @@ void Aquamarine::CDRMBackend::onReady() {
     }
 
     if (!initMgpu()) {
-        backend->log(AQ_LOG_ERROR, "drm: Failed initializing mgpu");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Failed initializing mgpu");
         return;
     }
 }
@@ -908,7 +1031,7 @@ std::vector<SDRMFormat> Aquamarine::CDRMBackend::getCursorFormats() {
             continue;
 
         if (primary) {
-            TRACE(backend->log(AQ_LOG_TRACE, std::format("drm: getCursorFormats on secondary {}", gpu->path)));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("drm: getCursorFormats on secondary {}", gpu->path)));
 
             // this is a secondary GPU renderer. In order to receive buffers,
             // we'll force linear modifiers.
@@ -934,12 +1057,12 @@ int Aquamarine::CDRMBackend::getNonMasterFD() {
     int fd = open(gpuName.c_str(), O_RDWR | O_CLOEXEC);
 
     if (fd < 0) {
-        backend->log(AQ_LOG_ERROR, "drm: couldn't dupe fd for non master");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: couldn't dupe fd for non master");
         return -1;
     }
 
     if (drmIsMaster(fd) && drmDropMaster(fd) < 0) {
-        backend->log(AQ_LOG_ERROR, "drm: couldn't drop master from duped fd");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: couldn't drop master from duped fd");
         return -1;
     }
 
@@ -961,9 +1084,9 @@ bool Aquamarine::SDRMPlane::init(drmModePlane* plane) {
 
     initialID = id;
 
-    backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Plane {} has type {}", id, (int)type));
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Plane {} has type {}", id, (int)type));
 
-    backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Plane {} has {} formats", id, plane->count_formats));
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Plane {} has {} formats", id, plane->count_formats));
 
     for (size_t i = 0; i < plane->count_formats; ++i) {
         if (type != DRM_PLANE_TYPE_CURSOR)
@@ -971,21 +1094,21 @@ bool Aquamarine::SDRMPlane::init(drmModePlane* plane) {
         else
             formats.emplace_back(SDRMFormat{.drmFormat = plane->formats[i], .modifiers = {DRM_FORMAT_MOD_LINEAR}});
 
-        TRACE(backend->backend->log(AQ_LOG_TRACE, std::format("drm: | Format {}", fourccToName(plane->formats[i]))));
+        TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("drm: | Format {}", fourccToName(plane->formats[i]))));
     }
 
     if (props.in_formats && backend->drmProps.supportsAddFb2Modifiers) {
-        backend->backend->log(AQ_LOG_DEBUG, "drm: Plane: checking for modifiers");
+        AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: Plane: checking for modifiers");
 
         uint64_t blobID = 0;
         if (!getDRMProp(backend->gpu->fd, id, props.in_formats, &blobID)) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: Plane: No blob id");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Plane: No blob id");
             return false;
         }
 
         auto blob = drmModeGetPropertyBlob(backend->gpu->fd, blobID);
         if (!blob) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: Plane: No property");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Plane: No property");
             return false;
         }
 
@@ -993,7 +1116,7 @@ bool Aquamarine::SDRMPlane::init(drmModePlane* plane) {
         while (drmModeFormatModifierBlobIterNext(blob, &iter)) {
             auto it = std::find_if(formats.begin(), formats.end(), [iter](const auto& e) { return e.drmFormat == iter.fmt; });
 
-            TRACE(backend->backend->log(AQ_LOG_TRACE, std::format("drm: | Modifier {} with format {}", iter.mod, fourccToName(iter.fmt))));
+            TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("drm: | Modifier {} with format {}", iter.mod, fourccToName(iter.fmt))));
 
             if (it == formats.end())
                 formats.emplace_back(SDRMFormat{.drmFormat = iter.fmt, .modifiers = {iter.mod}});
@@ -1027,36 +1150,36 @@ bool Aquamarine::SDRMPlane::init(drmModePlane* plane) {
 SP<SDRMCRTC> Aquamarine::SDRMConnector::getCurrentCRTC(const drmModeConnector* connector) {
     uint32_t crtcID = 0;
     if (props.crtc_id) {
-        TRACE(backend->backend->log(AQ_LOG_TRACE, "drm: Using crtc_id for finding crtc"));
+        TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: Using crtc_id for finding crtc"));
         uint64_t value = 0;
         if (!getDRMProp(backend->gpu->fd, id, props.crtc_id, &value)) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: Failed to get CRTC_ID");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Failed to get CRTC_ID");
             return nullptr;
         }
         crtcID = static_cast<uint32_t>(value);
     } else if (connector->encoder_id) {
-        TRACE(backend->backend->log(AQ_LOG_TRACE, "drm: Using encoder_id for finding crtc"));
+        TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: Using encoder_id for finding crtc"));
         auto encoder = drmModeGetEncoder(backend->gpu->fd, connector->encoder_id);
         if (!encoder) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: drmModeGetEncoder failed");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: drmModeGetEncoder failed");
             return nullptr;
         }
         crtcID = encoder->crtc_id;
         drmModeFreeEncoder(encoder);
     } else {
-        backend->backend->log(AQ_LOG_ERROR, "drm: Connector has neither crtc_id nor encoder_id");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Connector has neither crtc_id nor encoder_id");
         return nullptr;
     }
 
     if (crtcID == 0) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: getCurrentCRTC: No CRTC 0");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: getCurrentCRTC: No CRTC 0");
         return nullptr;
     }
 
     auto it = std::find_if(backend->crtcs.begin(), backend->crtcs.end(), [crtcID](const auto& e) { return e->id == crtcID; });
 
     if (it == backend->crtcs.end()) {
-        backend->backend->log(AQ_LOG_ERROR, std::format("drm: Failed to find a CRTC with ID {}", crtcID));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Failed to find a CRTC with ID {}", crtcID));
         return nullptr;
     }
 
@@ -1074,11 +1197,11 @@ bool Aquamarine::SDRMConnector::init(drmModeConnector* connector) {
         name = "ERROR";
 
     szName = std::format("{}-{}", name, connector->connector_type_id);
-    backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Connector gets name {}", szName));
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Connector gets name {}", szName));
 
     possibleCrtcs = drmModeConnectorGetPossibleCrtcs(backend->gpu->fd, connector);
     if (!possibleCrtcs)
-        backend->backend->log(AQ_LOG_ERROR, "drm: No CRTCs possible");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: No CRTCs possible");
 
     crtc = getCurrentCRTC(connector);
 
@@ -1136,7 +1259,7 @@ drmModeModeInfo* Aquamarine::SDRMConnector::getCurrentMode() {
 void Aquamarine::SDRMConnector::parseEDID(std::vector<uint8_t> data) {
     auto info = di_info_parse_edid(data.data(), data.size());
     if (!info) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: failed to parse edid");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: failed to parse edid");
         return;
     }
 
@@ -1159,17 +1282,17 @@ void Aquamarine::SDRMConnector::parseEDID(std::vector<uint8_t> data) {
 
 void Aquamarine::SDRMConnector::connect(drmModeConnector* connector) {
     if (output) {
-        backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Not connecting connector {} because it's already connected", szName));
+        AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Not connecting connector {} because it's already connected", szName));
         return;
     }
 
-    backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Connecting connector {}, CRTC ID {}", szName, crtc ? crtc->id : -1));
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Connecting connector {}, CRTC ID {}", szName, crtc ? crtc->id : -1));
 
     output            = SP<CDRMOutput>(new CDRMOutput(szName, backend, self.lock()));
     output->self      = output;
     output->connector = self.lock();
 
-    backend->backend->log(AQ_LOG_DEBUG, "drm: Dumping detected modes:");
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: Dumping detected modes:");
 
     auto currentModeInfo = getCurrentMode();
 
@@ -1177,7 +1300,7 @@ void Aquamarine::SDRMConnector::connect(drmModeConnector* connector) {
         auto& drmMode = connector->modes[i];
 
         if (drmMode.flags & DRM_MODE_FLAG_INTERLACE) {
-            backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Skipping mode {} because it's interlaced", i));
+            AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Skipping mode {} because it's interlaced", i));
             continue;
         }
 
@@ -1201,9 +1324,9 @@ void Aquamarine::SDRMConnector::connect(drmModeConnector* connector) {
             crtc->refresh = calculateRefresh(drmMode);
         }
 
-        backend->backend->log(AQ_LOG_DEBUG,
-                              std::format("drm: Mode {}: {}x{}@{:.2f}Hz {}", i, (int)aqMode->pixelSize.x, (int)aqMode->pixelSize.y, aqMode->refreshRate / 1000.0,
-                                          aqMode->preferred ? " (preferred)" : ""));
+        AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM,
+              std::format("drm: Mode {}: {}x{}@{:.2f}Hz {}", i, (int)aqMode->pixelSize.x, (int)aqMode->pixelSize.y, aqMode->refreshRate / 1000.0,
+                          aqMode->preferred ? " (preferred)" : ""));
     }
 
     if (!currentModeInfo && fallbackMode) {
@@ -1213,7 +1336,7 @@ void Aquamarine::SDRMConnector::connect(drmModeConnector* connector) {
 
     output->physicalSize = {(double)connector->mmWidth, (double)connector->mmHeight};
 
-    backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Physical size {} (mm)", output->physicalSize));
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Physical size {} (mm)", output->physicalSize));
 
     switch (connector->subpixel) {
         case DRM_MODE_SUBPIXEL_NONE: output->subpixel = eSubpixelMode::AQ_SUBPIXEL_NONE; break;
@@ -1228,21 +1351,21 @@ void Aquamarine::SDRMConnector::connect(drmModeConnector* connector) {
     uint64_t prop = 0;
     if (getDRMProp(backend->gpu->fd, id, props.non_desktop, &prop)) {
         if (prop == 1)
-            backend->backend->log(AQ_LOG_DEBUG, "drm: Non-desktop connector");
+            AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm: Non-desktop connector");
         output->nonDesktop = prop;
     }
 
     canDoVrr           = props.vrr_capable && crtc->props.vrr_enabled && getDRMProp(backend->gpu->fd, id, props.vrr_capable, &prop) && prop;
     output->vrrCapable = canDoVrr;
 
-    backend->backend->log(AQ_LOG_DEBUG,
-                          std::format("drm: crtc is {} of vrr: props.vrr_capable -> {}, crtc->props.vrr_enabled -> {}", (canDoVrr ? "capable" : "incapable"), props.vrr_capable,
-                                      crtc->props.vrr_enabled));
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM,
+          std::format("drm: crtc is {} of vrr: props.vrr_capable -> {}, crtc->props.vrr_enabled -> {}", (canDoVrr ? "capable" : "incapable"), props.vrr_capable,
+                      crtc->props.vrr_enabled));
 
     maxBpcBounds.fill(0);
 
     if (props.max_bpc && !introspectDRMPropRange(backend->gpu->fd, props.max_bpc, maxBpcBounds.data(), &maxBpcBounds[1]))
-        backend->backend->log(AQ_LOG_ERROR, "drm: Failed to check max_bpc");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Failed to check max_bpc");
 
     size_t               edidLen  = 0;
     uint8_t*             edidData = (uint8_t*)getDRMPropBlob(backend->gpu->fd, id, props.edid, &edidLen);
@@ -1255,16 +1378,17 @@ void Aquamarine::SDRMConnector::connect(drmModeConnector* connector) {
 
     // TODO: subconnectors
 
-    output->make             = make;
-    output->model            = model;
-    output->serial           = serial;
-    output->description      = std::format("{} {} {} ({})", make, model, serial, szName);
-    output->needsFrame       = true;
-    output->supportsExplicit = backend->drmProps.supportsTimelines && crtc->props.out_fence_ptr && crtc->primary->props.in_fence_fd;
+    output->make                    = make;
+    output->model                   = model;
+    output->serial                  = serial;
+    output->description             = std::format("{} {} {} ({})", make, model, serial, szName);
+    output->needsFrame              = true;
+    output->supportsExplicit        = backend->drmProps.supportsTimelines && crtc->props.out_fence_ptr && crtc->primary->props.in_fence_fd;
+    output->supportsExplicitInFence = output->supportsExplicit;
 
-    backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Explicit sync {}", output->supportsExplicit ? "supported" : "unsupported"));
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Explicit sync {}", output->supportsExplicit ? "supported" : "unsupported"));
 
-    backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Description {}", output->description));
+    AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Description {}", output->description));
 
     status = DRM_MODE_CONNECTED;
 
@@ -1278,7 +1402,7 @@ void Aquamarine::SDRMConnector::connect(drmModeConnector* connector) {
 
 void Aquamarine::SDRMConnector::disconnect() {
     if (!output) {
-        backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Not disconnecting connector {} because it's already disconnected", szName));
+        AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Not disconnecting connector {} because it's already disconnected", szName));
         return;
     }
 
@@ -1348,6 +1472,7 @@ void Aquamarine::SDRMConnector::onPresent() {
 Aquamarine::CDRMOutput::~CDRMOutput() {
     backend->backend->removeIdleEvent(frameIdle);
     connector->isPageFlipPending   = false;
+    connector->isModesetPending    = false;
     connector->frameEventScheduled = false;
 }
 
@@ -1355,6 +1480,29 @@ bool Aquamarine::CDRMOutput::commit() {
     return commitState();
 }
 
+void Aquamarine::CDRMOutput::restoreState(const COutputState::SInternalState& previous, bool previousNoBuffer, const COutputState::SInternalState& failed) {
+    state->currentState = previous;
+    lastCommitNoBuffer  = previousNoBuffer;
+
+    // onCommit() already cleared these from the pending mask, without them the next commit wouldn't modeset.
+    // Whatever the consumer set again meanwhile wins.
+    auto&          pending = state->internalState;
+    const uint32_t REDO    = failed.committed & ~pending.committed &
+        (COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_ENABLED | COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_MODE |
+         COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_FORMAT);
+
+    if (REDO & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_ENABLED)
+        pending.enabled = failed.enabled;
+    if (REDO & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_MODE) {
+        pending.mode       = failed.mode;
+        pending.customMode = failed.customMode;
+    }
+    if (REDO & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_FORMAT)
+        pending.drmFormat = failed.drmFormat;
+
+    pending.committed |= REDO;
+}
+
 bool Aquamarine::CDRMOutput::test() {
     return commitState(true);
 }
@@ -1364,14 +1512,24 @@ void Aquamarine::CDRMOutput::setCursorVisible(bool visible) {
     scheduleFrame(AQ_SCHEDULE_CURSOR_VISIBLE);
 }
 
+static bool sameMode(SP<SOutputMode> a, SP<SOutputMode> b) {
+    if (a == b)
+        return true;
+
+    if (!a || !b || a->pixelSize != b->pixelSize || a->refreshRate != b->refreshRate || a->modeInfo.has_value() != b->modeInfo.has_value())
+        return false;
+
+    return !a->modeInfo.has_value() || memcmp(&*a->modeInfo, &*b->modeInfo, sizeof(drmModeModeInfo)) == 0;
+}
+
 bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
     if (!backend->backend->session->active) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: Session inactive");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Session inactive");
         return false;
     }
 
     if (!connector->crtc) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: No CRTC attached to output");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: No CRTC attached to output");
         return false;
     }
 
@@ -1380,38 +1538,44 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
 
     if ((COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_ENABLED) && STATE.enabled) {
         if (!STATE.mode && !STATE.customMode) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: No mode on enable commit");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: No mode on enable commit");
             return false;
         }
     }
 
     if (STATE.adaptiveSync && !connector->canDoVrr) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: No Adaptive sync support for output");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: No Adaptive sync support for output");
         return false;
     }
 
     if (STATE.presentationMode == AQ_OUTPUT_PRESENTATION_IMMEDIATE && !backend->drmProps.supportsAsyncCommit) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: No Immediate presentation support in the backend");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: No Immediate presentation support in the backend");
         return false;
     }
 
     if ((COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_BUFFER) && !STATE.buffer) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: No buffer committed");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: No buffer committed");
         return false;
     }
 
     if ((COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_BUFFER) && STATE.buffer->attachments.has(AQ_ATTACHMENT_DRM_KMS_UNIMPORTABLE)) {
-        TRACE(backend->backend->log(AQ_LOG_TRACE, "drm: Cannot commit a KMS-unimportable buffer."));
+        TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: Cannot commit a KMS-unimportable buffer."));
         return false;
     }
 
     // If we are changing the rendering format, we may need to reconfigure the output (aka modeset)
-    // which may result in some glitches
-    const bool NEEDS_RECONFIG = COMMITTED &
-        (COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_ENABLED | COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_FORMAT |
-         COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_MODE);
-
-    const bool BLOCKING = NEEDS_RECONFIG || !(COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_BUFFER);
+    // which may result in some glitches. Only modeset for what actually differs from the last commit,
+    // consumers tend to re-set the same mode / format. Disabling always goes through.
+    const auto& CURRENT        = state->current();
+    const bool  ENABLE_CHANGED = (COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_ENABLED) && (!STATE.enabled || !CURRENT.enabled);
+    const bool  FORMAT_CHANGED = (COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_FORMAT) && STATE.drmFormat != CURRENT.drmFormat;
+    const bool  MODE_CHANGED   = (COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_MODE) &&
+        !sameMode(STATE.mode ? STATE.mode.lock() : STATE.customMode, CURRENT.mode ? CURRENT.mode.lock() : CURRENT.customMode);
+    const bool NEEDS_RECONFIG = ENABLE_CHANGED || FORMAT_CHANGED || MODE_CHANGED;
+
+    // modesets with a buffer go nonblocking too, completion is signalled by the pf event.
+    // Without a buffer there is no pf event to wait for, so those still block.
+    const bool BLOCKING = !STATE.enabled || !(COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_BUFFER);
 
     const auto MODE = STATE.mode ? STATE.mode : STATE.customMode;
 
@@ -1423,14 +1587,24 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
     if (!onlyTest) {
         if (NEEDS_RECONFIG) {
             if (STATE.enabled)
-                backend->backend->log(AQ_LOG_DEBUG,
-                                      std::format("drm: Modesetting {} with {}x{}@{:.2f}Hz", name, (int)MODE->pixelSize.x, (int)MODE->pixelSize.y, MODE->refreshRate / 1000.F));
+                AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM,
+                      std::format("drm: Modesetting {} with {}x{}@{:.2f}Hz", name, (int)MODE->pixelSize.x, (int)MODE->pixelSize.y, MODE->refreshRate / 1000.F));
             else
-                backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Disabling output {}", name));
+                AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Disabling output {}", name));
         }
 
         if ((NEEDS_RECONFIG || (COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_BUFFER)) && connector->isPageFlipPending) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: Cannot commit when a page-flip is awaiting");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Cannot commit when a page-flip is awaiting");
+            return false;
+        }
+
+        if (connector->isCommitInFlight) {
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Cannot commit while the previous commit is still in flight");
+            return false;
+        }
+
+        if (connector->isModesetPending) {
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Cannot commit while a modeset is being applied");
             return false;
         }
 
@@ -1449,15 +1623,15 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
     SDRMConnectorCommitData data;
 
     if (STATE.buffer) {
-        TRACE(backend->backend->log(AQ_LOG_TRACE, "drm: Committed a buffer, updating state"));
+        TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: Committed a buffer, updating state"));
 
         SP<CDRMFB> drmFB;
 
         if (backend->shouldBlit()) {
-            TRACE(backend->backend->log(AQ_LOG_TRACE, "drm: Backend requires blit, blitting"));
+            TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: Backend requires blit, blitting"));
 
             if (!mgpu.swapchain) {
-                TRACE(backend->backend->log(AQ_LOG_TRACE, "drm: No swapchain for blit, creating"));
+                TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: No swapchain for blit, creating"));
                 mgpu.swapchain = CSwapchain::create(backend->mgpu.allocator, backend.lock());
             }
 
@@ -1470,7 +1644,7 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
             OPTIONS.cursor   = false;
             OPTIONS.scanout  = true;
             if (!mgpu.swapchain->reconfigure(OPTIONS)) {
-                backend->backend->log(AQ_LOG_ERROR, "drm: Backend requires blit, but the mgpu swapchain failed reconfiguring");
+                AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Backend requires blit, but the mgpu swapchain failed reconfiguring");
                 return false;
             }
 
@@ -1478,7 +1652,7 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
             auto blitResult = backend->mgpu.renderer->blit(STATE.buffer, NEWAQBUF,
                                                            (COMMITTED & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_EXPLICIT_IN_FENCE) ? STATE.explicitInFence : -1);
             if (!blitResult.success) {
-                backend->backend->log(AQ_LOG_ERROR, "drm: Backend requires blit, but blit failed");
+                AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Backend requires blit, but blit failed");
                 return false;
             }
 
@@ -1495,12 +1669,12 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
             drmFB = CDRMFB::create(STATE.buffer, backend, nullptr); // will return attachment if present
 
         if (!drmFB) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: Buffer failed to import to KMS");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Buffer failed to import to KMS");
             return false;
         }
 
         if (drmFB->dead) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: KMS buffer is dead?!");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: KMS buffer is dead?!");
             return false;
         }
 
@@ -1512,9 +1686,9 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
     if (data.mainFB) {
         if (const auto params = data.mainFB->buffer->dmabuf(); params.success && params.format != STATE.drmFormat) {
             // formats mismatch. Update the state format and roll with it
-            backend->backend->log(AQ_LOG_WARNING,
-                                  std::format("drm: Formats mismatch in commit, buffer is {} but output is set to {}. Modesetting to {}", fourccToName(params.format),
-                                              fourccToName(STATE.drmFormat), fourccToName(params.format)));
+            AQLOG(backend->backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_DRM,
+                  std::format("drm: Formats mismatch in commit, buffer is {} but output is set to {}. Modesetting to {}", fourccToName(params.format),
+                              fourccToName(STATE.drmFormat), fourccToName(params.format)));
             state->setFormat(params.format);
             formatMismatch = true;
             // TODO: reject if tearing? We will miss a frame event!
@@ -1533,7 +1707,7 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
         // TODO: add an API to detect this and request drm_dumb linear buffers. Or do something,
         // idk
         if (data.cursorFB->dead || data.cursorFB->buffer->dmabuf().modifier == DRM_FORMAT_MOD_INVALID) {
-            TRACE(backend->backend->log(AQ_LOG_TRACE, "drm: Dropping invalid buffer for cursor plane"));
+            TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: Dropping invalid buffer for cursor plane"));
             data.cursorFB = nullptr;
         }
     }
@@ -1549,6 +1723,13 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
 
     bool ok = connector->commitState(data);
 
+    if (!ok && data.modeset && !data.blocking && !onlyTest) {
+        // nonblocking modesets fail with EBUSY when they pull in crtc state another output's modeset still holds, a blocking one waits for it
+        TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: nonblocking modeset failed, retrying blocking"));
+        data.blocking = true;
+        ok            = connector->commitState(data);
+    }
+
     if (!ok && !data.modeset && !connector->commitTainted) {
         // attempt to re-modeset, however, flip a tainted flag if the modesetting fails
         // to avoid doing this over and over.
@@ -1570,6 +1751,10 @@ bool Aquamarine::CDRMOutput::commitState(bool onlyTest) {
     lastCommitNoBuffer = !data.mainFB;
     needsFrame         = false;
 
+    // blocking modesets are active by now, nonblocking ones report in from the pf event
+    if (data.modeset && !connector->isModesetPending && !connector->isCommitInFlight)
+        events.modeset.emit();
+
     if (ok)
         connector->commitTainted = false;
 
@@ -1604,7 +1789,7 @@ SP<IBackendImplementation> Aquamarine::CDRMOutput::getBackend() {
 
 bool Aquamarine::CDRMOutput::setCursor(SP<IBuffer> buffer, const Vector2D& hotspot) {
     if (buffer && !buffer->dmabuf().success) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: Cursor buffer has to be a dmabuf");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Cursor buffer has to be a dmabuf");
         return false;
     }
 
@@ -1614,10 +1799,10 @@ bool Aquamarine::CDRMOutput::setCursor(SP<IBuffer> buffer, const Vector2D& hotsp
         SP<CDRMFB> fb;
 
         if (backend->primary) {
-            TRACE(backend->backend->log(AQ_LOG_TRACE, "drm: Backend requires cursor blit, blitting"));
+            TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: Backend requires cursor blit, blitting"));
 
             if (!mgpu.cursorSwapchain) {
-                TRACE(backend->backend->log(AQ_LOG_TRACE, "drm: No cursorSwapchain for blit, creating"));
+                TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "drm: No cursorSwapchain for blit, creating"));
                 mgpu.cursorSwapchain = CSwapchain::create(backend->mgpu.allocator, backend.lock());
             }
 
@@ -1630,13 +1815,13 @@ bool Aquamarine::CDRMOutput::setCursor(SP<IBuffer> buffer, const Vector2D& hotsp
             OPTIONS.length   = 2;
 
             if (!mgpu.cursorSwapchain->reconfigure(OPTIONS)) {
-                backend->backend->log(AQ_LOG_ERROR, "drm: Backend requires blit, but the mgpu cursorSwapchain failed reconfiguring");
+                AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Backend requires blit, but the mgpu cursorSwapchain failed reconfiguring");
                 return false;
             }
 
             auto NEWAQBUF = mgpu.cursorSwapchain->next(nullptr);
             if (!backend->mgpu.renderer->blit(buffer, NEWAQBUF).success) {
-                backend->backend->log(AQ_LOG_ERROR, "drm: Backend requires blit, but cursor blit failed");
+                AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Backend requires blit, but cursor blit failed");
                 return false;
             }
 
@@ -1645,13 +1830,13 @@ bool Aquamarine::CDRMOutput::setCursor(SP<IBuffer> buffer, const Vector2D& hotsp
             fb = CDRMFB::create(buffer, backend, nullptr);
 
         if (!fb) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: Cursor buffer failed to import to KMS");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Cursor buffer failed to import to KMS");
             return false;
         }
 
         cursorHotspot = hotspot;
 
-        backend->backend->log(AQ_LOG_DEBUG, std::format("drm: Cursor buffer imported into KMS with id {}", fb->id));
+        AQLOG(backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm: Cursor buffer imported into KMS with id {}", fb->id));
 
         connector->crtc->pendingCursor = fb;
 
@@ -1669,12 +1854,12 @@ void Aquamarine::CDRMOutput::moveCursor(const Vector2D& coord, bool skipShedule)
 }
 
 void Aquamarine::CDRMOutput::scheduleFrame(const scheduleFrameReason reason) {
-    TRACE(backend->backend->log(AQ_LOG_TRACE,
-                                std::format("CDRMOutput::scheduleFrame: reason {}, needsFrame {}, isPageFlipPending {}, frameEventScheduled {}", (uint32_t)reason, needsFrame,
-                                            connector->isPageFlipPending, connector->frameEventScheduled)));
+    TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM,
+                std::format("CDRMOutput::scheduleFrame: reason {}, needsFrame {}, isPageFlipPending {}, frameEventScheduled {}", (uint32_t)reason, needsFrame,
+                            connector->isPageFlipPending, connector->frameEventScheduled)));
     needsFrame = true;
 
-    if (connector->isPageFlipPending || connector->frameEventScheduled)
+    if (connector->isPageFlipPending || connector->isCommitInFlight || connector->frameEventScheduled)
         return;
 
     connector->frameEventScheduled = true;
@@ -1688,13 +1873,13 @@ Vector2D Aquamarine::CDRMOutput::cursorPlaneSize() {
 
 size_t Aquamarine::CDRMOutput::getGammaSize() {
     if (!backend->atomic) {
-        backend->log(AQ_LOG_ERROR, "No support for gamma on the legacy iface");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "No support for gamma on the legacy iface");
         return 0;
     }
 
     uint64_t size = 0;
     if (!getDRMProp(backend->gpu->fd, connector->crtc->id, connector->crtc->props.gamma_lut_size, &size)) {
-        backend->log(AQ_LOG_ERROR, "Couldn't get the gamma_size prop");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "Couldn't get the gamma_size prop");
         return 0;
     }
 
@@ -1715,7 +1900,7 @@ Aquamarine::CDRMOutput::CDRMOutput(const std::string& name_, Hyprutils::Memory::
 
     frameIdle = makeShared<std::function<void(void)>>([this]() {
         connector->frameEventScheduled = false;
-        if (connector->isPageFlipPending)
+        if (connector->isPageFlipPending || connector->isCommitInFlight)
             return;
         events.frame.emit();
     });
@@ -1731,7 +1916,7 @@ SP<CDRMFB> Aquamarine::CDRMFB::create(SP<IBuffer> buffer_, Hyprutils::Memory::CW
     if (buffer_->attachments.has(AQ_ATTACHMENT_DRM_BUFFER)) {
         auto at = (CDRMBufferAttachment*)buffer_->attachments.get(AQ_ATTACHMENT_DRM_BUFFER).get();
         fb      = at->fb;
-        TRACE(backend_->log(AQ_LOG_TRACE, std::format("drm: CDRMFB: buffer has drmfb attachment with fb {:x}", (uintptr_t)fb.get())));
+        TRACE(AQLOG(backend_, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("drm: CDRMFB: buffer has drmfb attachment with fb {:x}", (uintptr_t)fb.get())));
     }
 
     if (fb) {
@@ -1757,12 +1942,12 @@ Aquamarine::CDRMFB::CDRMFB(SP<IBuffer> buffer_, Hyprutils::Memory::CWeakPointer<
 void Aquamarine::CDRMFB::import() {
     auto attrs = buffer->dmabuf();
     if (!attrs.success) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: Buffer submitted has no dmabuf");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Buffer submitted has no dmabuf");
         return;
     }
 
     if (buffer->attachments.has(AQ_ATTACHMENT_DRM_KMS_UNIMPORTABLE)) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: Buffer submitted is unimportable");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Buffer submitted is unimportable");
         return;
     }
 
@@ -1771,23 +1956,23 @@ void Aquamarine::CDRMFB::import() {
     for (int i = 0; i < attrs.planes; ++i) {
         int ret = drmPrimeFDToHandle(backend->gpu->fd, attrs.fds.at(i), &boHandles[i]);
         if (ret) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: drmPrimeFDToHandle failed");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: drmPrimeFDToHandle failed");
             drop();
             return;
         }
 
-        TRACE(backend->backend->log(AQ_LOG_TRACE, std::format("drm: CDRMFB: plane {} has fd {}, got handle {}", i, attrs.fds.at(i), boHandles.at(i))));
+        TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("drm: CDRMFB: plane {} has fd {}, got handle {}", i, attrs.fds.at(i), boHandles.at(i))));
     }
 
     id = submitBuffer();
     if (!id) {
-        backend->backend->log(AQ_LOG_ERROR, "drm: Failed to submit a buffer to KMS");
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Failed to submit a buffer to KMS");
         buffer->attachments.add(makeShared<CDRMBufferUnimportable>());
         drop();
         return;
     }
 
-    TRACE(backend->backend->log(AQ_LOG_TRACE, std::format("drm: new buffer {}", id)));
+    TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("drm: new buffer {}", id)));
 
     // FIXME: why does this implode when it doesnt on wlroots or kwin?
     closeHandles();
@@ -1836,7 +2021,7 @@ void Aquamarine::CDRMFB::closeHandles() {
             continue;
 
         if (drmCloseBufferHandle(backend->gpu->fd, boHandles.at(i)))
-            backend->backend->log(AQ_LOG_ERROR, "drm: drmCloseBufferHandle failed");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: drmCloseBufferHandle failed");
     }
 
     boHandles = {0, 0, 0, 0};
@@ -1853,14 +2038,14 @@ void Aquamarine::CDRMFB::drop() {
 
     closeHandles();
 
-    TRACE(backend->backend->log(AQ_LOG_TRACE, std::format("drm: dropping buffer {}", id)));
+    TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("drm: dropping buffer {}", id)));
 
     int ret = drmModeCloseFB(backend->gpu->fd, id);
     if (ret == -EINVAL)
         ret = drmModeRmFB(backend->gpu->fd, id);
 
     if (ret)
-        backend->backend->log(AQ_LOG_ERROR, std::format("drm: Failed to close a buffer: {}", strerror(-ret)));
+        AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm: Failed to close a buffer: {}", strerror(-ret)));
 }
 
 uint32_t Aquamarine::CDRMFB::submitBuffer() {
@@ -1872,17 +2057,17 @@ uint32_t Aquamarine::CDRMFB::submitBuffer() {
     }
 
     if (backend->drmProps.supportsAddFb2Modifiers && attrs.modifier != DRM_FORMAT_MOD_INVALID) {
-        TRACE(backend->backend->log(AQ_LOG_TRACE,
-                                    std::format("drm: Using drmModeAddFB2WithModifiers to import buffer into KMS: Size {} with format {} and mod {}", attrs.size,
-                                                fourccToName(attrs.format), attrs.modifier)));
+        TRACE(AQLOG(backend->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM,
+                    std::format("drm: Using drmModeAddFB2WithModifiers to import buffer into KMS: Size {} with format {} and mod {}", attrs.size,
+                                fourccToName(attrs.format), attrs.modifier)));
         if (drmModeAddFB2WithModifiers(backend->gpu->fd, attrs.size.x, attrs.size.y, attrs.format, boHandles.data(), attrs.strides.data(), attrs.offsets.data(), mods.data(),
                                        &newID, DRM_MODE_FB_MODIFIERS)) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: Failed to submit a buffer with drmModeAddFB2WithModifiers");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Failed to submit a buffer with drmModeAddFB2WithModifiers");
             return 0;
         }
     } else {
         if (attrs.modifier != DRM_FORMAT_MOD_INVALID && attrs.modifier != DRM_FORMAT_MOD_LINEAR) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: drmModeAddFB2WithModifiers unsupported and buffer has explicit modifiers");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: drmModeAddFB2WithModifiers unsupported and buffer has explicit modifiers");
             return 0;
         }
 
@@ -1891,7 +2076,7 @@ uint32_t Aquamarine::CDRMFB::submitBuffer() {
             std::format("drm: Using drmModeAddFB2 to import buffer into KMS: Size {} with format {} and mod {}", attrs.size, fourccToName(attrs.format), attrs.modifier)));
 
         if (drmModeAddFB2(backend->gpu->fd, attrs.size.x, attrs.size.y, attrs.format, boHandles.data(), attrs.strides.data(), attrs.offsets.data(), &newID, 0)) {
-            backend->backend->log(AQ_LOG_ERROR, "drm: Failed to submit a buffer with drmModeAddFB2");
+            AQLOG(backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: Failed to submit a buffer with drmModeAddFB2");
             return 0;
         }
     }
@@ -1907,7 +2092,7 @@ void Aquamarine::SDRMConnectorCommitData::calculateMode(Hyprutils::Memory::CShar
     const auto  MODE  = STATE.mode ? STATE.mode : STATE.customMode;
 
     if (!MODE) {
-        connector->backend->log(AQ_LOG_ERROR, "drm: no mode in calculateMode??");
+        AQLOG(connector->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm: no mode in calculateMode??");
         return;
     }
 
@@ -1941,10 +2126,10 @@ void Aquamarine::SDRMConnectorCommitData::calculateMode(Hyprutils::Memory::CShar
     };
     snprintf(modeInfo.name, sizeof(modeInfo.name), "%dx%d", (int)MODE->pixelSize.x, (int)MODE->pixelSize.y);
 
-    TRACE(connector->backend->log(AQ_LOG_TRACE,
-                                  std::format("drm: calculateMode: modeline dump: {} {} {} {} {} {} {} {} {} {} {}", modeInfo.clock, modeInfo.hdisplay, modeInfo.hsync_start,
-                                              modeInfo.hsync_end, modeInfo.htotal, modeInfo.vdisplay, modeInfo.vsync_start, modeInfo.vsync_end, modeInfo.vtotal, modeInfo.vrefresh,
-                                              modeInfo.flags)));
+    TRACE(AQLOG(connector->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM,
+                std::format("drm: calculateMode: modeline dump: {} {} {} {} {} {} {} {} {} {} {}", modeInfo.clock, modeInfo.hdisplay, modeInfo.hsync_start,
+                            modeInfo.hsync_end, modeInfo.htotal, modeInfo.vdisplay, modeInfo.vsync_start, modeInfo.vsync_end, modeInfo.vtotal, modeInfo.vrefresh,
+                            modeInfo.flags)));
 }
 
 Aquamarine::CDRMBufferAttachment::CDRMBufferAttachment(SP<CDRMFB> fb_) : fb(fb_) {
@@ -1962,7 +2147,7 @@ SP<CDRMLease> Aquamarine::CDRMLease::create(std::vector<SP<IOutput>> outputs) {
 
     for (auto& o : outputs) {
         if (o->getBackend() != backend) {
-            backend->log(AQ_LOG_ERROR, "drm lease: Mismatched backends");
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm lease: Mismatched backends");
             return nullptr;
         }
     }
@@ -1973,15 +2158,15 @@ SP<CDRMLease> Aquamarine::CDRMLease::create(std::vector<SP<IOutput>> outputs) {
 
     for (auto& o : outputs) {
         auto drmo = ((CDRMOutput*)o.get())->self.lock();
-        backend->log(AQ_LOG_DEBUG, std::format("drm lease: output {}, connector {}", drmo->name, drmo->connector->id));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm lease: output {}, connector {}", drmo->name, drmo->connector->id));
 
         // FIXME: do we have to alloc a crtc here?
         if (!drmo->connector->crtc) {
-            backend->log(AQ_LOG_ERROR, std::format("drm lease: output {} has no crtc", drmo->name));
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("drm lease: output {} has no crtc", drmo->name));
             return nullptr;
         }
 
-        backend->log(AQ_LOG_DEBUG, std::format("drm lease: crtc {}, primary {}", drmo->connector->crtc->id, drmo->connector->crtc->primary->id));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm lease: crtc {}, primary {}", drmo->connector->crtc->id, drmo->connector->crtc->primary->id));
 
         objects.push_back(drmo->connector->id);
         objects.push_back(drmo->connector->crtc->id);
@@ -1992,11 +2177,11 @@ SP<CDRMLease> Aquamarine::CDRMLease::create(std::vector<SP<IOutput>> outputs) {
         lease->outputs.emplace_back(drmo);
     }
 
-    backend->log(AQ_LOG_DEBUG, "drm lease: issuing a lease");
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "drm lease: issuing a lease");
 
     int leaseFD = drmModeCreateLease(backend->gpu->fd, objects.data(), objects.size(), O_CLOEXEC, &lease->lesseeID);
     if (leaseFD < 0) {
-        backend->log(AQ_LOG_ERROR, "drm lease: drm rejected a lease");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm lease: drm rejected a lease");
         return nullptr;
     }
 
@@ -2006,7 +2191,7 @@ SP<CDRMLease> Aquamarine::CDRMLease::create(std::vector<SP<IOutput>> outputs) {
 
     lease->leaseFD = leaseFD;
 
-    backend->log(AQ_LOG_DEBUG, std::format("drm lease: lease granted with lessee id {}", lease->lesseeID));
+    AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("drm lease: lease granted with lessee id {}", lease->lesseeID));
 
     return lease;
 }
@@ -2022,7 +2207,7 @@ void Aquamarine::CDRMLease::terminate() {
     active = false;
 
     if (drmModeRevokeLease(backend->gpu->fd, lesseeID) < 0)
-        backend->log(AQ_LOG_ERROR, "drm lease: Failed to revoke lease");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "drm lease: Failed to revoke lease");
 
     destroy();
 }
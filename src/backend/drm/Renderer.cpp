@@ -100,7 +100,7 @@ void main() {
 inline void loadGLProc(void* pProc, const char* name) {
     void* proc = (void*)eglGetProcAddress(name);
     if (proc == NULL) {
-        gBackend->log(AQ_LOG_ERROR, std::format("eglGetProcAddress({}) failed", name));
+        AQLOG(gBackend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, std::format("eglGetProcAddress({}) failed", name));
         abort();
     }
     *(void**)pProc = proc;
@@ -113,7 +113,7 @@ std::optional<std::vector<std::pair<uint64_t, bool>>> CDRMRenderer::getModsForFo
 
     EGLint len = 0;
     if (!egl.eglQueryDmaBufModifiersEXT(egl.display, format, 0, nullptr, nullptr, &len)) {
-        backend->log(AQ_LOG_ERROR, std::format("EGL: eglQueryDmaBufModifiersEXT failed for format {}", fourccToName(format)));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, std::format("EGL: eglQueryDmaBufModifiersEXT failed for format {}", fourccToName(format)));
         return std::nullopt;
     }
 
@@ -148,11 +148,11 @@ bool CDRMRenderer::initDRMFormats() {
     egl.eglQueryDmaBufFormatsEXT(egl.display, len, formats.data(), &len);
 
     if (formats.size() == 0) {
-        backend->log(AQ_LOG_ERROR, "EGL: Failed to get formats");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "EGL: Failed to get formats");
         return false;
     }
 
-    TRACE(backend->log(AQ_LOG_TRACE, "EGL: Supported formats:"));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL: Supported formats:"));
 
     std::vector<SGLFormat> dmaFormats;
 
@@ -178,18 +178,19 @@ bool CDRMRenderer::initDRMFormats() {
             });
         }
 
-        TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL: GPU Supports Format {} (0x{:x})", fourccToName((uint32_t)fmt), fmt)));
+        TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, std::format("EGL: GPU Supports Format {} (0x{:x})", fourccToName((uint32_t)fmt), fmt)));
         for (auto& [mod, external] : mods) {
             auto modName = drmGetFormatModifierName(mod);
-            TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL:  | {}with modifier 0x{:x}: {}", (external ? "external only " : ""), mod, modName ? modName : "?unknown?")));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER,
+                        std::format("EGL:  | {}with modifier 0x{:x}: {}", (external ? "external only " : ""), mod, modName ? modName : "?unknown?")));
             free(modName);
         }
     }
 
-    TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL: Found {} formats", dmaFormats.size())));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, std::format("EGL: Found {} formats", dmaFormats.size())));
 
     if (dmaFormats.empty()) {
-        backend->log(AQ_LOG_ERROR, "EGL: No formats");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "EGL: No formats");
         return false;
     }
 
@@ -206,14 +207,14 @@ SP<CDRMRenderer> CDRMRenderer::attempt(Hyprutils::Memory::CSharedPointer<CGBMAll
     const std::string EGLEXTENSIONS = (const char*)eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
 
     if (!EGLEXTENSIONS.contains("KHR_platform_gbm")) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, no gbm support");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, no gbm support");
         return nullptr;
     }
 
     // init egl
 
     if (eglBindAPI(EGL_OPENGL_ES_API) == EGL_FALSE) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, eglBindAPI failed");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, eglBindAPI failed");
         return nullptr;
     }
 
@@ -230,45 +231,45 @@ SP<CDRMRenderer> CDRMRenderer::attempt(Hyprutils::Memory::CSharedPointer<CGBMAll
     loadGLProc(&renderer->egl.eglDupNativeFenceFDANDROID, "eglDupNativeFenceFDANDROID");
 
     if (!renderer->egl.eglCreateSyncKHR) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, no eglCreateSyncKHR");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, no eglCreateSyncKHR");
         return nullptr;
     }
 
     if (!renderer->egl.eglDupNativeFenceFDANDROID) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, no eglDupNativeFenceFDANDROID");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, no eglDupNativeFenceFDANDROID");
         return nullptr;
     }
 
     if (!renderer->egl.eglGetPlatformDisplayEXT) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, no eglGetPlatformDisplayEXT");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, no eglGetPlatformDisplayEXT");
         return nullptr;
     }
 
     if (!renderer->egl.eglCreateImageKHR) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, no eglCreateImageKHR");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, no eglCreateImageKHR");
         return nullptr;
     }
 
     if (!renderer->egl.eglQueryDmaBufFormatsEXT) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, no eglQueryDmaBufFormatsEXT");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, no eglQueryDmaBufFormatsEXT");
         return nullptr;
     }
 
     if (!renderer->egl.eglQueryDmaBufModifiersEXT) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, no eglQueryDmaBufModifiersEXT");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, no eglQueryDmaBufModifiersEXT");
         return nullptr;
     }
 
     std::vector<EGLint> attrs = {EGL_NONE};
     renderer->egl.display     = renderer->egl.eglGetPlatformDisplayEXT(EGL_PLATFORM_GBM_KHR, allocator_->gbmDevice, attrs.data());
     if (renderer->egl.display == EGL_NO_DISPLAY) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, eglGetPlatformDisplayEXT failed");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, eglGetPlatformDisplayEXT failed");
         return nullptr;
     }
 
     EGLint major, minor;
     if (eglInitialize(renderer->egl.display, &major, &minor) == EGL_FALSE) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, eglInitialize failed");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, eglInitialize failed");
         return nullptr;
     }
 
@@ -287,12 +288,12 @@ SP<CDRMRenderer> CDRMRenderer::attempt(Hyprutils::Memory::CSharedPointer<CGBMAll
     }
 
     if (!EGLEXTENSIONS2.contains("EXT_image_dma_buf_import_modifiers")) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, no EXT_image_dma_buf_import_modifiers ext");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, no EXT_image_dma_buf_import_modifiers ext");
         return nullptr;
     }
 
     if (!EGLEXTENSIONS2.contains("EXT_image_dma_buf_import")) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, no EXT_image_dma_buf_import ext");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, no EXT_image_dma_buf_import ext");
         return nullptr;
     }
 
@@ -307,7 +308,7 @@ SP<CDRMRenderer> CDRMRenderer::attempt(Hyprutils::Memory::CSharedPointer<CGBMAll
 
     renderer->egl.context = eglCreateContext(renderer->egl.display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attrs.data());
     if (renderer->egl.context == EGL_NO_CONTEXT) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, eglCreateContext failed");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, eglCreateContext failed");
         return nullptr;
     }
 
@@ -315,9 +316,9 @@ SP<CDRMRenderer> CDRMRenderer::attempt(Hyprutils::Memory::CSharedPointer<CGBMAll
         EGLint priority = EGL_CONTEXT_PRIORITY_MEDIUM_IMG;
         eglQueryContext(renderer->egl.display, renderer->egl.context, EGL_CONTEXT_PRIORITY_LEVEL_IMG, &priority);
         if (priority != EGL_CONTEXT_PRIORITY_HIGH_IMG)
-            backend_->log(AQ_LOG_DEBUG, "CDRMRenderer: didnt get a high priority context");
+            AQLOG(backend_, AQ_LOG_DEBUG, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: didnt get a high priority context");
         else
-            backend_->log(AQ_LOG_DEBUG, "CDRMRenderer: got a high priority context");
+            AQLOG(backend_, AQ_LOG_DEBUG, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: got a high priority context");
     }
 
     // init shaders
@@ -325,13 +326,13 @@ SP<CDRMRenderer> CDRMRenderer::attempt(Hyprutils::Memory::CSharedPointer<CGBMAll
     renderer->setEGL();
 
     if (!renderer->initDRMFormats()) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, initDRMFormats failed");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, initDRMFormats failed");
         return nullptr;
     }
 
     renderer->gl.shader.program = createProgram(VERT_SRC, FRAG_SRC);
     if (renderer->gl.shader.program == 0) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, shader failed");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, shader failed");
         return nullptr;
     }
 
@@ -342,7 +343,7 @@ SP<CDRMRenderer> CDRMRenderer::attempt(Hyprutils::Memory::CSharedPointer<CGBMAll
 
     renderer->gl.shaderExt.program = createProgram(VERT_SRC, FRAG_SRC_EXT);
     if (renderer->gl.shaderExt.program == 0) {
-        backend_->log(AQ_LOG_ERROR, "CDRMRenderer: fail, shaderExt failed");
+        AQLOG(backend_, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: fail, shaderExt failed");
         return nullptr;
     }
 
@@ -353,7 +354,7 @@ SP<CDRMRenderer> CDRMRenderer::attempt(Hyprutils::Memory::CSharedPointer<CGBMAll
 
     renderer->restoreEGL();
 
-    backend_->log(AQ_LOG_DEBUG, "CDRMRenderer: success");
+    AQLOG(backend_, AQ_LOG_DEBUG, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: success");
 
     return renderer;
 }
@@ -365,7 +366,7 @@ void CDRMRenderer::setEGL() {
     savedEGLState.read    = eglGetCurrentSurface(EGL_READ);
 
     if (!eglMakeCurrent(egl.display, EGL_NO_SURFACE, EGL_NO_SURFACE, egl.context))
-        backend->log(AQ_LOG_WARNING, "CDRMRenderer: setEGL eglMakeCurrent failed");
+        AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: setEGL eglMakeCurrent failed");
 }
 
 void CDRMRenderer::restoreEGL() {
@@ -376,7 +377,7 @@ void CDRMRenderer::restoreEGL() {
         return;
 
     if (!eglMakeCurrent(dpy, savedEGLState.draw, savedEGLState.read, savedEGLState.context))
-        backend->log(AQ_LOG_WARNING, "CDRMRenderer: restoreEGL eglMakeCurrent failed");
+        AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_RENDERER, "CDRMRenderer: restoreEGL eglMakeCurrent failed");
 }
 
 EGLImageKHR CDRMRenderer::createEGLImage(const SDMABUFAttrs& attrs) {
@@ -389,7 +390,8 @@ EGLImageKHR CDRMRenderer::createEGLImage(const SDMABUFAttrs& attrs) {
     attribs.push_back(EGL_LINUX_DRM_FOURCC_EXT);
     attribs.push_back(attrs.format);
 
-    TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL: createEGLImage: size {} with format {} and modifier 0x{:x}", attrs.size, fourccToName(attrs.format), attrs.modifier)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER,
+                std::format("EGL: createEGLImage: size {} with format {} and modifier 0x{:x}", attrs.size, fourccToName(attrs.format), attrs.modifier)));
 
     struct {
         EGLint fd;
@@ -425,7 +427,7 @@ EGLImageKHR CDRMRenderer::createEGLImage(const SDMABUFAttrs& attrs) {
 
     EGLImageKHR image = egl.eglCreateImageKHR(egl.display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, (int*)attribs.data());
     if (image == EGL_NO_IMAGE_KHR) {
-        backend->log(AQ_LOG_ERROR, std::format("EGL: EGLCreateImageKHR failed: {}", eglGetError()));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, std::format("EGL: EGLCreateImageKHR failed: {}", eglGetError()));
         return EGL_NO_IMAGE_KHR;
     }
 
@@ -437,9 +439,9 @@ EGLImageKHR CDRMRenderer::createEGLImage(const SDMABUFAttrs& attrs) {
         __CALL__;                                                                                                                                                                  \
         auto err = glGetError();                                                                                                                                                   \
         if (err != GL_NO_ERROR) {                                                                                                                                                  \
-            backend->log(AQ_LOG_ERROR,                                                                                                                                             \
-                         std::format("[GLES] Error in call at {}@{}: 0x{:x}", __LINE__,                                                                                            \
-                                     ([]() constexpr -> std::string { return std::string(__FILE__).substr(std::string(__FILE__).find_last_of('/') + 1); })(), err));               \
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER,                                                                                                                    \
+                  std::format("[GLES] Error in call at {}@{}: 0x{:x}", __LINE__,                                                                                                   \
+                              ([]() constexpr -> std::string { return std::string(__FILE__).substr(std::string(__FILE__).find_last_of('/') + 1); })(), err));                      \
         }                                                                                                                                                                          \
     }
 
@@ -450,7 +452,7 @@ SGLTex CDRMRenderer::glTex(Hyprutils::Memory::CSharedPointer<IBuffer> buffa) {
 
     tex.image = createEGLImage(dma);
     if (tex.image == EGL_NO_IMAGE_KHR) {
-        backend->log(AQ_LOG_ERROR, std::format("EGL (glTex): createEGLImage failed: {}", eglGetError()));
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, std::format("EGL (glTex): createEGLImage failed: {}", eglGetError()));
         return tex;
     }
 
@@ -459,7 +461,7 @@ SGLTex CDRMRenderer::glTex(Hyprutils::Memory::CSharedPointer<IBuffer> buffa) {
         if (fmt.drmFormat != dma.format || fmt.modifier != dma.modifier)
             continue;
 
-        backend->log(AQ_LOG_DEBUG, std::format("CDRMRenderer::glTex: found format+mod, external = {}", fmt.external));
+        AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_RENDERER, std::format("CDRMRenderer::glTex: found format+mod, external = {}", fmt.external));
         external = fmt.external;
         break;
     }
@@ -485,12 +487,12 @@ inline const float fullVerts[] = {
 };
 
 void CDRMRenderer::waitOnSync(int fd) {
-    TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL (waitOnSync): attempting to wait on fd {}", fd)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, std::format("EGL (waitOnSync): attempting to wait on fd {}", fd)));
 
     std::vector<EGLint> attribs;
     int                 dupFd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
     if (dupFd < 0) {
-        backend->log(AQ_LOG_TRACE, "EGL (waitOnSync): failed to dup fd for wait");
+        AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (waitOnSync): failed to dup fd for wait");
         return;
     }
 
@@ -500,7 +502,7 @@ void CDRMRenderer::waitOnSync(int fd) {
 
     EGLSyncKHR sync = egl.eglCreateSyncKHR(egl.display, EGL_SYNC_NATIVE_FENCE_ANDROID, attribs.data());
     if (sync == EGL_NO_SYNC_KHR) {
-        TRACE(backend->log(AQ_LOG_TRACE, "EGL (waitOnSync): failed to create an egl sync for explicit"));
+        TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (waitOnSync): failed to create an egl sync for explicit"));
         if (dupFd >= 0)
             close(dupFd);
         return;
@@ -509,25 +511,25 @@ void CDRMRenderer::waitOnSync(int fd) {
     // we got a sync, now we just tell egl to wait before sampling
     if (egl.eglWaitSyncKHR(egl.display, sync, 0) != EGL_TRUE) {
         if (egl.eglDestroySyncKHR(egl.display, sync) != EGL_TRUE)
-            TRACE(backend->log(AQ_LOG_TRACE, "EGL (waitOnSync): failed to destroy sync"));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (waitOnSync): failed to destroy sync"));
 
-        TRACE(backend->log(AQ_LOG_TRACE, "EGL (waitOnSync): failed to wait on the sync object"));
+        TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (waitOnSync): failed to wait on the sync object"));
         return;
     }
 
     if (egl.eglDestroySyncKHR(egl.display, sync) != EGL_TRUE)
-        TRACE(backend->log(AQ_LOG_TRACE, "EGL (waitOnSync): failed to destroy sync"));
+        TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (waitOnSync): failed to destroy sync"));
 }
 
 int CDRMRenderer::recreateBlitSync() {
-    TRACE(backend->log(AQ_LOG_TRACE, "EGL (recreateBlitSync): recreating blit sync"));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (recreateBlitSync): recreating blit sync"));
 
     if (egl.lastBlitSync) {
-        TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL (recreateBlitSync): cleaning up old sync (fd {})", egl.lastBlitSyncFD)));
+        TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, std::format("EGL (recreateBlitSync): cleaning up old sync (fd {})", egl.lastBlitSyncFD)));
 
         // cleanup last sync
         if (egl.eglDestroySyncKHR(egl.display, egl.lastBlitSync) != EGL_TRUE)
-            TRACE(backend->log(AQ_LOG_TRACE, "EGL (recreateBlitSync): failed to destroy old sync"));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (recreateBlitSync): failed to destroy old sync"));
 
         if (egl.lastBlitSyncFD >= 0)
             close(egl.lastBlitSyncFD);
@@ -538,7 +540,7 @@ int CDRMRenderer::recreateBlitSync() {
 
     EGLSyncKHR sync = egl.eglCreateSyncKHR(egl.display, EGL_SYNC_NATIVE_FENCE_ANDROID, nullptr);
     if (sync == EGL_NO_SYNC_KHR) {
-        TRACE(backend->log(AQ_LOG_TRACE, "EGL (recreateBlitSync): failed to create an egl sync for explicit"));
+        TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (recreateBlitSync): failed to create an egl sync for explicit"));
         return -1;
     }
 
@@ -547,16 +549,16 @@ int CDRMRenderer::recreateBlitSync() {
 
     int fd = egl.eglDupNativeFenceFDANDROID(egl.display, sync);
     if (fd == EGL_NO_NATIVE_FENCE_FD_ANDROID) {
-        TRACE(backend->log(AQ_LOG_TRACE, "EGL (recreateBlitSync): failed to dup egl fence fd"));
+        TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (recreateBlitSync): failed to dup egl fence fd"));
         if (egl.eglDestroySyncKHR(egl.display, sync) != EGL_TRUE)
-            TRACE(backend->log(AQ_LOG_TRACE, "EGL (recreateBlitSync): failed to destroy new sync"));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (recreateBlitSync): failed to destroy new sync"));
         return -1;
     }
 
     egl.lastBlitSync   = sync;
     egl.lastBlitSyncFD = fd;
 
-    TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL (recreateBlitSync): success, new fence exported with fd {}", fd)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, std::format("EGL (recreateBlitSync): success, new fence exported with fd {}", fd)));
 
     return fd;
 }
@@ -565,7 +567,7 @@ CDRMRenderer::SBlitResult CDRMRenderer::blit(SP<IBuffer> from, SP<IBuffer> to, i
     setEGL();
 
     if (from->dmabuf().size != to->dmabuf().size) {
-        backend->log(AQ_LOG_ERROR, "EGL (blit): buffer sizes mismatched");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "EGL (blit): buffer sizes mismatched");
         return {};
     }
 
@@ -583,13 +585,13 @@ CDRMRenderer::SBlitResult CDRMRenderer::blit(SP<IBuffer> from, SP<IBuffer> to, i
     {
         auto attachment = from->attachments.get(AQ_ATTACHMENT_DRM_RENDERER_DATA);
         if (attachment) {
-            TRACE(backend->log(AQ_LOG_TRACE, "EGL (blit): From attachment found"));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (blit): From attachment found"));
             auto att = (CDRMRendererBufferAttachment*)attachment.get();
             fromTex  = att->tex;
         }
 
         if (!fromTex.image) {
-            backend->log(AQ_LOG_DEBUG, "EGL (blit): No attachment in from, creating a new image");
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_RENDERER, "EGL (blit): No attachment in from, creating a new image");
             fromTex = glTex(from);
 
             // should never remove anything, but JIC. We'll leak an EGLImage if this removes anything.
@@ -598,9 +600,9 @@ CDRMRenderer::SBlitResult CDRMRenderer::blit(SP<IBuffer> from, SP<IBuffer> to, i
         }
     }
 
-    TRACE(backend->log(AQ_LOG_TRACE,
-                       std::format("EGL (blit): fromTex id {}, image 0x{:x}, target {}", fromTex.texid, (uintptr_t)fromTex.image,
-                                   fromTex.target == GL_TEXTURE_2D ? "GL_TEXTURE_2D" : "GL_TEXTURE_EXTERNAL_OES")));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER,
+                std::format("EGL (blit): fromTex id {}, image 0x{:x}, target {}", fromTex.texid, (uintptr_t)fromTex.image,
+                            fromTex.target == GL_TEXTURE_2D ? "GL_TEXTURE_2D" : "GL_TEXTURE_EXTERNAL_OES")));
 
     // then, get a rbo from our to buffer
     // if it has an attachment, use that
@@ -610,14 +612,14 @@ CDRMRenderer::SBlitResult CDRMRenderer::blit(SP<IBuffer> from, SP<IBuffer> to, i
     auto        toDma = to->dmabuf();
 
     if (!verifyDestinationDMABUF(toDma)) {
-        backend->log(AQ_LOG_ERROR, "EGL (blit): failed to blit: destination dmabuf unsupported");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "EGL (blit): failed to blit: destination dmabuf unsupported");
         return {};
     }
 
     {
         auto attachment = to->attachments.get(AQ_ATTACHMENT_DRM_RENDERER_DATA);
         if (attachment) {
-            TRACE(backend->log(AQ_LOG_TRACE, "EGL (blit): To attachment found"));
+            TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, "EGL (blit): To attachment found"));
             auto att = (CDRMRendererBufferAttachment*)attachment.get();
             rboImage = att->eglImage;
             fboID    = att->fbo;
@@ -625,11 +627,11 @@ CDRMRenderer::SBlitResult CDRMRenderer::blit(SP<IBuffer> from, SP<IBuffer> to, i
         }
 
         if (!rboImage) {
-            backend->log(AQ_LOG_DEBUG, "EGL (blit): No attachment in to, creating a new image");
+            AQLOG(backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_RENDERER, "EGL (blit): No attachment in to, creating a new image");
 
             rboImage = createEGLImage(toDma);
             if (rboImage == EGL_NO_IMAGE_KHR) {
-                backend->log(AQ_LOG_ERROR, std::format("EGL (blit): createEGLImage failed: {}", eglGetError()));
+                AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, std::format("EGL (blit): createEGLImage failed: {}", eglGetError()));
                 return {};
             }
 
@@ -643,7 +645,7 @@ CDRMRenderer::SBlitResult CDRMRenderer::blit(SP<IBuffer> from, SP<IBuffer> to, i
             GLCALL(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rboID));
 
             if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-                backend->log(AQ_LOG_ERROR, std::format("EGL (blit): glCheckFramebufferStatus failed: {}", glGetError()));
+                AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, std::format("EGL (blit): glCheckFramebufferStatus failed: {}", glGetError()));
                 return {};
             }
 
@@ -655,12 +657,12 @@ CDRMRenderer::SBlitResult CDRMRenderer::blit(SP<IBuffer> from, SP<IBuffer> to, i
 
     glFlush();
 
-    TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL (blit): rboImage 0x{:x}", (uintptr_t)rboImage)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, std::format("EGL (blit): rboImage 0x{:x}", (uintptr_t)rboImage)));
 
     GLCALL(glBindRenderbuffer(GL_RENDERBUFFER, rboID));
     GLCALL(glBindFramebuffer(GL_FRAMEBUFFER, fboID));
 
-    TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL (blit): fbo {} rbo {}", fboID, rboID)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, std::format("EGL (blit): fbo {} rbo {}", fboID, rboID)));
 
     glClearColor(0.77F, 0.F, 0.74F, 1.F);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -668,7 +670,7 @@ CDRMRenderer::SBlitResult CDRMRenderer::blit(SP<IBuffer> from, SP<IBuffer> to, i
     // done, let's render the texture to the rbo
     CBox renderBox = {{}, toDma.size};
 
-    TRACE(backend->log(AQ_LOG_TRACE, std::format("EGL (blit): box size {}", renderBox.size())));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER, std::format("EGL (blit): box size {}", renderBox.size())));
 
     float mtx[9];
     float base[9];
@@ -738,8 +740,8 @@ CDRMRenderer::SBlitResult CDRMRenderer::blit(SP<IBuffer> from, SP<IBuffer> to, i
 void CDRMRenderer::onBufferAttachmentDrop(CDRMRendererBufferAttachment* attachment) {
     setEGL();
 
-    TRACE(backend->log(AQ_LOG_TRACE,
-                       std::format("EGL (onBufferAttachmentDrop): dropping fbo {} rbo {} image 0x{:x}", attachment->fbo, attachment->rbo, (uintptr_t)attachment->eglImage)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_RENDERER,
+                std::format("EGL (onBufferAttachmentDrop): dropping fbo {} rbo {} image 0x{:x}", attachment->fbo, attachment->rbo, (uintptr_t)attachment->eglImage)));
 
     if (attachment->tex.texid)
         GLCALL(glDeleteTextures(1, &attachment->tex.texid));
@@ -764,14 +766,14 @@ bool CDRMRenderer::verifyDestinationDMABUF(const SDMABUFAttrs& attrs) {
             continue;
 
         if (fmt.external) {
-            backend->log(AQ_LOG_ERROR, "EGL (verifyDestinationDMABUF): FAIL, format is external-only");
+            AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "EGL (verifyDestinationDMABUF): FAIL, format is external-only");
             return false;
         }
 
         return true;
     }
 
-    backend->log(AQ_LOG_ERROR, "EGL (verifyDestinationDMABUF): FAIL, format is unsupported by EGL");
+    AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_RENDERER, "EGL (verifyDestinationDMABUF): FAIL, format is unsupported by EGL");
     return false;
 }
 
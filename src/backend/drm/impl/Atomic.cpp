@@ -26,15 +26,15 @@ void Aquamarine::CDRMAtomicRequest::add(uint32_t id, uint32_t prop, uint64_t val
     if (failed)
         return;
 
-    TRACE(backend->log(AQ_LOG_TRACE, std::format("atomic drm request: adding id {} prop {} with value {}", id, prop, val)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("atomic drm request: adding id {} prop {} with value {}", id, prop, val)));
 
     if (id == 0 || prop == 0) {
-        backend->log(AQ_LOG_ERROR, "atomic drm request: failed to add prop: id / prop == 0");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "atomic drm request: failed to add prop: id / prop == 0");
         return;
     }
 
     if (drmModeAtomicAddProperty(req, id, prop, val) < 0) {
-        backend->log(AQ_LOG_ERROR, "atomic drm request: failed to add prop");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "atomic drm request: failed to add prop");
         failed = true;
     }
 }
@@ -47,7 +47,7 @@ void Aquamarine::CDRMAtomicRequest::planeProps(Hyprutils::Memory::CSharedPointer
 
     if (!fb || !crtc) {
         // Disable the plane
-        TRACE(backend->log(AQ_LOG_TRACE, std::format("atomic planeProps: disabling plane {}", plane->id)));
+        TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("atomic planeProps: disabling plane {}", plane->id)));
         add(plane->id, plane->props.fb_id, 0);
         add(plane->id, plane->props.crtc_id, 0);
         add(plane->id, plane->props.crtc_x, (uint64_t)pos.x);
@@ -55,10 +55,10 @@ void Aquamarine::CDRMAtomicRequest::planeProps(Hyprutils::Memory::CSharedPointer
         return;
     }
 
-    TRACE(backend->log(AQ_LOG_TRACE,
-                       std::format("atomic planeProps: prop blobs: src_x {}, src_y {}, src_w {}, src_h {}, crtc_w {}, crtc_h {}, fb_id {}, crtc_id {}, crtc_x {}, crtc_y {}",
-                                   plane->props.src_x, plane->props.src_y, plane->props.src_w, plane->props.src_h, plane->props.crtc_w, plane->props.crtc_h, plane->props.fb_id,
-                                   plane->props.crtc_id, plane->props.crtc_x, plane->props.crtc_y)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM,
+                std::format("atomic planeProps: prop blobs: src_x {}, src_y {}, src_w {}, src_h {}, crtc_w {}, crtc_h {}, fb_id {}, crtc_id {}, crtc_x {}, crtc_y {}",
+                            plane->props.src_x, plane->props.src_y, plane->props.src_w, plane->props.src_h, plane->props.crtc_w, plane->props.crtc_h, plane->props.fb_id,
+                            plane->props.crtc_id, plane->props.crtc_x, plane->props.crtc_y)));
 
     // src_ are 16.16 fixed point (lol)
     add(plane->id, plane->props.src_x, 0);
@@ -77,11 +77,11 @@ void Aquamarine::CDRMAtomicRequest::addConnector(Hyprutils::Memory::CSharedPoint
     const auto& STATE  = connector->output->state->state();
     const bool  enable = STATE.enabled && data.mainFB;
 
-    TRACE(backend->log(AQ_LOG_TRACE,
-                       std::format("atomic addConnector blobs: mode_id {}, active {}, crtc_id {}, link_status {}, content_type {}", connector->crtc->props.mode_id,
-                                   connector->crtc->props.active, connector->props.crtc_id, connector->props.link_status, connector->props.content_type)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM,
+                std::format("atomic addConnector blobs: mode_id {}, active {}, crtc_id {}, link_status {}, content_type {}", connector->crtc->props.mode_id,
+                            connector->crtc->props.active, connector->props.crtc_id, connector->props.link_status, connector->props.content_type)));
 
-    TRACE(backend->log(AQ_LOG_TRACE, std::format("atomic addConnector values: CRTC {}, mode {}", enable ? connector->crtc->id : 0, data.atomic.modeBlob)));
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("atomic addConnector values: CRTC {}, mode {}", enable ? connector->crtc->id : 0, data.atomic.modeBlob)));
 
     add(connector->id, connector->props.crtc_id, enable ? connector->crtc->id : 0);
 
@@ -136,44 +136,48 @@ void Aquamarine::CDRMAtomicRequest::addConnector(Hyprutils::Memory::CSharedPoint
     conn = connector;
 }
 
-bool Aquamarine::CDRMAtomicRequest::commit(uint32_t flagssss) {
-    static auto flagsToStr = [](uint32_t flags) {
-        std::string result;
-        if (flags & DRM_MODE_ATOMIC_ALLOW_MODESET)
-            result += "ATOMIC_ALLOW_MODESET ";
-        if (flags & DRM_MODE_ATOMIC_NONBLOCK)
-            result += "ATOMIC_NONBLOCK ";
-        if (flags & DRM_MODE_ATOMIC_TEST_ONLY)
-            result += "ATOMIC_TEST_ONLY ";
-        if (flags & DRM_MODE_PAGE_FLIP_EVENT)
-            result += "PAGE_FLIP_EVENT ";
-        if (flags & DRM_MODE_PAGE_FLIP_ASYNC)
-            result += "PAGE_FLIP_ASYNC ";
-        if (flags & (~DRM_MODE_ATOMIC_FLAGS))
-            result += " + invalid...";
-        return result;
-    };
+static std::string flagsToStr(uint32_t flags) {
+    std::string result;
+    if (flags & DRM_MODE_ATOMIC_ALLOW_MODESET)
+        result += "ATOMIC_ALLOW_MODESET ";
+    if (flags & DRM_MODE_ATOMIC_NONBLOCK)
+        result += "ATOMIC_NONBLOCK ";
+    if (flags & DRM_MODE_ATOMIC_TEST_ONLY)
+        result += "ATOMIC_TEST_ONLY ";
+    if (flags & DRM_MODE_PAGE_FLIP_EVENT)
+        result += "PAGE_FLIP_EVENT ";
+    if (flags & DRM_MODE_PAGE_FLIP_ASYNC)
+        result += "PAGE_FLIP_ASYNC ";
+    if (flags & (~DRM_MODE_ATOMIC_FLAGS))
+        result += " + invalid...";
+    return result;
+}
 
+bool Aquamarine::CDRMAtomicRequest::commit(uint32_t flagssss) {
     if (failed) {
         backend->log((flagssss & DRM_MODE_ATOMIC_TEST_ONLY) ? AQ_LOG_DEBUG : AQ_LOG_ERROR, std::format("atomic drm request: failed to commit, failed flag set to true"));
         return false;
     }
 
     if (auto ret = drmModeAtomicCommit(backend->gpu->fd, req, flagssss, &conn->pendingPageFlip); ret) {
-        backend->log((flagssss & DRM_MODE_ATOMIC_TEST_ONLY) ? AQ_LOG_DEBUG : AQ_LOG_ERROR,
-                     std::format("atomic drm request: failed to commit: {}, flags: {}", strerror(-ret), flagsToStr(flagssss)));
+        onCommitFailed(ret, flagssss);
         return false;
     }
 
     return true;
 }
 
+void Aquamarine::CDRMAtomicRequest::onCommitFailed(int ret, uint32_t flagssss) {
+    backend->log((flagssss & DRM_MODE_ATOMIC_TEST_ONLY) ? AQ_LOG_DEBUG : AQ_LOG_ERROR,
+                 std::format("atomic drm request: failed to commit: {}, flags: {}", strerror(-ret), flagsToStr(flagssss)));
+}
+
 void Aquamarine::CDRMAtomicRequest::destroyBlob(uint32_t id) {
     if (!id)
         return;
 
     if (drmModeDestroyPropertyBlob(backend->gpu->fd, id))
-        backend->log(AQ_LOG_ERROR, "atomic drm request: failed to destroy a blob");
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "atomic drm request: failed to destroy a blob");
 }
 
 void Aquamarine::CDRMAtomicRequest::commitBlob(uint32_t* current, uint32_t next) {
@@ -227,19 +231,19 @@ bool Aquamarine::CDRMAtomicImpl::prepareConnector(Hyprutils::Memory::CSharedPoin
             data.atomic.modeBlob = 0;
         else {
             if (drmModeCreatePropertyBlob(connector->backend->gpu->fd, (drmModeModeInfo*)&data.modeInfo, sizeof(drmModeModeInfo), &data.atomic.modeBlob)) {
-                connector->backend->backend->log(AQ_LOG_ERROR, "atomic drm: failed to create a modeset blob");
+                AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "atomic drm: failed to create a modeset blob");
                 return false;
             }
 
-            TRACE(connector->backend->log(AQ_LOG_TRACE,
-                                          std::format("Connector blob id {}: clock {}, {}x{}, vrefresh {}, name: {}", data.atomic.modeBlob, data.modeInfo.clock,
-                                                      data.modeInfo.hdisplay, data.modeInfo.vdisplay, data.modeInfo.vrefresh, data.modeInfo.name)));
+            TRACE(AQLOG(connector->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM,
+                        std::format("Connector blob id {}: clock {}, {}x{}, vrefresh {}, name: {}", data.atomic.modeBlob, data.modeInfo.clock,
+                                    data.modeInfo.hdisplay, data.modeInfo.vdisplay, data.modeInfo.vrefresh, data.modeInfo.name)));
         }
     }
 
     if (STATE.committed & COutputState::AQ_OUTPUT_STATE_GAMMA_LUT) {
         if (!connector->crtc->props.gamma_lut) // TODO: allow this with legacy gamma, perhaps.
-            connector->backend->backend->log(AQ_LOG_ERROR, "atomic drm: failed to commit gamma: no gamma_lut prop");
+            AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "atomic drm: failed to commit gamma: no gamma_lut prop");
         else if (STATE.gammaLut.empty()) {
             data.atomic.gammaLut = 0;
             data.atomic.gammad   = true;
@@ -255,7 +259,7 @@ bool Aquamarine::CDRMAtomicImpl::prepareConnector(Hyprutils::Memory::CSharedPoin
             }
 
             if (drmModeCreatePropertyBlob(connector->backend->gpu->fd, lut.data(), lut.size() * sizeof(drm_color_lut), &data.atomic.gammaLut)) {
-                connector->backend->backend->log(AQ_LOG_ERROR, "atomic drm: failed to create a gamma blob");
+                AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "atomic drm: failed to create a gamma blob");
                 data.atomic.gammaLut = 0;
             } else
                 data.atomic.gammad = true;
@@ -268,7 +272,7 @@ bool Aquamarine::CDRMAtomicImpl::prepareConnector(Hyprutils::Memory::CSharedPoin
         else {
             std::vector<pixman_box32_t> rects = STATE.damage.getRects();
             if (drmModeCreatePropertyBlob(connector->backend->gpu->fd, rects.data(), sizeof(pixman_box32_t) * rects.size(), &data.atomic.fbDamage)) {
-                connector->backend->backend->log(AQ_LOG_ERROR, "atomic drm: failed to create a damage blob");
+                AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "atomic drm: failed to create a damage blob");
                 return false;
             }
         }
@@ -281,10 +285,6 @@ bool Aquamarine::CDRMAtomicImpl::commit(Hyprutils::Memory::CSharedPointer<SDRMCo
     if (!prepareConnector(connector, data))
         return false;
 
-    CDRMAtomicRequest request(backend);
-
-    request.addConnector(connector, data);
-
     uint32_t flags = data.flags;
     if (data.test)
         flags |= DRM_MODE_ATOMIC_TEST_ONLY;
@@ -293,18 +293,98 @@ bool Aquamarine::CDRMAtomicImpl::commit(Hyprutils::Memory::CSharedPointer<SDRMCo
     if (!data.blocking && !data.test)
         flags |= DRM_MODE_ATOMIC_NONBLOCK;
 
+    // the kernel writes the out fence into the state during the commit, keep those on this thread
+    const bool OUT_FENCE = connector->output->state->state().committed & COutputState::AQ_OUTPUT_STATE_EXPLICIT_OUT_FENCE;
+    if (data.blocking && !data.test && !OUT_FENCE && backend->commitThread)
+        return commitOnThread(connector, data, flags);
+
+    CDRMAtomicRequest request(backend);
+
+    request.addConnector(connector, data);
+
     const bool ok = request.commit(flags);
 
     if (ok) {
         request.apply(data);
-        if (!data.test && data.mainFB && connector->output->state->state().enabled && (flags & DRM_MODE_PAGE_FLIP_EVENT))
+        if (!data.test && data.mainFB && connector->output->state->state().enabled && (flags & DRM_MODE_PAGE_FLIP_EVENT)) {
             connector->isPageFlipPending = true;
+            if (data.modeset && (flags & DRM_MODE_ATOMIC_NONBLOCK))
+                connector->isModesetPending = true;
+        }
     } else
         request.rollback(data);
 
     return ok;
 }
 
+bool Aquamarine::CDRMAtomicImpl::commitOnThread(SP<SDRMConnector> connector, SDRMConnectorCommitData& data, uint32_t flags) {
+    auto request = makeShared<CDRMAtomicRequest>(backend);
+
+    request->addConnector(connector, data);
+
+    if (request->failed) {
+        request->commit(flags); // logs
+        request->rollback(data);
+        return false;
+    }
+
+    // this goes out optimistically, nothing may commit on this connector until it's done.
+    // The pf event can come before we hear back from the thread, so mark it pending now.
+    const bool FLIP_EVENT       = data.mainFB && connector->output->state->state().enabled && (flags & DRM_MODE_PAGE_FLIP_EVENT);
+    connector->isCommitInFlight = true;
+    if (FLIP_EVENT)
+        connector->isPageFlipPending = true;
+
+    TRACE(AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, std::format("atomic drm: queueing a blocking commit on the commit thread, flags: {}", flagsToStr(flags))));
+
+    const auto FD  = backend->gpu->fd;
+    const auto REQ = request->req;
+    const auto PF  = &connector->pendingPageFlip;
+
+    // the output moves its pending state to current once this is queued, a rejected commit has to undo that
+    const auto PREVIOUS           = connector->output->state->current();
+    const bool PREVIOUS_NO_BUFFER = connector->output->lastCommitNoBuffer;
+    const auto FAILED             = connector->output->state->state();
+
+    backend->commitThread->submit([FD, REQ, flags, PF]() { return drmModeAtomicCommit(FD, REQ, flags, PF); },
+                                  [request, connector, data, flags, FLIP_EVENT, PREVIOUS, PREVIOUS_NO_BUFFER, FAILED](int ret) mutable {
+                                      connector->isCommitInFlight = false;
+
+                                      if (!ret) {
+                                          request->apply(data);
+
+                                          // frames requested meanwhile were held back, and there won't be a pf event to send them
+                                          if (!FLIP_EVENT && connector->output && connector->output->needsFrame)
+                                              connector->output->scheduleFrame(IOutput::AQ_SCHEDULE_NEEDS_FRAME);
+                                          if (data.modeset && connector->output)
+                                              connector->output->events.modeset.emit();
+                                          return;
+                                      }
+
+                                      request->onCommitFailed(ret, flags);
+                                      request->rollback(data);
+
+                                      if (FLIP_EVENT)
+                                          connector->isPageFlipPending = false;
+
+                                      // undo what applyCommit already did with the main fb
+                                      if (data.mainFB && connector->crtc && connector->crtc->primary->back == data.mainFB) {
+                                          connector->crtc->primary->back       = connector->crtc->primary->front;
+                                          data.mainFB->buffer->lockedByBackend = false;
+                                          data.mainFB->buffer->events.backendRelease.emit();
+                                      }
+
+                                      // current() goes back to what the hardware has, the rejected enable / mode / format are pending again
+                                      if (connector->output) {
+                                          connector->output->restoreState(PREVIOUS, PREVIOUS_NO_BUFFER, FAILED);
+                                          connector->output->events.commitFailed.emit();
+                                          connector->output->events.needsFrame.emit();
+                                      }
+                                  });
+
+    return true;
+}
+
 bool Aquamarine::CDRMAtomicImpl::reset() {
     CDRMAtomicRequest request(backend);
 
@@ -329,7 +409,7 @@ bool Aquamarine::CDRMAtomicImpl::moveCursor(SP<SDRMConnector> connector, bool sk
         return true;
 
     if (!skipShedule) {
-        TRACE(connector->backend->log(AQ_LOG_TRACE, "atomic moveCursor"));
+        TRACE(AQLOG(connector->backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_DRM, "atomic moveCursor"));
         connector->output->scheduleFrame(IOutput::AQ_SCHEDULE_CURSOR_MOVE);
     }
 
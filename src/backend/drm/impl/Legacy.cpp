@@ -4,6 +4,7 @@
 #include <xf86drm.h>
 #include <xf86drmMode.h>
 #include <sys/mman.h>
+#include "Shared.hpp"
 
 using namespace Aquamarine;
 using namespace Hyprutils::Memory;
@@ -31,17 +32,17 @@ bool Aquamarine::CDRMLegacyImpl::commitInternal(Hyprutils::Memory::CSharedPointe
 
     if (enable) {
         if (!data.mainFB)
-            connector->backend->backend->log(AQ_LOG_WARNING, "legacy drm: No buffer, will fall back to only modeset (if present)");
+            AQLOG(connector->backend->backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_DRM, "legacy drm: No buffer, will fall back to only modeset (if present)");
         else
             mainFB = data.mainFB;
     }
 
     if (data.modeset) {
-        connector->backend->backend->log(AQ_LOG_DEBUG, std::format("legacy drm: Modesetting CRTC {}", connector->crtc->id));
+        AQLOG(connector->backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("legacy drm: Modesetting CRTC {}", connector->crtc->id));
 
         uint32_t dpms = enable ? DRM_MODE_DPMS_ON : DRM_MODE_DPMS_OFF;
         if (drmModeConnectorSetProperty(connector->backend->gpu->fd, connector->id, connector->props.dpms, dpms)) {
-            connector->backend->backend->log(AQ_LOG_ERROR, "legacy drm: Failed to set dpms");
+            AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "legacy drm: Failed to set dpms");
             return false;
         }
 
@@ -57,30 +58,31 @@ bool Aquamarine::CDRMLegacyImpl::commitInternal(Hyprutils::Memory::CSharedPointe
                 AQ_LOG_DEBUG,
                 std::format("legacy drm: Modesetting CRTC, mode: clock {} hdisplay {} vdisplay {} vrefresh {}", mode->clock, mode->hdisplay, mode->vdisplay, mode->vrefresh));
         } else
-            connector->backend->backend->log(AQ_LOG_DEBUG, "legacy drm: Modesetting CRTC, mode null");
+            AQLOG(connector->backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, "legacy drm: Modesetting CRTC, mode null");
 
         if (auto ret = drmModeSetCrtc(connector->backend->gpu->fd, connector->crtc->id, mainFB ? mainFB->id : -1, 0, 0, connectors.data(), connectors.size(), mode); ret) {
-            connector->backend->backend->log(AQ_LOG_ERROR, std::format("legacy drm: drmModeSetCrtc failed: {}", strerror(-ret)));
+            AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("legacy drm: drmModeSetCrtc failed: {}", strerror(-ret)));
             return false;
         }
     }
 
     if (STATE.committed & COutputState::eOutputStateProperties::AQ_OUTPUT_STATE_ADAPTIVE_SYNC) {
         if (STATE.adaptiveSync && !connector->canDoVrr) {
-            connector->backend->backend->log(AQ_LOG_ERROR, std::format("legacy drm: connector {} can't do vrr", connector->id));
+            AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("legacy drm: connector {} can't do vrr", connector->id));
             return false;
         }
 
         if (connector->crtc->props.vrr_enabled) {
             if (auto ret = drmModeObjectSetProperty(backend->gpu->fd, connector->crtc->id, DRM_MODE_OBJECT_CRTC, connector->crtc->props.vrr_enabled, (uint64_t)STATE.adaptiveSync);
                 ret) {
-                connector->backend->backend->log(AQ_LOG_ERROR, std::format("legacy drm: drmModeObjectSetProperty: vrr -> {} failed: {}", STATE.adaptiveSync, strerror(-ret)));
+                AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM,
+                      std::format("legacy drm: drmModeObjectSetProperty: vrr -> {} failed: {}", STATE.adaptiveSync, strerror(-ret)));
                 return false;
             }
         }
 
         connector->output->vrrActive = STATE.adaptiveSync;
-        connector->backend->backend->log(AQ_LOG_DEBUG, std::format("legacy drm: connector {} vrr -> {}", connector->id, STATE.adaptiveSync));
+        AQLOG(connector->backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM, std::format("legacy drm: connector {} vrr -> {}", connector->id, STATE.adaptiveSync));
     }
 
     // TODO: gamma
@@ -90,13 +92,13 @@ bool Aquamarine::CDRMLegacyImpl::commitInternal(Hyprutils::Memory::CSharedPointe
         auto     attrs    = data.cursorFB->buffer->dmabuf();
 
         if (int ret = drmPrimeFDToHandle(connector->backend->gpu->fd, attrs.fds.at(0), &boHandle); ret) {
-            connector->backend->backend->log(AQ_LOG_ERROR, std::format("legacy drm: drmPrimeFDToHandle failed: {}", strerror(-ret)));
+            AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("legacy drm: drmPrimeFDToHandle failed: {}", strerror(-ret)));
             return false;
         }
 
-        connector->backend->backend->log(AQ_LOG_DEBUG,
-                                         std::format("legacy drm: cursor fb: {} with bo handle {} from fd {}, size {}", connector->backend->gpu->fd, boHandle,
-                                                     data.cursorFB->buffer->dmabuf().fds.at(0), data.cursorFB->buffer->size));
+        AQLOG(connector->backend->backend, AQ_LOG_DEBUG, AQ_SUBSYSTEM_DRM,
+              std::format("legacy drm: cursor fb: {} with bo handle {} from fd {}, size {}", connector->backend->gpu->fd, boHandle,
+                          data.cursorFB->buffer->dmabuf().fds.at(0), data.cursorFB->buffer->size));
 
         Vector2D                cursorPos = connector->output->cursorPos;
 
@@ -115,14 +117,14 @@ bool Aquamarine::CDRMLegacyImpl::commitInternal(Hyprutils::Memory::CSharedPointe
         int ret = drmIoctl(connector->backend->gpu->fd, DRM_IOCTL_MODE_CURSOR2, &request);
 
         if (boHandle && drmCloseBufferHandle(connector->backend->gpu->fd, boHandle))
-            connector->backend->backend->log(AQ_LOG_ERROR, "legacy drm: drmCloseBufferHandle in cursor failed");
+            AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "legacy drm: drmCloseBufferHandle in cursor failed");
 
         if (ret) {
-            connector->backend->backend->log(AQ_LOG_ERROR, std::format("legacy drm: cursor drmIoctl failed: {}", strerror(errno)));
+            AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("legacy drm: cursor drmIoctl failed: {}", strerror(errno)));
             return false;
         }
     } else if (drmModeSetCursor(connector->backend->gpu->fd, connector->crtc->id, 0, 0, 0))
-        connector->backend->backend->log(AQ_LOG_ERROR, "legacy drm: cursor null failed");
+        AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, "legacy drm: cursor null failed");
 
     if (!enable)
         return true;
@@ -131,7 +133,7 @@ bool Aquamarine::CDRMLegacyImpl::commitInternal(Hyprutils::Memory::CSharedPointe
         return true;
 
     if (int ret = drmModePageFlip(connector->backend->gpu->fd, connector->crtc->id, mainFB ? mainFB->id : -1, data.flags, &connector->pendingPageFlip); ret) {
-        connector->backend->backend->log(AQ_LOG_ERROR, std::format("legacy drm: drmModePageFlip failed: {}", strerror(-ret)));
+        AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("legacy drm: drmModePageFlip failed: {}", strerror(-ret)));
         return false;
     }
 
@@ -158,7 +160,7 @@ bool Aquamarine::CDRMLegacyImpl::reset() {
             continue;
 
         if (int ret = drmModeSetCrtc(backend->gpu->fd, connector->crtc->id, 0, 0, 0, nullptr, 0, nullptr); ret) {
-            connector->backend->backend->log(AQ_LOG_ERROR, std::format("legacy drm: reset failed: {}", strerror(-ret)));
+            AQLOG(connector->backend->backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_DRM, std::format("legacy drm: reset failed: {}", strerror(-ret)));
             ok = false;
         }
     }
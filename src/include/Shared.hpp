@@ -26,3 +26,11 @@ namespace Aquamarine {
             expr;                                                                                                                                                                  \
         }                                                                                                                                                                          \
     }
+
+// logs through backend->log, but only formats / evaluates the message if the level isn't filtered out for the subsystem
+#define AQLOG(backend, level, subsystem, ...)                                                                                                                                      \
+    do {                                                                                                                                                                           \
+        auto&& aqLogBackend = backend;                                                                                                                                             \
+        if (aqLogBackend->shouldLog(level, subsystem))                                                                                                                             \
+            aqLogBackend->log(level, subsystem, __VA_ARGS__);                                                                                                                      \
+    } while (0)
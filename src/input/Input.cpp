@@ -1,4 +1,6 @@
 #include <aquamarine/input/Input.hpp>
+#include <algorithm>
+#include <bit>
 
 libinput_device* Aquamarine::IPointer::getLibinputHandle() {
     return nullptr;
@@ -31,3 +33,36 @@ libinput_device* Aquamarine::ITabletPad::getLibinputHandle() {
 void Aquamarine::IKeyboard::updateLEDs(uint32_t leds) {
     ;
 }
+
+void Aquamarine::SInputLatencyHistogram::add(uint64_t latencyUs) {
+    const size_t BUCKET = std::min((size_t)std::bit_width(latencyUs), BUCKETS - 1);
+
+    buckets[BUCKET]++;
+    samples++;
+    totalUs += latencyUs;
+    maxUs = std::max(maxUs, latencyUs);
+}
+
+void Aquamarine::SInputLatencyHistogram::reset() {
+    *this = {};
+}
+
+uint64_t Aquamarine::SInputLatencyHistogram::averageUs() const {
+    return samples ? totalUs / samples : 0;
+}
+
+uint64_t Aquamarine::SInputLatencyHistogram::percentileUs(double p) const {
+    if (!samples)
+        return 0;
+
+    const uint64_t TARGET = std::max<uint64_t>(1, (uint64_t)(p * samples));
+    uint64_t       seen   = 0;
+
+    for (size_t i = 0; i < BUCKETS - 1; ++i) {
+        seen += buckets[i];
+        if (seen >= TARGET)
+            return std::min<uint64_t>(i ? (1ULL << i) - 1 : 0, maxUs);
+    }
+
+    return maxUs;
+}
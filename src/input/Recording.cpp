@@ -0,0 +1,942 @@
+#include <aquamarine/input/Recording.hpp>
+#include <aquamarine/backend/Backend.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include "Shared.hpp"
+
+using namespace Aquamarine;
+using namespace Hyprutils::Memory;
+using namespace Hyprutils::Math;
+#define SP CSharedPointer
+#define WP CWeakPointer
+
+static const char     AQIR_MAGIC[4] = {'A', 'Q', 'I', 'R'};
+static const uint32_t AQIR_VERSION  = 1;
+static const size_t   AQIR_HEADER   = sizeof(AQIR_MAGIC) + sizeof(uint32_t);
+static const size_t   AQIR_RECORD   = sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint64_t);
+static const size_t   REPLAY_BATCH  = 256; // records per loop iteration when replaying as fast as possible
+
+static uint64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// payloads are packed field by field, no padding and nothing that isn't plain data
+class CPayloadWriter {
+  public:
+    CPayloadWriter(std::vector<uint8_t>& buf_) : buf(buf_) {
+        buf.clear();
+    }
+
+    template <typename T>
+    CPayloadWriter& put(const T& v) {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+        const auto P = (const uint8_t*)&v;
+        buf.insert(buf.end(), P, P + sizeof(T));
+        return *this;
+    }
+
+    CPayloadWriter& put(const Vector2D& v) {
+        return put(v.x).put(v.y);
+    }
+
+    CPayloadWriter& put(const std::string& s) {
+        put((uint16_t)s.size());
+        buf.insert(buf.end(), s.begin(), s.end());
+        return *this;
+    }
+
+  private:
+    std::vector<uint8_t>& buf;
+};
+
+class CPayloadReader {
+  public:
+    CPayloadReader(const uint8_t* data_, size_t size_) : data(data_), size(size_) {
+        ;
+    }
+
+    template <typename T>
+    CPayloadReader& get(T& v) {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+        if (pos + sizeof(T) > size) {
+            ok = false;
+            return *this;
+        }
+        memcpy(&v, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return *this;
+    }
+
+    CPayloadReader& get(Vector2D& v) {
+        return get(v.x).get(v.y);
+    }
+
+    CPayloadReader& get(std::string& s) {
+        uint16_t len = 0;
+        get(len);
+        if (!ok || pos + len > size) {
+            ok = false;
+            return *this;
+        }
+        s.assign((const char*)data + pos, len);
+        pos += len;
+        return *this;
+    }
+
+    bool ok = true;
+
+  private:
+    const uint8_t* data = nullptr;
+    size_t         size = 0, pos = 0;
+};
+
+// ------------ Recorder
+
+SP<CInputRecorder> Aquamarine::CInputRecorder::create(const std::string& path) {
+    auto file = fopen(path.c_str(), "wb");
+    if (!file)
+        return nullptr;
+
+    if (fwrite(AQIR_MAGIC, sizeof(AQIR_MAGIC), 1, file) != 1 || fwrite(&AQIR_VERSION, sizeof(AQIR_VERSION), 1, file) != 1) {
+        fclose(file);
+        return nullptr;
+    }
+
+    auto recorder  = SP<CInputRecorder>(new CInputRecorder());
+    recorder->file = file;
+    recorder->self = recorder;
+    return recorder;
+}
+
+Aquamarine::CInputRecorder::~CInputRecorder() {
+    if (file)
+        fclose(file);
+}
+
+void Aquamarine::CInputRecorder::flush() {
+    if (file)
+        fflush(file);
+}
+
+void Aquamarine::CInputRecorder::write(eInputRecordType type, uint32_t device, const std::vector<uint8_t>& payload) {
+    if (!file || payload.size() > UINT16_MAX)
+        return;
+
+    const uint8_t  TYPE = type;
+    const uint16_t SIZE = payload.size();
+    const uint64_t TIME = nowUs();
+
+    fwrite(&TYPE, sizeof(TYPE), 1, file);
+    fwrite(&SIZE, sizeof(SIZE), 1, file);
+    fwrite(&device, sizeof(device), 1, file);
+    fwrite(&TIME, sizeof(TIME), 1, file);
+    if (SIZE)
+        fwrite(payload.data(), 1, SIZE, file);
+
+    if (type != AQ_INPUT_RECORD_DEVICE && type != AQ_INPUT_RECORD_DEVICE_REMOVE && type != AQ_INPUT_RECORD_TABLET_TOOL)
+        recorded++;
+}
+
+SP<CInputRecorder::SDevice> Aquamarine::CInputRecorder::addDevice(eInputRecordDevice kind, const std::string& name) {
+    auto dev      = devices.emplace_back(makeShared<SDevice>());
+    dev->recorder = this;
+    dev->id       = nextDeviceID++;
+
+    CPayloadWriter(scratch).put(kind).put(name);
+    write(AQ_INPUT_RECORD_DEVICE, dev->id, scratch);
+
+    return dev;
+}
+
+uint32_t Aquamarine::CInputRecorder::toolID(uint32_t device, SP<ITabletTool> tool) {
+    for (size_t i = 0; i < tools.size(); ++i) {
+        if (tools[i] == tool)
+            return i;
+    }
+
+    const uint32_t ID = tools.size();
+    tools.emplace_back(tool);
+
+    CPayloadWriter(scratch).put(ID).put(tool->type).put(tool->serial).put(tool->id).put(tool->capabilities);
+    write(AQ_INPUT_RECORD_TABLET_TOOL, device, scratch);
+
+    return ID;
+}
+
+void Aquamarine::CInputRecorder::attach(SP<CBackend> backend) {
+    backendListeners.emplace_back(backend->events.newKeyboard.registerListener([this](std::any d) { attach(std::any_cast<SP<IKeyboard>>(d)); }));
+    backendListeners.emplace_back(backend->events.newPointer.registerListener([this](std::any d) { attach(std::any_cast<SP<IPointer>>(d)); }));
+    backendListeners.emplace_back(backend->events.newTouch.registerListener([this](std::any d) { attach(std::any_cast<SP<ITouch>>(d)); }));
+    backendListeners.emplace_back(backend->events.newTablet.registerListener([this](std::any d) { attach(std::any_cast<SP<ITablet>>(d)); }));
+}
+
+void Aquamarine::CInputRecorder::attach(SP<IKeyboard> keyboard) {
+    auto dev = addDevice(AQ_INPUT_RECORD_DEVICE_KEYBOARD, keyboard->getName());
+
+    dev->key = keyboard->events.key.registerTypedListener(
+        [](void* data, const IKeyboard::SKeyEvent& e) {
+            auto dev = (SDevice*)data;
+            CPayloadWriter(dev->recorder->scratch).put(e.timeMs).put(e.timeUs).put(e.key).put(e.pressed);
+            dev->recorder->write(AQ_INPUT_RECORD_KEY, dev->id, dev->recorder->scratch);
+        },
+        dev.get());
+
+    dev->listeners.emplace_back(keyboard->events.modifiers.registerListener([this, id = dev->id](std::any d) {
+        auto e = std::any_cast<IKeyboard::SModifiersEvent>(d);
+        CPayloadWriter(scratch).put(e.depressed).put(e.latched).put(e.locked).put(e.group);
+        write(AQ_INPUT_RECORD_MODIFIERS, id, scratch);
+    }));
+
+    dev->listeners.emplace_back(keyboard->events.destroy.registerListener([this, id = dev->id](std::any d) { write(AQ_INPUT_RECORD_DEVICE_REMOVE, id, {}); }));
+}
+
+void Aquamarine::CInputRecorder::attach(SP<IPointer> pointer) {
+    auto dev = addDevice(AQ_INPUT_RECORD_DEVICE_POINTER, pointer->getName());
+
+    dev->move = pointer->events.move.registerTypedListener(
+        [](void* data, const IPointer::SMoveEvent& e) {
+            auto dev = (SDevice*)data;
+            CPayloadWriter(dev->recorder->scratch).put(e.timeMs).put(e.timeUs).put(e.delta).put(e.unaccel);
+            dev->recorder->write(AQ_INPUT_RECORD_POINTER_MOVE, dev->id, dev->recorder->scratch);
+        },
+        dev.get());
+
+    dev->warp = pointer->events.warp.registerTypedListener(
+        [](void* data, const IPointer::SWarpEvent& e) {
+            auto dev = (SDevice*)data;
+            CPayloadWriter(dev->recorder->scratch).put(e.timeMs).put(e.timeUs).put(e.absolute);
+            dev->recorder->write(AQ_INPUT_RECORD_POINTER_WARP, dev->id, dev->recorder->scratch);
+        },
+        dev.get());
+
+    dev->button = pointer->events.button.registerTypedListener(
+        [](void* data, const IPointer::SButtonEvent& e) {
+            auto dev = (SDevice*)data;
+            CPayloadWriter(dev->recorder->scratch).put(e.timeMs).put(e.timeUs).put(e.button).put(e.pressed);
+            dev->recorder->write(AQ_INPUT_RECORD_POINTER_BUTTON, dev->id, dev->recorder->scratch);
+        },
+        dev.get());
+
+    dev->axis = pointer->events.axis.registerTypedListener(
+        [](void* data, const IPointer::SAxisEvent& e) {
+            auto dev = (SDevice*)data;
+            CPayloadWriter(dev->recorder->scratch).put(e.timeMs).put(e.timeUs).put(e.axis).put(e.source).put(e.direction).put(e.delta).put(e.discrete);
+            dev->recorder->write(AQ_INPUT_RECORD_POINTER_AXIS, dev->id, dev->recorder->scratch);
+        },
+        dev.get());
+
+    dev->frame = pointer->events.frame.registerTypedListener(
+        [](void* data) {
+            auto dev = (SDevice*)data;
+            dev->recorder->write(AQ_INPUT_RECORD_POINTER_FRAME, dev->id, {});
+        },
+        dev.get());
+
+    // gestures are rare enough for the std::any path
+    const auto ID = dev->id;
+
+    dev->listeners.emplace_back(pointer->events.swipeBegin.registerListener([this, ID](std::any d) {
+        auto e = std::any_cast<IPointer::SSwipeBeginEvent>(d);
+        CPayloadWriter(scratch).put(e.timeMs).put(e.timeUs).put(e.fingers);
+        write(AQ_INPUT_RECORD_SWIPE_BEGIN, ID, scratch);
+    }));
+    dev->listeners.emplace_back(pointer->events.swipeUpdate.registerListener([this, ID](std::any d) {
+        auto e = std::any_cast<IPointer::SSwipeUpdateEvent>(d);
+        CPayloadWriter(scratch).put(e.timeMs).put(e.timeUs).put(e.fingers).put(e.delta);
+        write(AQ_INPUT_RECORD_SWIPE_UPDATE, ID, scratch);
+    }));
+    dev->listeners.emplace_back(pointer->events.swipeEnd.registerListener([this, ID](std::any d) {
+        auto e = std::any_cast<IPointer::SSwipeEndEvent>(d);
+        CPayloadWriter(scratch).put(e.timeMs).put(e.timeUs).put(e.cancelled);
+        write(AQ_INPUT_RECORD_SWIPE_END, ID, scratch);
+    }));
+    dev->listeners.emplace_back(pointer->events.pinchBegin.registerListener([this, ID](std::any d) {
+        auto e = std::any_cast<IPointer::SPinchBeginEvent>(d);
+        CPayloadWriter(scratch).put(e.timeMs).put(e.timeUs).put(e.fingers);
+        write(AQ_INPUT_RECORD_PINCH_BEGIN, ID, scratch);
+    }));
+    dev->listeners.emplace_back(pointer->events.pinchUpdate.registerListener([this, ID](std::any d) {
+        auto e = std::any_cast<IPointer::SPinchUpdateEvent>(d);
+        CPayloadWriter(scratch).put(e.timeMs).put(e.timeUs).put(e.fingers).put(e.delta).put(e.scale).put(e.rotation);
+        write(AQ_INPUT_RECORD_PINCH_UPDATE, ID, scratch);
+    }));
+    dev->listeners.emplace_back(pointer->events.pinchEnd.registerListener([this, ID](std::any d) {
+        auto e = std::any_cast<IPointer::SPinchEndEvent>(d);
+        CPayloadWriter(scratch).put(e.timeMs).put(e.timeUs).put(e.cancelled);
+        write(AQ_INPUT_RECORD_PINCH_END, ID, scratch);
+    }));
+    dev->listeners.emplace_back(pointer->events.holdBegin.registerListener([this, ID](std::any d) {
+        auto e = std::any_cast<IPointer::SHoldBeginEvent>(d);
+        CPayloadWriter(scratch).put(e.timeMs).put(e.timeUs).put(e.fingers);
+        write(AQ_INPUT_RECORD_HOLD_BEGIN, ID, scratch);
+    }));
+    dev->listeners.emplace_back(pointer->events.holdEnd.registerListener([this, ID](std::any d) {
+        auto e = std::any_cast<IPointer::SHoldEndEvent>(d);
+        CPayloadWriter(scratch).put(e.timeMs).put(e.timeUs).put(e.cancelled);
+        write(AQ_INPUT_RECORD_HOLD_END, ID, scratch);
+    }));
+
+    dev->listeners.emplace_back(pointer->events.destroy.registerListener([this, ID](std::any d) { write(AQ_INPUT_RECORD_DEVICE_REMOVE, ID, {}); }));
+}
+
+void Aquamarine::CInputRecorder::attach(SP<ITouch> touch) {
+    auto dev = addDevice(AQ_INPUT_RECORD_DEVICE_TOUCH, touch->getName());
+
+    dev->touchDown = touch->events.down.registerTypedListener(
+        [](void* data, const ITouch::SDownEvent& e) {
+            auto dev = (SDevice*)data;
+            CPayloadWriter(dev->recorder->scratch).put(e.timeMs).put(e.timeUs).put(e.touchID).put(e.pos);
+            dev->recorder->write(AQ_INPUT_RECORD_TOUCH_DOWN, dev->id, dev->recorder->scratch);
+        },
+        dev.get());
+
+    dev->touchUp = touch->events.up.registerTypedListener(
+        [](void* data, const ITouch::SUpEvent& e) {
+            auto dev = (SDevice*)data;
+            CPayloadWriter(dev->recorder->scratch).put(e.timeMs).put(e.timeUs).put(e.touchID);
+            dev->recorder->write(AQ_INPUT_RECORD_TOUCH_UP, dev->id, dev->recorder->scratch);
+        },
+        dev.get());
+
+    dev->touchMotion = touch->events.move.registerTypedListener(
+        [](void* data, const ITouch::SMotionEvent& e) {
+            auto dev = (SDevice*)data;
+            CPayloadWriter(dev->recorder->scratch).put(e.timeMs).put(e.timeUs).put(e.touchID).put(e.pos);
+            dev->recorder->write(AQ_INPUT_RECORD_TOUCH_MOTION, dev->id, dev->recorder->scratch);
+        },
+        dev.get());
+
+    // batched motion is recorded as the individual events it's made of, replay always delivers them one by one
+    dev->touchMotionBatch = touch->events.moveBatch.registerTypedListener(
+        [](void* data, const ITouch::SMotionBatch& e) {
+            auto dev = (SDevice*)data;
+            for (size_t i = 0; i < e.timeUs.size(); ++i) {
+                const uint32_t TIMEMS = e.timeUs[i] / 1000;
+                CPayloadWriter(dev->recorder->scratch).put(TIMEMS).put(e.timeUs[i]).put(e.touchID[i]).put(Vector2D{e.x[i], e.y[i]});
+                dev->recorder->write(AQ_INPUT_RECORD_TOUCH_MOTION, dev->id, dev->recorder->scratch);
+            }
+        },
+        dev.get());
+
+    dev->frame = touch->events.frame.registerTypedListener(
+        [](void* data) {
+            auto dev = (SDevice*)data;
+            dev->recorder->write(AQ_INPUT_RECORD_TOUCH_FRAME, dev->id, {});
+        },
+        dev.get());
+
+    dev->listeners.emplace_back(touch->events.cancel.registerListener([this, id = dev->id](std::any d) {
+        auto e = std::any_cast<ITouch::SCancelEvent>(d);
+        CPayloadWriter(scratch).put(e.timeMs).put(e.timeUs).put(e.touchID);
+        write(AQ_INPUT_RECORD_TOUCH_CANCEL, id, scratch);
+    }));
+
+    dev->listeners.emplace_back(touch->events.destroy.registerListener([this, id = dev->id](std::any d) { write(AQ_INPUT_RECORD_DEVICE_REMOVE, id, {}); }));
+}
+
+void Aquamarine::CInputRecorder::attach(SP<ITablet> tablet) {
+    auto dev = addDevice(AQ_INPUT_RECORD_DEVICE_TABLET, tablet->getName());
+
+    dev->tabletAxis = tablet->events.axis.registerTypedListener(
+        [](void* data, const ITablet::SAxisEvent& e) {
+            auto           dev  = (SDevice*)data;
+            const uint32_t TOOL = dev->recorder->toolID(dev->id, e.tool);
+            CPayloadWriter(dev->recorder->scratch)
+                .put(TOOL)
+                .put(e.timeMs)
+                .put(e.timeUs)
+                .put(e.updatedAxes)
+                .put(e.absolute)
+                .put(e.delta)
+                .put(e.tilt)
+                .put(e.pressure)
+                .put(e.distance)
+                .put(e.rotation)
+                .put(e.slider)
+                .put(e.wheelDelta);
+            dev->recorder->write(AQ_INPUT_RECORD_TABLET_AXIS, dev->id, dev->recorder->scratch);
+        },
+        dev.get());
+
+    dev->tabletAxisBatch = tablet->events.axisBatch.registerTypedListener(
+        [](void* data, const ITablet::SAxisBatch& e) {
+            auto           dev  = (SDevice*)data;
+            const uint32_t TOOL = dev->recorder->toolID(dev->id, e.tool);
+            for (size_t i = 0; i < e.timeUs.size(); ++i) {
+                const uint32_t TIMEMS = e.timeUs[i] / 1000;
+                CPayloadWriter(dev->recorder->scratch)
+                    .put(TOOL)
+                    .put(TIMEMS)
+                    .put(e.timeUs[i])
+                    .put(e.updatedAxes[i])
+                    .put(Vector2D{e.x[i], e.y[i]})
+                    .put(Vector2D{e.dx[i], e.dy[i]})
+                    .put(Vector2D{e.tiltX[i], e.tiltY[i]})
+                    .put(e.pressure[i])
+                    .put(e.distance[i])
+                    .put(e.rotation[i])
+                    .put(e.slider[i])
+                    .put(e.wheelDelta[i]);
+                dev->recorder->write(AQ_INPUT_RECORD_TABLET_AXIS, dev->id, dev->recorder->scratch);
+            }
+        },
+        dev.get());
+
+    const auto ID = dev->id;
+
+    dev->listeners.emplace_back(tablet->events.proximity.registerListener([this, ID](std::any d) {
+        auto           e    = std::any_cast<ITablet::SProximityEvent>(d);
+        const uint32_t TOOL = toolID(ID, e.tool);
+        CPayloadWriter(scratch).put(TOOL).put(e.timeMs).put(e.timeUs).put(e.absolute).put(e.in);
+        write(AQ_INPUT_RECORD_TABLET_PROXIMITY, ID, scratch);
+    }));
+    dev->listeners.emplace_back(tablet->events.tip.registerListener([this, ID](std::any d) {
+        auto           e    = std::any_cast<ITablet::STipEvent>(d);
+        const uint32_t TOOL = toolID(ID, e.tool);
+        CPayloadWriter(scratch).put(TOOL).put(e.timeMs).put(e.timeUs).put(e.absolute).put(e.down);
+        write(AQ_INPUT_RECORD_TABLET_TIP, ID, scratch);
+    }));
+    dev->listeners.emplace_back(tablet->events.button.registerListener([this, ID](std::any d) {
+        auto           e    = std::any_cast<ITablet::SButtonEvent>(d);
+        const uint32_t TOOL = toolID(ID, e.tool);
+        CPayloadWriter(scratch).put(TOOL).put(e.timeMs).put(e.timeUs).put(e.button).put(e.down);
+        write(AQ_INPUT_RECORD_TABLET_BUTTON, ID, scratch);
+    }));
+
+    dev->listeners.emplace_back(tablet->events.destroy.registerListener([this, ID](std::any d) { write(AQ_INPUT_RECORD_DEVICE_REMOVE, ID, {}); }));
+}
+
+// ------------ Replay
+
+namespace {
+    class CReplayKeyboard : public IKeyboard {
+      public:
+        CReplayKeyboard(const std::string& name_) : name(name_) {
+            ;
+        }
+        virtual const std::string& getName() {
+            return name;
+        }
+
+      private:
+        std::string name;
+    };
+
+    class CReplayPointer : public IPointer {
+      public:
+        CReplayPointer(const std::string& name_) : name(name_) {
+            ;
+        }
+        virtual const std::string& getName() {
+            return name;
+        }
+
+      private:
+        std::string name;
+    };
+
+    class CReplayTouch : public ITouch {
+      public:
+        CReplayTouch(const std::string& name_) : name(name_) {
+            ;
+        }
+        virtual const std::string& getName() {
+            return name;
+        }
+
+      private:
+        std::string name;
+    };
+
+    class CReplayTablet : public ITablet {
+      public:
+        CReplayTablet(const std::string& name_) : name(name_) {
+            ;
+        }
+        virtual const std::string& getName() {
+            return name;
+        }
+
+      private:
+        std::string name;
+    };
+
+    class CReplayTabletTool : public ITabletTool {
+      public:
+        CReplayTabletTool(const std::string& name_) : name(name_) {
+            ;
+        }
+        virtual const std::string& getName() {
+            return name;
+        }
+
+      private:
+        std::string name;
+    };
+};
+
+SP<CInputReplay> Aquamarine::CInputReplay::create(SP<CBackend> backend, const std::string& path) {
+    std::ifstream        f(path, std::ios::binary);
+    std::vector<uint8_t> data{std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+
+    if (data.size() < AQIR_HEADER || memcmp(data.data(), AQIR_MAGIC, sizeof(AQIR_MAGIC)) != 0) {
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("input replay: {} is not an input recording", path));
+        return nullptr;
+    }
+
+    uint32_t version = 0;
+    memcpy(&version, data.data() + sizeof(AQIR_MAGIC), sizeof(version));
+    if (version != AQIR_VERSION) {
+        AQLOG(backend, AQ_LOG_ERROR, AQ_SUBSYSTEM_CORE, std::format("input replay: {} has unsupported version {}", path, version));
+        return nullptr;
+    }
+
+    auto replay     = SP<CInputReplay>(new CInputReplay());
+    replay->backend = backend;
+    replay->self    = replay;
+
+    size_t pos = AQIR_HEADER;
+    while (pos + AQIR_RECORD <= data.size()) {
+        SRecord        record;
+        CPayloadReader reader(data.data() + pos, AQIR_RECORD);
+        reader.get(record.type).get(record.size).get(record.device).get(record.timeUs);
+
+        record.offset = pos + AQIR_RECORD;
+        if (record.offset + record.size > data.size())
+            break; // truncated, e.g. the recorder didn't get to flush
+
+        replay->records.emplace_back(record);
+        pos = record.offset + record.size;
+    }
+
+    if (pos != data.size())
+        AQLOG(backend, AQ_LOG_WARNING, AQ_SUBSYSTEM_CORE, std::format("input replay: {} is truncated, replaying {} records", path, replay->records.size()));
+
+    replay->data = std::move(data);
+
+    return replay;
+}
+
+Aquamarine::CInputReplay::~CInputReplay() {
+    stop();
+}
+
+void Aquamarine::CInputReplay::start(double speed_) {
+    if (running || !backend)
+        return;
+
+    speed           = speed_ < 0 ? 1.0 : speed_;
+    running         = true;
+    replayStartUs   = nowUs();
+    recordedStartUs = next < records.size() ? records.at(next).timeUs : 0;
+
+    if (!timer)
+        timer = makeShared<CBackendTimer>([w = self]() {
+            if (auto r = w.lock())
+                r->dispatch();
+        });
+
+    backend->rescheduleTimer(timer, std::chrono::microseconds(0));
+}
+
+void Aquamarine::CInputReplay::stop() {
+    running = false;
+
+    if (timer && backend)
+        backend->cancelTimer(timer);
+}
+
+bool Aquamarine::CInputReplay::finished() {
+    return next >= records.size();
+}
+
+void Aquamarine::CInputReplay::dispatch() {
+    if (!running || !backend)
+        return;
+
+    // listeners may drop us
+    auto           keepAlive = self.lock();
+
+    const uint64_t ELAPSED = nowUs() - replayStartUs;
+    size_t         batch   = 0;
+
+    while (running && next < records.size()) {
+        const auto& RECORD = records.at(next);
+
+        if (speed > 0) {
+            const uint64_t DUE = (uint64_t)((RECORD.timeUs - recordedStartUs) / speed);
+            if (DUE > ELAPSED) {
+                backend->rescheduleTimer(timer, std::chrono::microseconds(DUE - ELAPSED));
+                return;
+            }
+        } else if (batch++ >= REPLAY_BATCH) {
+            // let the loop breathe
+            backend->rescheduleTimer(timer, std::chrono::microseconds(0));
+            return;
+        }
+
+        next++;
+        replay(RECORD);
+    }
+
+    if (next < records.size())
+        return; // stopped from a listener
+
+    running = false;
+    events.finished.emit();
+}
+
+// the device's destructor emits destroy once the last reference goes, consumers still holding it get told here
+template <typename T>
+static void dropReplayDevice(SP<T>& device) {
+    if (!device)
+        return;
+
+    if (device.strongRef() > 1)
+        device->events.destroy.emit();
+
+    device.reset();
+}
+
+CInputReplay::SDevice* Aquamarine::CInputReplay::deviceFor(const SRecord& record) {
+    if (record.device >= devices.size())
+        return nullptr;
+
+    auto& dev = devices.at(record.device);
+    if (!dev.keyboard && !dev.pointer && !dev.touch && !dev.tablet)
+        return nullptr;
+
+    return &dev;
+}
+
+void Aquamarine::CInputReplay::replay(const SRecord& record) {
+    CPayloadReader reader(data.data() + record.offset, record.size);
+
+    // recorded timestamps, moved to the replay's timeline
+    uint32_t timeMs   = 0;
+    uint64_t timeUs   = 0;
+    auto     readTime = [&]() {
+        reader.get(timeMs).get(timeUs);
+        timeUs = timeUs - recordedStartUs + replayStartUs;
+        timeMs = (uint32_t)(timeUs / 1000);
+    };
+
+    auto toolFor = [this](uint32_t id) -> SP<ITabletTool> { return id < tools.size() ? tools.at(id) : nullptr; };
+
+    if (record.type == AQ_INPUT_RECORD_DEVICE) {
+        eInputRecordDevice kind = AQ_INPUT_RECORD_DEVICE_KEYBOARD;
+        std::string        name;
+        reader.get(kind).get(name);
+        if (!reader.ok)
+            return;
+
+        if (devices.size() <= record.device)
+            devices.resize(record.device + 1);
+
+        auto& dev = devices.at(record.device);
+        dev       = SDevice{.kind = kind};
+
+        switch (kind) {
+            case AQ_INPUT_RECORD_DEVICE_KEYBOARD:
+                dev.keyboard = makeShared<CReplayKeyboard>(name);
+                backend->events.newKeyboard.emit(dev.keyboard);
+                break;
+            case AQ_INPUT_RECORD_DEVICE_POINTER:
+                dev.pointer = makeShared<CReplayPointer>(name);
+                backend->events.newPointer.emit(dev.pointer);
+                break;
+            case AQ_INPUT_RECORD_DEVICE_TOUCH:
+                dev.touch = makeShared<CReplayTouch>(name);
+                backend->events.newTouch.emit(dev.touch);
+                break;
+            case AQ_INPUT_RECORD_DEVICE_TABLET:
+                dev.tablet = makeShared<CReplayTablet>(name);
+                backend->events.newTablet.emit(dev.tablet);
+                break;
+        }
+
+        return;
+    }
+
+    auto dev = deviceFor(record);
+    if (!dev) {
+        AQLOG(backend, AQ_LOG_TRACE, AQ_SUBSYSTEM_CORE, std::format("input replay: record {} for unknown device {}", (int)record.type, record.device));
+        return;
+    }
+
+    replayed++;
+
+    switch (record.type) {
+        case AQ_INPUT_RECORD_DEVICE: break; /* handled above */
+        case AQ_INPUT_RECORD_DEVICE_REMOVE: {
+            dropReplayDevice(dev->keyboard);
+            dropReplayDevice(dev->pointer);
+            dropReplayDevice(dev->touch);
+            dropReplayDevice(dev->tablet);
+            *dev = SDevice{};
+            replayed--;
+            break;
+        }
+        case AQ_INPUT_RECORD_TABLET_TOOL: {
+            uint32_t id   = 0;
+            auto     tool = makeShared<CReplayTabletTool>(dev->tablet ? dev->tablet->getName() : std::string{});
+            reader.get(id).get(tool->type).get(tool->serial).get(tool->id).get(tool->capabilities);
+            replayed--;
+            if (!reader.ok)
+                return;
+
+            if (tools.size() <= id)
+                tools.resize(id + 1);
+            tools.at(id) = tool;
+            backend->events.newTabletTool.emit(SP<ITabletTool>(tool));
+            break;
+        }
+
+        case AQ_INPUT_RECORD_KEY: {
+            IKeyboard::SKeyEvent e;
+            readTime();
+            reader.get(e.key).get(e.pressed);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->keyboard)
+                dev->keyboard->events.key.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_MODIFIERS: {
+            IKeyboard::SModifiersEvent e;
+            reader.get(e.depressed).get(e.latched).get(e.locked).get(e.group);
+            if (reader.ok && dev->keyboard)
+                dev->keyboard->events.modifiers.emit(e);
+            break;
+        }
+
+        case AQ_INPUT_RECORD_POINTER_MOVE: {
+            IPointer::SMoveEvent e;
+            readTime();
+            reader.get(e.delta).get(e.unaccel);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.move.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_POINTER_WARP: {
+            IPointer::SWarpEvent e;
+            readTime();
+            reader.get(e.absolute);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.warp.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_POINTER_BUTTON: {
+            IPointer::SButtonEvent e;
+            readTime();
+            reader.get(e.button).get(e.pressed);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.button.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_POINTER_AXIS: {
+            IPointer::SAxisEvent e;
+            readTime();
+            reader.get(e.axis).get(e.source).get(e.direction).get(e.delta).get(e.discrete);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.axis.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_POINTER_FRAME: {
+            if (dev->pointer)
+                dev->pointer->events.frame.emit();
+            break;
+        }
+        case AQ_INPUT_RECORD_SWIPE_BEGIN: {
+            IPointer::SSwipeBeginEvent e;
+            readTime();
+            reader.get(e.fingers);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.swipeBegin.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_SWIPE_UPDATE: {
+            IPointer::SSwipeUpdateEvent e;
+            readTime();
+            reader.get(e.fingers).get(e.delta);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.swipeUpdate.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_SWIPE_END: {
+            IPointer::SSwipeEndEvent e;
+            readTime();
+            reader.get(e.cancelled);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.swipeEnd.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_PINCH_BEGIN: {
+            IPointer::SPinchBeginEvent e;
+            readTime();
+            reader.get(e.fingers);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.pinchBegin.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_PINCH_UPDATE: {
+            IPointer::SPinchUpdateEvent e;
+            readTime();
+            reader.get(e.fingers).get(e.delta).get(e.scale).get(e.rotation);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.pinchUpdate.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_PINCH_END: {
+            IPointer::SPinchEndEvent e;
+            readTime();
+            reader.get(e.cancelled);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.pinchEnd.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_HOLD_BEGIN: {
+            IPointer::SHoldBeginEvent e;
+            readTime();
+            reader.get(e.fingers);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.holdBegin.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_HOLD_END: {
+            IPointer::SHoldEndEvent e;
+            readTime();
+            reader.get(e.cancelled);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->pointer)
+                dev->pointer->events.holdEnd.emit(e);
+            break;
+        }
+
+        case AQ_INPUT_RECORD_TOUCH_DOWN: {
+            ITouch::SDownEvent e;
+            readTime();
+            reader.get(e.touchID).get(e.pos);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->touch)
+                dev->touch->events.down.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_TOUCH_UP: {
+            ITouch::SUpEvent e;
+            readTime();
+            reader.get(e.touchID);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->touch)
+                dev->touch->events.up.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_TOUCH_MOTION: {
+            ITouch::SMotionEvent e;
+            readTime();
+            reader.get(e.touchID).get(e.pos);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->touch)
+                dev->touch->events.move.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_TOUCH_CANCEL: {
+            ITouch::SCancelEvent e;
+            readTime();
+            reader.get(e.touchID);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->touch)
+                dev->touch->events.cancel.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_TOUCH_FRAME: {
+            if (dev->touch)
+                dev->touch->events.frame.emit();
+            break;
+        }
+
+        case AQ_INPUT_RECORD_TABLET_AXIS: {
+            ITablet::SAxisEvent e;
+            uint32_t            tool = 0;
+            reader.get(tool);
+            readTime();
+            reader.get(e.updatedAxes).get(e.absolute).get(e.delta).get(e.tilt).get(e.pressure).get(e.distance).get(e.rotation).get(e.slider).get(e.wheelDelta);
+            e.tool   = toolFor(tool);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->tablet)
+                dev->tablet->events.axis.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_TABLET_PROXIMITY: {
+            ITablet::SProximityEvent e;
+            uint32_t                 tool = 0;
+            reader.get(tool);
+            readTime();
+            reader.get(e.absolute).get(e.in);
+            e.tool   = toolFor(tool);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->tablet)
+                dev->tablet->events.proximity.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_TABLET_TIP: {
+            ITablet::STipEvent e;
+            uint32_t           tool = 0;
+            reader.get(tool);
+            readTime();
+            reader.get(e.absolute).get(e.down);
+            e.tool   = toolFor(tool);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->tablet)
+                dev->tablet->events.tip.emit(e);
+            break;
+        }
+        case AQ_INPUT_RECORD_TABLET_BUTTON: {
+            ITablet::SButtonEvent e;
+            uint32_t              tool = 0;
+            reader.get(tool);
+            readTime();
+            reader.get(e.button).get(e.down);
+            e.tool   = toolFor(tool);
+            e.timeMs = timeMs;
+            e.timeUs = timeUs;
+            if (reader.ok && dev->tablet)
+                dev->tablet->events.button.emit(e);
+            break;
+        }
+
+        default: replayed--; break;
+    }
+}
@@ -0,0 +1,248 @@
+#include <aquamarine/input/Resampler.hpp>
+#include <aquamarine/backend/Backend.hpp>
+#include <algorithm>
+
+using namespace Aquamarine;
+using namespace Hyprutils::Memory;
+using namespace Hyprutils::Math;
+#define SP CSharedPointer
+#define WP CWeakPointer
+
+void Aquamarine::CInputResampler::SHistory::push(uint64_t timeUs, const Vector2D& pos) {
+    // same timestamp, e.g. x and y of a tablet coming in separately: the newer position wins
+    if (count > 0 && last().timeUs == timeUs) {
+        samples[(head + SIZE - 1) % SIZE].pos = pos;
+        return;
+    }
+
+    samples[head] = {.timeUs = timeUs, .pos = pos};
+    head          = (head + 1) % SIZE;
+    count         = std::min(count + 1, SIZE);
+}
+
+void Aquamarine::CInputResampler::SHistory::clear() {
+    count = 0;
+    head  = 0;
+}
+
+const CInputResampler::SSample& Aquamarine::CInputResampler::SHistory::at(size_t i) const {
+    return samples[(head + SIZE - count + i) % SIZE];
+}
+
+const CInputResampler::SSample& Aquamarine::CInputResampler::SHistory::last() const {
+    return at(count - 1);
+}
+
+std::optional<Vector2D> Aquamarine::CInputResampler::SHistory::resample(uint64_t timeUs, uint64_t maxPredictionUs, uint64_t maxIdleUs) const {
+    if (count == 0)
+        return std::nullopt;
+
+    const auto& LAST = last();
+
+    if (timeUs <= at(0).timeUs)
+        return at(0).pos;
+
+    if (timeUs <= LAST.timeUs) {
+        for (size_t i = 1; i < count; ++i) {
+            const auto& A = at(i - 1);
+            const auto& B = at(i);
+            if (timeUs > B.timeUs)
+                continue;
+
+            const double T = (double)(timeUs - A.timeUs) / (double)(B.timeUs - A.timeUs);
+            return A.pos + (B.pos - A.pos) * T;
+        }
+
+        return LAST.pos;
+    }
+
+    if (count < 2 || timeUs - LAST.timeUs > maxIdleUs)
+        return LAST.pos;
+
+    const auto& PREV = at(count - 2);
+    const auto  DT   = LAST.timeUs - PREV.timeUs;
+    if (DT == 0 || DT > maxIdleUs)
+        return LAST.pos;
+
+    const double AHEAD = (double)std::min(timeUs - LAST.timeUs, maxPredictionUs);
+    return LAST.pos + (LAST.pos - PREV.pos) * (AHEAD / (double)DT);
+}
+
+SP<CInputResampler> Aquamarine::CInputResampler::create() {
+    return SP<CInputResampler>(new CInputResampler());
+}
+
+SP<CInputResampler::SDevice> Aquamarine::CInputResampler::addDevice(void* device) {
+    // devices that went away are only marked as such, their listeners may have still been emitting
+    std::erase_if(devices, [](const auto& d) { return !d->device; });
+
+    auto dev    = devices.emplace_back(makeShared<SDevice>());
+    dev->device = device;
+    return dev;
+}
+
+CInputResampler::SDevice* Aquamarine::CInputResampler::deviceFor(void* device) {
+    auto it = std::ranges::find_if(devices, [device](const auto& d) { return d->device == device; });
+    return it == devices.end() ? nullptr : it->get();
+}
+
+void Aquamarine::CInputResampler::removeDevice(void* device) {
+    auto dev = deviceFor(device);
+    if (!dev)
+        return;
+
+    dev->device = nullptr;
+    dev->history.clear();
+    dev->touches.clear();
+}
+
+void Aquamarine::CInputResampler::attach(SP<CBackend> backend) {
+    backendListeners.emplace_back(backend->events.newPointer.registerListener([this](std::any d) { attach(std::any_cast<SP<IPointer>>(d)); }));
+    backendListeners.emplace_back(backend->events.newTouch.registerListener([this](std::any d) { attach(std::any_cast<SP<ITouch>>(d)); }));
+    backendListeners.emplace_back(backend->events.newTablet.registerListener([this](std::any d) { attach(std::any_cast<SP<ITablet>>(d)); }));
+}
+
+void Aquamarine::CInputResampler::attach(SP<IPointer> pointer) {
+    auto dev = addDevice(pointer.get());
+
+    dev->move = pointer->events.move.registerTypedListener(
+        [](void* data, const IPointer::SMoveEvent& e) {
+            auto dev = (SDevice*)data;
+
+            // coalesced moves still carry every motion, which gives a better history than their sum
+            if (!e.samples.empty()) {
+                for (const auto& s : e.samples) {
+                    dev->position = dev->position + s.delta;
+                    dev->history.push(s.timeUs, dev->position);
+                }
+                return;
+            }
+
+            dev->position = dev->position + e.delta;
+            dev->history.push(e.timeUs, dev->position);
+        },
+        dev.get());
+
+    dev->warp = pointer->events.warp.registerTypedListener(
+        [](void* data, const IPointer::SWarpEvent& e) {
+            auto dev      = (SDevice*)data;
+            dev->position = {};
+            dev->history.clear();
+        },
+        dev.get());
+
+    dev->listeners.emplace_back(pointer->events.destroy.registerListener([this, device = pointer.get()](std::any d) { removeDevice(device); }));
+}
+
+void Aquamarine::CInputResampler::attach(SP<ITouch> touch) {
+    auto dev = addDevice(touch.get());
+
+    dev->touchDown = touch->events.down.registerTypedListener(
+        [](void* data, const ITouch::SDownEvent& e) {
+            auto  dev     = (SDevice*)data;
+            auto& history = dev->touches[e.touchID];
+            history.clear();
+            history.push(e.timeUs, e.pos);
+        },
+        dev.get());
+
+    dev->touchUp = touch->events.up.registerTypedListener([](void* data, const ITouch::SUpEvent& e) { ((SDevice*)data)->touches.erase(e.touchID); }, dev.get());
+
+    dev->touchMotion = touch->events.move.registerTypedListener(
+        [](void* data, const ITouch::SMotionEvent& e) { ((SDevice*)data)->touches[e.touchID].push(e.timeUs, e.pos); }, dev.get());
+
+    dev->touchMotionBatch = touch->events.moveBatch.registerTypedListener(
+        [](void* data, const ITouch::SMotionBatch& e) {
+            auto dev = (SDevice*)data;
+            for (size_t i = 0; i < e.timeUs.size(); ++i) {
+                dev->touches[e.touchID[i]].push(e.timeUs[i], {e.x[i], e.y[i]});
+            }
+        },
+        dev.get());
+
+    dev->listeners.emplace_back(touch->events.cancel.registerListener([dev = dev.get()](std::any d) {
+        auto e = std::any_cast<ITouch::SCancelEvent>(d);
+        dev->touches.erase(e.touchID);
+    }));
+
+    dev->listeners.emplace_back(touch->events.destroy.registerListener([this, device = touch.get()](std::any d) { removeDevice(device); }));
+}
+
+void Aquamarine::CInputResampler::attach(SP<ITablet> tablet) {
+    auto dev = addDevice(tablet.get());
+
+    dev->tabletAxis = tablet->events.axis.registerTypedListener(
+        [](void* data, const ITablet::SAxisEvent& e) {
+            auto dev = (SDevice*)data;
+            if (!(e.updatedAxes & (AQ_TABLET_TOOL_AXIS_X | AQ_TABLET_TOOL_AXIS_Y)))
+                return;
+
+            // only the updated axes are filled in
+            if (e.updatedAxes & AQ_TABLET_TOOL_AXIS_X)
+                dev->position.x = e.absolute.x;
+            if (e.updatedAxes & AQ_TABLET_TOOL_AXIS_Y)
+                dev->position.y = e.absolute.y;
+
+            dev->history.push(e.timeUs, dev->position);
+        },
+        dev.get());
+
+    dev->tabletAxisBatch = tablet->events.axisBatch.registerTypedListener(
+        [](void* data, const ITablet::SAxisBatch& e) {
+            auto dev = (SDevice*)data;
+            for (size_t i = 0; i < e.timeUs.size(); ++i) {
+                if (!(e.updatedAxes[i] & (AQ_TABLET_TOOL_AXIS_X | AQ_TABLET_TOOL_AXIS_Y)))
+                    continue;
+
+                dev->position = {e.x[i], e.y[i]};
+                dev->history.push(e.timeUs[i], dev->position);
+            }
+        },
+        dev.get());
+
+    dev->listeners.emplace_back(tablet->events.proximity.registerListener([dev = dev.get()](std::any d) {
+        auto e = std::any_cast<ITablet::SProximityEvent>(d);
+
+        // whatever the tool did before it left has nothing to do with where it comes back
+        dev->history.clear();
+        if (!e.in)
+            return;
+
+        dev->position = e.absolute;
+        dev->history.push(e.timeUs, dev->position);
+    }));
+
+    dev->listeners.emplace_back(tablet->events.destroy.registerListener([this, device = tablet.get()](std::any d) { removeDevice(device); }));
+}
+
+std::optional<Vector2D> Aquamarine::CInputResampler::pointerOffset(SP<IPointer> pointer, uint64_t timeUs) {
+    auto dev = deviceFor(pointer.get());
+    if (!dev || dev->history.count == 0)
+        return std::nullopt;
+
+    const auto POS = dev->history.resample(timeUs, maxPredictionUs, maxIdleUs);
+    if (!POS)
+        return std::nullopt;
+
+    return *POS - dev->history.last().pos;
+}
+
+std::optional<Vector2D> Aquamarine::CInputResampler::touchPosition(SP<ITouch> touch, int32_t touchID, uint64_t timeUs) {
+    auto dev = deviceFor(touch.get());
+    if (!dev)
+        return std::nullopt;
+
+    auto it = dev->touches.find(touchID);
+    if (it == dev->touches.end())
+        return std::nullopt;
+
+    return it->second.resample(timeUs, maxPredictionUs, maxIdleUs);
+}
+
+std::optional<Vector2D> Aquamarine::CInputResampler::tabletPosition(SP<ITablet> tablet, uint64_t timeUs) {
+    auto dev = deviceFor(tablet.get());
+    if (!dev)
+        return std::nullopt;
+
+    return dev->history.resample(timeUs, maxPredictionUs, maxIdleUs);
+}
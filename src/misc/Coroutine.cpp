@@ -0,0 +1,104 @@
+#include <aquamarine/misc/Coroutine.hpp>
+#include <aquamarine/backend/Backend.hpp>
+#include <aquamarine/output/Output.hpp>
+
+using namespace Aquamarine;
+using namespace Hyprutils::Memory;
+#define SP CSharedPointer
+#define WP CWeakPointer
+
+static void resumeOnLoop(WP<CBackend> backend, std::coroutine_handle<> h) {
+    if (!backend)
+        return;
+
+    backend->postToLoop([h]() { h.resume(); });
+}
+
+Aquamarine::CCoroutineScheduler::CCoroutineScheduler(SP<CBackend> backend_) : backend(backend_) {
+    ;
+}
+
+void Aquamarine::CCoroutineScheduler::schedule(std::coroutine_handle<> h) {
+    resumeOnLoop(backend, h);
+}
+
+CFrameAwaitable Aquamarine::CCoroutineScheduler::nextFrame(SP<IOutput> output) {
+    return CFrameAwaitable(backend, output);
+}
+
+CPresentAwaitable Aquamarine::CCoroutineScheduler::presented(SP<IOutput> output) {
+    return CPresentAwaitable(backend, output);
+}
+
+CCommitAwaitable Aquamarine::CCoroutineScheduler::commit(SP<IOutput> output) {
+    return CCommitAwaitable(output);
+}
+
+CYieldAwaitable Aquamarine::CCoroutineScheduler::yield() {
+    return CYieldAwaitable(backend);
+}
+
+Aquamarine::IOutputAwaitable::IOutputAwaitable(WP<CBackend> backend_, SP<IOutput> output) : backend(backend_) {
+    // listeners can't be dropped from inside their own emit, they go away with the awaitable once we've resumed
+    destroyListener = output->events.destroy.registerListener([this](std::any d) {
+        lost = true;
+        complete();
+    });
+}
+
+void Aquamarine::IOutputAwaitable::await_suspend(std::coroutine_handle<> h) {
+    handle = h;
+}
+
+void Aquamarine::IOutputAwaitable::complete() {
+    if (done)
+        return;
+
+    done = true;
+
+    if (handle)
+        resumeOnLoop(backend, handle);
+}
+
+Aquamarine::CFrameAwaitable::CFrameAwaitable(WP<CBackend> backend_, SP<IOutput> output) : IOutputAwaitable(backend_, output) {
+    frameListener = output->events.frame.registerTypedListener([](void* data) { ((CFrameAwaitable*)data)->complete(); }, this);
+}
+
+Aquamarine::CPresentAwaitable::CPresentAwaitable(WP<CBackend> backend_, SP<IOutput> output) : IOutputAwaitable(backend_, output) {
+    presentListener = output->events.present.registerTypedListener(
+        [](void* data, const IOutput::SPresentEvent& e) {
+            auto self = (CPresentAwaitable*)data;
+            if (self->done)
+                return;
+
+            self->info = SPresentInfo{
+                .presented = e.presented,
+                .when      = e.when ? *e.when : timespec{},
+                .seq       = e.seq,
+                .refresh   = e.refresh,
+                .flags     = e.flags,
+            };
+
+            self->complete();
+        },
+        this);
+}
+
+Aquamarine::CCommitAwaitable::CCommitAwaitable(SP<IOutput> output_) : output(output_) {
+    ;
+}
+
+bool Aquamarine::CCommitAwaitable::await_ready() {
+    if (auto o = output.lock())
+        result = o->commit();
+
+    return true;
+}
+
+Aquamarine::CYieldAwaitable::CYieldAwaitable(WP<CBackend> backend_) : backend(backend_) {
+    ;
+}
+
+void Aquamarine::CYieldAwaitable::await_suspend(std::coroutine_handle<> h) {
+    resumeOnLoop(backend, h);
+}
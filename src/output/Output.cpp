@@ -43,6 +43,10 @@ const Aquamarine::COutputState::SInternalState& Aquamarine::COutputState::state(
     return internalState;
 }
 
+const Aquamarine::COutputState::SInternalState& Aquamarine::COutputState::current() {
+    return currentState;
+}
+
 void Aquamarine::COutputState::addDamage(const Hyprutils::Math::CRegion& region) {
     internalState.damage.add(region);
     internalState.committed |= AQ_OUTPUT_STATE_DAMAGE;
@@ -112,6 +116,23 @@ void Aquamarine::COutputState::resetExplicitFences() {
 }
 
 void Aquamarine::COutputState::onCommit() {
+    // everything but the gamma lut and damage is small. The lut only has to be copied when it was changed,
+    // otherwise both sides already hold the same one, and damage is per-commit.
+    currentState.committed        = internalState.committed;
+    currentState.enabled          = internalState.enabled;
+    currentState.adaptiveSync     = internalState.adaptiveSync;
+    currentState.presentationMode = internalState.presentationMode;
+    currentState.lastModeSize     = internalState.lastModeSize;
+    currentState.mode             = internalState.mode;
+    currentState.customMode       = internalState.customMode;
+    currentState.drmFormat        = internalState.drmFormat;
+    currentState.buffer           = internalState.buffer;
+    currentState.explicitInFence  = internalState.explicitInFence;
+    currentState.explicitOutFence = internalState.explicitOutFence;
+
+    if (internalState.committed & AQ_OUTPUT_STATE_GAMMA_LUT)
+        currentState.gammaLut = internalState.gammaLut;
+
     internalState.committed = 0;
     internalState.damage.clear();
 }
@@ -0,0 +1,149 @@
+#include <aquamarine/backend/Backend.hpp>
+#include <aquamarine/input/Input.hpp>
+#include <aquamarine/input/Recording.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+using namespace Hyprutils::Signal;
+using namespace Hyprutils::Memory;
+#define SP CSharedPointer
+
+// Records synthetic keyboard and pointer events, then replays them through a headless backend's loop
+// and checks that each one comes back as it went in.
+
+static const uint32_t KEYS  = 64;
+static const uint32_t MOVES = 512;
+
+class CTestKeyboard : public Aquamarine::IKeyboard {
+  public:
+    virtual const std::string& getName() {
+        return name;
+    }
+
+  private:
+    std::string name = "test-keyboard";
+};
+
+class CTestPointer : public Aquamarine::IPointer {
+  public:
+    virtual const std::string& getName() {
+        return name;
+    }
+
+  private:
+    std::string name = "test-pointer";
+};
+
+static void aqLog(Aquamarine::eBackendLogLevel level, std::string msg) {
+    if (level >= Aquamarine::eBackendLogLevel::AQ_LOG_WARNING)
+        std::cout << "[AQ] " << msg << "\n";
+}
+
+static uint64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool record(const std::string& path) {
+    auto recorder = Aquamarine::CInputRecorder::create(path);
+    if (!recorder) {
+        std::cout << "[Test] Couldn't create a recording at " << path << "\n";
+        return false;
+    }
+
+    auto keyboard = makeShared<CTestKeyboard>();
+    auto pointer  = makeShared<CTestPointer>();
+    recorder->attach(SP<Aquamarine::IKeyboard>(keyboard));
+    recorder->attach(SP<Aquamarine::IPointer>(pointer));
+
+    for (uint32_t i = 0; i < KEYS; ++i) {
+        const auto NOW = nowUs();
+        keyboard->events.key.emit(Aquamarine::IKeyboard::SKeyEvent{.timeMs = (uint32_t)(NOW / 1000), .timeUs = NOW, .key = i, .pressed = i % 2 == 0});
+    }
+
+    for (uint32_t i = 0; i < MOVES; ++i) {
+        const auto NOW = nowUs();
+        pointer->events.move.emit(Aquamarine::IPointer::SMoveEvent{.timeMs = (uint32_t)(NOW / 1000), .timeUs = NOW, .delta = {(double)i, -(double)i}, .unaccel = {1, -1}});
+        pointer->events.frame.emit();
+    }
+
+    recorder->flush();
+    return recorder->recorded == KEYS + MOVES * 2;
+}
+
+int main(int argc, char** argv, char** envp) {
+    const std::string PATH = std::string{argc > 1 ? argv[1] : "inputReplay"} + ".aqir";
+
+    if (!record(PATH))
+        return 1;
+
+    Aquamarine::SBackendOptions options;
+    options.logFunction = aqLog;
+
+    std::vector<Aquamarine::SBackendImplementationOptions> implementations;
+    Aquamarine::SBackendImplementationOptions              headlessOptions;
+    headlessOptions.backendType        = Aquamarine::eBackendType::AQ_BACKEND_HEADLESS;
+    headlessOptions.backendRequestMode = Aquamarine::eBackendRequestMode::AQ_BACKEND_REQUEST_MANDATORY;
+    implementations.emplace_back(headlessOptions);
+
+    // not started: the replay only needs the loop and its timers, not an allocator
+    auto aqBackend = Aquamarine::CBackend::create(implementations, options);
+    if (!aqBackend)
+        return 1;
+
+    struct {
+        uint32_t keys = 0, moves = 0, frames = 0, mismatches = 0;
+    } counts;
+
+    SP<Aquamarine::IKeyboard>                                                 keyboard;
+    SP<Aquamarine::IPointer>                                                  pointer;
+    SP<Aquamarine::CTypedSignal<Aquamarine::IKeyboard::SKeyEvent>::CListener> keyListener;
+    SP<Aquamarine::CTypedSignal<Aquamarine::IPointer::SMoveEvent>::CListener> moveListener;
+    SP<Aquamarine::CTypedSignal<>::CListener>                                 frameListener;
+    CHyprSignalListener                                                       newKeyboardListener, newPointerListener, finishedListener;
+
+    newKeyboardListener = aqBackend->events.newKeyboard.registerListener([&](std::any data) {
+        keyboard    = std::any_cast<SP<Aquamarine::IKeyboard>>(data);
+        keyListener = keyboard->events.key.registerTypedListener(
+            [](void* data, const Aquamarine::IKeyboard::SKeyEvent& e) {
+                auto c = (decltype(counts)*)data;
+                if (e.key != c->keys || e.pressed != (c->keys % 2 == 0))
+                    c->mismatches++;
+                c->keys++;
+            },
+            &counts);
+    });
+
+    newPointerListener = aqBackend->events.newPointer.registerListener([&](std::any data) {
+        pointer      = std::any_cast<SP<Aquamarine::IPointer>>(data);
+        moveListener = pointer->events.move.registerTypedListener(
+            [](void* data, const Aquamarine::IPointer::SMoveEvent& e) {
+                auto c = (decltype(counts)*)data;
+                if (e.delta != Hyprutils::Math::Vector2D{(double)c->moves, -(double)c->moves} || e.unaccel != Hyprutils::Math::Vector2D{1, -1})
+                    c->mismatches++;
+                c->moves++;
+            },
+            &counts);
+        frameListener = pointer->events.frame.registerTypedListener([](void* data) { ((decltype(counts)*)data)->frames++; }, &counts);
+    });
+
+    auto replay = Aquamarine::CInputReplay::create(aqBackend, PATH);
+    if (!replay)
+        return 1;
+
+    finishedListener = replay->events.finished.registerListener([&](std::any data) { aqBackend->exitLoop(); });
+
+    const auto BEGIN = std::chrono::steady_clock::now();
+
+    replay->start(0);
+    aqBackend->enterLoop();
+
+    const auto ELAPSEDUS = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - BEGIN).count();
+
+    std::cout << std::format("[Test] Replayed {} events in {}µs: {} keys, {} moves, {} frames, {} mismatched\n", replay->replayed, ELAPSEDUS, counts.keys, counts.moves,
+                             counts.frames, counts.mismatches);
+
+    std::remove(PATH.c_str());
+
+    return replay->finished() && counts.keys == KEYS && counts.moves == MOVES && counts.frames == MOVES && counts.mismatches == 0 ? 0 : 1;
+}
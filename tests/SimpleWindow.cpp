@@ -90,8 +90,7 @@ int main(int argc, char** argv, char** envp) {
         return 1;
     }
 
-    // FIXME: write an event loop.
-    // aqBackend->enterLoop();
+    aqBackend->enterLoop();
 
     return 0;
 }
\ No newline at end of file